@@ -0,0 +1,143 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "AudioCommon/AudioDumper.h"
+
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "Common/FileUtil.h"
+#include "Common/MsgHandler.h"
+#include "Common/StringUtil.h"
+#include "Core/ConfigManager.h"
+
+namespace AudioCommon
+{
+static File::IOFile OpenFile(const std::string& filename)
+{
+  // Ask to delete file
+  if (File::Exists(filename))
+  {
+    if (SConfig::GetInstance().m_DumpAudioSilent ||
+        AskYesNoFmtT("Delete the existing file '{0}'?", filename))
+    {
+      File::Delete(filename);
+    }
+    else
+    {
+      // Stop and cancel dumping the audio
+      return {};
+    }
+  }
+
+  File::IOFile file(filename, "wb");
+  if (!file)
+  {
+    PanicAlertFmtT(
+        "The file {0} could not be opened for writing. Please check if it's already opened "
+        "by another program.",
+        filename);
+  }
+  return file;
+}
+
+AudioDumper::AudioDumper() = default;
+
+AudioDumper::~AudioDumper()
+{
+  Stop();
+}
+
+bool AudioDumper::Start(const std::string& filename, unsigned int sample_rate)
+{
+  if (m_thread)
+    return false;
+
+  File::IOFile file = OpenFile(filename);
+  if (!file)
+    return false;
+
+  SplitPath(filename, nullptr, &m_basename, &m_extension);
+  m_file_index = 0;
+  m_sample_rate = static_cast<int>(sample_rate);
+
+  if (StringEndsWith(filename, ".flac"))
+  {
+    m_flac_writer = std::make_unique<FlacFileWriter>();
+    m_flac_writer->Start(std::move(file), sample_rate);
+    m_flac_writer->SetSkipSilence(false);
+  }
+  else
+  {
+    m_wave_writer = std::make_unique<WaveFileWriter>();
+    m_wave_writer->Start(std::move(file), sample_rate);
+    m_wave_writer->SetSkipSilence(false);
+  }
+
+  m_thread = std::make_unique<Common::WorkQueueThread<Chunk>>(
+      [this](Chunk chunk) { WriteChunk(std::move(chunk)); });
+  return true;
+}
+
+void AudioDumper::Stop()
+{
+  // Destroying the thread writes out everything that is still queued.
+  m_thread.reset();
+
+  if (m_wave_writer)
+    m_wave_writer->Stop();
+  if (m_flac_writer)
+    m_flac_writer->Stop();
+  m_wave_writer.reset();
+  m_flac_writer.reset();
+}
+
+void AudioDumper::AddStereoSamplesBE(const short* sample_data, u32 count, int sample_rate)
+{
+  if (!m_thread)
+    return;
+
+  Chunk chunk{std::vector<short>(sample_data, sample_data + count * 2), sample_rate, {}};
+
+  if (sample_rate != m_sample_rate)
+  {
+    // Neither format can change the sample rate in the middle of a file.
+    m_file_index++;
+    File::IOFile file = OpenFile(fmt::format("{}{}{}{}", File::GetUserPath(D_DUMPAUDIO_IDX),
+                                             m_basename, m_file_index, m_extension));
+    if (!file)
+    {
+      Stop();
+      return;
+    }
+    chunk.next_file = std::move(file);
+    m_sample_rate = sample_rate;
+  }
+
+  m_thread->EmplaceItem(std::move(chunk));
+}
+
+void AudioDumper::WriteChunk(Chunk chunk)
+{
+  if (chunk.next_file)
+  {
+    if (m_flac_writer)
+    {
+      m_flac_writer->Stop();
+      m_flac_writer->Start(std::move(*chunk.next_file), chunk.sample_rate);
+    }
+    else
+    {
+      m_wave_writer->Stop();
+      m_wave_writer->Start(std::move(*chunk.next_file), chunk.sample_rate);
+    }
+  }
+
+  const u32 count = static_cast<u32>(chunk.samples.size() / 2);
+  if (m_flac_writer)
+    m_flac_writer->AddStereoSamplesBE(chunk.samples.data(), count, chunk.sample_rate);
+  else
+    m_wave_writer->AddStereoSamplesBE(chunk.samples.data(), count, chunk.sample_rate);
+}
+}  // namespace AudioCommon
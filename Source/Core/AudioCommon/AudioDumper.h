@@ -0,0 +1,61 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "AudioCommon/FlacFileWriter.h"
+#include "AudioCommon/WaveFile.h"
+#include "Common/CommonTypes.h"
+#include "Common/IOFile.h"
+#include "Common/WorkQueueThread.h"
+
+namespace AudioCommon
+{
+// Writes an audio stream to disk without blocking the thread which produces the samples.
+// Samples are copied into a queue and converted, encoded and written by a worker thread.
+// The file format is picked from the extension: .flac files are losslessly compressed,
+// anything else is written as WAV. Files are opened by the thread calling into the dumper, so
+// that any dialogs about them are shown there.
+class AudioDumper
+{
+public:
+  AudioDumper();
+  ~AudioDumper();
+
+  AudioDumper(const AudioDumper&) = delete;
+  AudioDumper& operator=(const AudioDumper&) = delete;
+  AudioDumper(AudioDumper&&) = delete;
+  AudioDumper& operator=(AudioDumper&&) = delete;
+
+  bool Start(const std::string& filename, unsigned int sample_rate);
+  // Waits until all queued samples have been written, then closes the file.
+  void Stop();
+
+  void AddStereoSamplesBE(const short* sample_data, u32 count, int sample_rate);  // big endian
+
+private:
+  struct Chunk
+  {
+    std::vector<short> samples;
+    int sample_rate;
+    // When the sample rate changes, the samples go to a new file.
+    std::optional<File::IOFile> next_file;
+  };
+
+  void WriteChunk(Chunk chunk);
+
+  std::string m_basename;
+  std::string m_extension;
+  int m_file_index = 0;
+  int m_sample_rate = 0;
+
+  std::unique_ptr<WaveFileWriter> m_wave_writer;
+  std::unique_ptr<FlacFileWriter> m_flac_writer;
+  std::unique_ptr<Common::WorkQueueThread<Chunk>> m_thread;
+};
+}  // namespace AudioCommon
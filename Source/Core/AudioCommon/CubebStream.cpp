@@ -8,16 +8,42 @@
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Common/Thread.h"
+#include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 
 // ~10 ms - needs to be at least 240 for surround
 constexpr u32 BUFFER_SAMPLES = 512;
+// ~5 ms - used in adaptive latency mode
+constexpr u32 MIN_BUFFER_SAMPLES = 256;
 
 long CubebStream::DataCallback(cubeb_stream* stream, void* user_data, const void* /*input_buffer*/,
                                void* output_buffer, long num_frames)
 {
   auto* self = static_cast<CubebStream*>(user_data);
 
+  if (self->m_latency_controller)
+  {
+    // cubeb doesn't report underruns, but a callback that comes later than the frames written by
+    // the previous one and the whole stream buffer last means that the device has played
+    // everything it had. The device period may well be longer than the stream buffer, so the
+    // previous callback's frames have to be part of this.
+    const auto now = std::chrono::steady_clock::now();
+    if (self->m_last_callback &&
+        now - *self->m_last_callback >
+            std::chrono::microseconds(
+                u64{self->m_last_callback_frames + self->m_latency_frames} * 1000000 /
+                self->m_mixer->GetSampleRate()))
+    {
+      self->m_latency_controller->OnBackendUnderrun();
+    }
+    self->m_last_callback = now;
+    self->m_last_callback_frames = static_cast<u32>(num_frames);
+
+    self->m_latency_controller->OnCallback(static_cast<u32>(num_frames),
+                                           self->m_mixer->AvailableSamples());
+    self->m_mixer->SetFIFOTargetLatency(self->m_latency_controller->GetFIFOTargetMs());
+  }
+
   if (self->m_stereo)
     self->m_mixer->Mix(static_cast<short*>(output_buffer), num_frames);
   else
@@ -58,15 +84,29 @@ bool CubebStream::Init()
     ERROR_LOG_FMT(AUDIO, "Error getting minimum latency");
   INFO_LOG_FMT(AUDIO, "Minimum latency: {} frames", minimum_latency);
 
+  m_latency_frames = std::max(BUFFER_SAMPLES, minimum_latency);
+  if (Config::Get(Config::MAIN_AUDIO_ADAPTIVE_LATENCY))
+  {
+    // cubeb can't resize the stream buffer once it is created, so use the smallest one the
+    // device supports and only let the controller manage the mixer FIFO.
+    m_latency_frames = std::max(MIN_BUFFER_SAMPLES, minimum_latency);
+    m_latency_controller = std::make_unique<AudioCommon::LatencyController>(
+        params.rate, m_latency_frames, m_latency_frames, m_latency_frames,
+        SConfig::GetInstance().iTimingVariance);
+  }
+
   return cubeb_stream_init(m_ctx.get(), &m_stream, "Dolphin Audio Output", nullptr, nullptr,
-                           nullptr, &params, std::max(BUFFER_SAMPLES, minimum_latency),
-                           DataCallback, StateCallback, this) == CUBEB_OK;
+                           nullptr, &params, m_latency_frames, DataCallback, StateCallback,
+                           this) == CUBEB_OK;
 }
 
 bool CubebStream::SetRunning(bool running)
 {
   if (running)
+  {
+    m_last_callback.reset();
     return cubeb_stream_start(m_stream) == CUBEB_OK;
+  }
   else
     return cubeb_stream_stop(m_stream) == CUBEB_OK;
 }
@@ -82,3 +122,12 @@ void CubebStream::SetVolume(int volume)
 {
   cubeb_stream_set_volume(m_stream, volume / 100.0f);
 }
+
+u32 CubebStream::GetLatencyMs() const
+{
+  if (m_latency_controller)
+    return m_latency_controller->GetLatencyMs();
+
+  const u32 queued = m_mixer->AvailableSamples();
+  return (m_latency_frames + queued) * 1000 / m_mixer->GetSampleRate();
+}
@@ -3,10 +3,13 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstddef>
 #include <memory>
+#include <optional>
 #include <vector>
 
+#include "AudioCommon/LatencyController.h"
 #include "AudioCommon/SoundStream.h"
 
 #include <cubeb/cubeb.h>
@@ -18,11 +21,17 @@ public:
   bool Init() override;
   bool SetRunning(bool running) override;
   void SetVolume(int) override;
+  u32 GetLatencyMs() const override;
 
 private:
   bool m_stereo = false;
   std::shared_ptr<cubeb> m_ctx;
   cubeb_stream* m_stream = nullptr;
+  u32 m_latency_frames = 0;
+  std::unique_ptr<AudioCommon::LatencyController> m_latency_controller;
+  // Only used from the audio thread while the stream is running.
+  std::optional<std::chrono::steady_clock::time_point> m_last_callback;
+  u32 m_last_callback_frames = 0;
 
   std::vector<short> m_short_buffer;
   std::vector<float> m_floatstereo_buffer;
@@ -0,0 +1,527 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "AudioCommon/FlacFileWriter.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "AudioCommon/WaveFile.h"
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "Common/Logging/Log.h"
+#include "Common/MsgHandler.h"
+#include "Common/StringUtil.h"
+#include "Core/ConfigManager.h"
+
+namespace
+{
+constexpr u32 BITS_PER_SAMPLE = 16;
+constexpr u32 MAX_FIXED_ORDER = 4;
+constexpr u32 MAX_PARTITION_ORDER = 8;
+constexpr u32 MAX_RICE_PARAMETER = 14;  // 15 is the escape code
+
+// Channel assignments from the frame header.
+enum class ChannelAssignment : u32
+{
+  Independent = 0x1,
+  LeftSide = 0x8,
+  SideRight = 0x9,
+  MidSide = 0xA,
+};
+
+class BitWriter
+{
+public:
+  explicit BitWriter(std::vector<u8>& buffer) : m_buffer(buffer) { m_buffer.clear(); }
+
+  void Write(u32 value, u32 bits)
+  {
+    m_accumulator = (m_accumulator << bits) | (value & ((u64{1} << bits) - 1));
+    m_bits += bits;
+    while (m_bits >= 8)
+    {
+      m_bits -= 8;
+      m_buffer.push_back(static_cast<u8>(m_accumulator >> m_bits));
+    }
+  }
+
+  void WriteSigned(s32 value, u32 bits) { Write(static_cast<u32>(value), bits); }
+
+  // Writes value zeros followed by a one.
+  void WriteUnary(u32 value)
+  {
+    for (; value >= 32; value -= 32)
+      Write(0, 32);
+    Write(1, value + 1);
+  }
+
+  // FLAC's variant of UTF-8, which allows up to 36 bits. Frame numbers only need 31.
+  void WriteUTF8(u32 value)
+  {
+    if (value < 0x80)
+    {
+      Write(value, 8);
+      return;
+    }
+
+    u32 bytes = 2;
+    while (bytes < 6 && value >= (1u << (5 * bytes + 1)))
+      ++bytes;
+
+    Write(((0xFF << (8 - bytes)) & 0xFF) | (value >> (6 * (bytes - 1))), 8);
+    for (u32 i = bytes - 1; i > 0; --i)
+      Write(0x80 | ((value >> (6 * (i - 1))) & 0x3F), 8);
+  }
+
+  void AlignToByte()
+  {
+    if (m_bits != 0)
+      Write(0, 8 - m_bits);
+  }
+
+private:
+  std::vector<u8>& m_buffer;
+  u64 m_accumulator = 0;
+  u32 m_bits = 0;
+};
+
+u8 CRC8(const u8* data, size_t size)
+{
+  u8 crc = 0;
+  for (size_t i = 0; i < size; ++i)
+  {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; ++bit)
+      crc = (crc & 0x80) ? static_cast<u8>((crc << 1) ^ 0x07) : static_cast<u8>(crc << 1);
+  }
+  return crc;
+}
+
+u16 CRC16(const u8* data, size_t size)
+{
+  u16 crc = 0;
+  for (size_t i = 0; i < size; ++i)
+  {
+    crc ^= static_cast<u16>(data[i] << 8);
+    for (int bit = 0; bit < 8; ++bit)
+      crc = (crc & 0x8000) ? static_cast<u16>((crc << 1) ^ 0x8005) : static_cast<u16>(crc << 1);
+  }
+  return crc;
+}
+
+// Computes the residual of one of the fixed polynomial predictors, folded to unsigned values
+// for Rice coding. The output has (samples.size() - order) values.
+void ComputeFixedResidual(const std::vector<s32>& samples, u32 order, std::vector<u32>* folded)
+{
+  folded->resize(samples.size() - order);
+  for (size_t i = order; i < samples.size(); ++i)
+  {
+    const s32* x = &samples[i];
+    s32 residual;
+    switch (order)
+    {
+    case 0:
+      residual = x[0];
+      break;
+    case 1:
+      residual = x[0] - x[-1];
+      break;
+    case 2:
+      residual = x[0] - 2 * x[-1] + x[-2];
+      break;
+    case 3:
+      residual = x[0] - 3 * x[-1] + 3 * x[-2] - x[-3];
+      break;
+    default:
+      residual = x[0] - 4 * x[-1] + 6 * x[-2] - 4 * x[-3] + x[-4];
+      break;
+    }
+    (*folded)[i - order] = (static_cast<u32>(residual) << 1) ^ static_cast<u32>(residual >> 31);
+  }
+}
+
+struct ResidualCoding
+{
+  u32 partition_order = 0;
+  std::array<u8, 1 << MAX_PARTITION_ORDER> parameters{};
+  u64 bits = std::numeric_limits<u64>::max();
+};
+
+u64 RiceBits(const u32* folded, size_t count, u32 parameter)
+{
+  u64 bits = static_cast<u64>(count) * (parameter + 1);
+  for (size_t i = 0; i < count; ++i)
+    bits += folded[i] >> parameter;
+  return bits;
+}
+
+// Picks the partition order and Rice parameters which minimize the size of the residual.
+ResidualCoding ChooseResidualCoding(const std::vector<u32>& folded, u32 block_size, u32 order)
+{
+  ResidualCoding best;
+  for (u32 partition_order = 0; partition_order <= MAX_PARTITION_ORDER; ++partition_order)
+  {
+    const u32 partition_size = block_size >> partition_order;
+    if (block_size % (1 << partition_order) != 0 || partition_size <= order)
+      break;
+
+    ResidualCoding coding;
+    coding.partition_order = partition_order;
+    coding.bits = 2 + 4;  // Coding method and partition order
+
+    const u32* data = folded.data();
+    for (u32 partition = 0; partition < (1u << partition_order); ++partition)
+    {
+      const size_t count = partition == 0 ? partition_size - order : partition_size;
+
+      u64 sum = 0;
+      for (size_t i = 0; i < count; ++i)
+        sum += data[i];
+
+      // The optimal parameter is close to log2 of the mean, so only try its neighbours.
+      u32 estimate = 0;
+      while (estimate < MAX_RICE_PARAMETER && (u64{count} << (estimate + 1)) <= sum)
+        ++estimate;
+
+      u64 best_bits = std::numeric_limits<u64>::max();
+      for (u32 parameter = estimate > 0 ? estimate - 1 : 0;
+           parameter <= std::min(estimate + 1, MAX_RICE_PARAMETER); ++parameter)
+      {
+        const u64 bits = RiceBits(data, count, parameter);
+        if (bits < best_bits)
+        {
+          best_bits = bits;
+          coding.parameters[partition] = static_cast<u8>(parameter);
+        }
+      }
+
+      coding.bits += 4 + best_bits;
+      data += count;
+    }
+
+    if (coding.bits < best.bits)
+      best = coding;
+  }
+  return best;
+}
+
+enum class SubframeType
+{
+  Constant,
+  Verbatim,
+  Fixed,
+};
+
+struct SubframePlan
+{
+  SubframeType type = SubframeType::Verbatim;
+  u32 order = 0;
+  ResidualCoding coding;
+  u64 bits = 0;
+};
+
+SubframePlan PlanSubframe(const std::vector<s32>& samples, u32 bits_per_sample,
+                          std::vector<u32>* folded)
+{
+  const u32 block_size = static_cast<u32>(samples.size());
+  constexpr u32 header_bits = 8;
+
+  SubframePlan plan;
+  if (std::all_of(samples.begin(), samples.end(), [&](s32 x) { return x == samples[0]; }))
+  {
+    plan.type = SubframeType::Constant;
+    plan.bits = header_bits + bits_per_sample;
+    return plan;
+  }
+
+  plan.type = SubframeType::Verbatim;
+  plan.bits = header_bits + u64{block_size} * bits_per_sample;
+
+  for (u32 order = 0; order <= MAX_FIXED_ORDER && order < block_size; ++order)
+  {
+    ComputeFixedResidual(samples, order, folded);
+    ResidualCoding coding = ChooseResidualCoding(*folded, block_size, order);
+    if (coding.bits == std::numeric_limits<u64>::max())
+      continue;
+
+    const u64 bits = header_bits + order * bits_per_sample + coding.bits;
+    if (bits < plan.bits)
+    {
+      plan.type = SubframeType::Fixed;
+      plan.order = order;
+      plan.coding = coding;
+      plan.bits = bits;
+    }
+  }
+  return plan;
+}
+
+void WriteSubframe(BitWriter& writer, const std::vector<s32>& samples, u32 bits_per_sample,
+                   const SubframePlan& plan, std::vector<u32>* folded)
+{
+  switch (plan.type)
+  {
+  case SubframeType::Constant:
+    writer.Write(0x00, 8);
+    writer.WriteSigned(samples[0], bits_per_sample);
+    break;
+
+  case SubframeType::Verbatim:
+    writer.Write(0x02, 8);
+    for (s32 sample : samples)
+      writer.WriteSigned(sample, bits_per_sample);
+    break;
+
+  case SubframeType::Fixed:
+  {
+    writer.Write(0x10 | (plan.order << 1), 8);
+    for (u32 i = 0; i < plan.order; ++i)
+      writer.WriteSigned(samples[i], bits_per_sample);
+
+    ComputeFixedResidual(samples, plan.order, folded);
+    const u32 block_size = static_cast<u32>(samples.size());
+    const u32 partition_size = block_size >> plan.coding.partition_order;
+
+    writer.Write(0, 2);  // Rice coding with 4-bit parameters
+    writer.Write(plan.coding.partition_order, 4);
+    const u32* data = folded->data();
+    for (u32 partition = 0; partition < (1u << plan.coding.partition_order); ++partition)
+    {
+      const size_t count = partition == 0 ? partition_size - plan.order : partition_size;
+      const u32 parameter = plan.coding.parameters[partition];
+      writer.Write(parameter, 4);
+      for (size_t i = 0; i < count; ++i)
+      {
+        writer.WriteUnary(data[i] >> parameter);
+        writer.Write(data[i], parameter);
+      }
+      data += count;
+    }
+    break;
+  }
+  }
+}
+}  // namespace
+
+FlacFileWriter::FlacFileWriter()
+{
+}
+
+FlacFileWriter::~FlacFileWriter()
+{
+  Stop();
+}
+
+bool FlacFileWriter::Start(const std::string& filename, unsigned int HLESampleRate)
+{
+  // Ask to delete file
+  if (File::Exists(filename))
+  {
+    if (SConfig::GetInstance().m_DumpAudioSilent ||
+        AskYesNoFmtT("Delete the existing file '{0}'?", filename))
+    {
+      File::Delete(filename);
+    }
+    else
+    {
+      // Stop and cancel dumping the audio
+      return false;
+    }
+  }
+
+  // Check if the file is already open
+  if (file)
+  {
+    PanicAlertFmtT("The file {0} was already open, the file header will not be written.", filename);
+    return false;
+  }
+
+  File::IOFile new_file(filename, "wb");
+  if (!new_file)
+  {
+    PanicAlertFmtT(
+        "The file {0} could not be opened for writing. Please check if it's already opened "
+        "by another program.",
+        filename);
+    return false;
+  }
+
+  if (basename.empty())
+    SplitPath(filename, nullptr, &basename, nullptr);
+
+  Start(std::move(new_file), HLESampleRate);
+  return true;
+}
+
+void FlacFileWriter::Start(File::IOFile new_file, unsigned int HLESampleRate)
+{
+  file = std::move(new_file);
+  total_samples = 0;
+  frame_number = 0;
+  block_fill = 0;
+  current_sample_rate = HLESampleRate;
+
+  // The total number of samples is filled in when stopping.
+  WriteStreamInfo();
+}
+
+void FlacFileWriter::Stop()
+{
+  if (!file)
+    return;
+
+  if (block_fill != 0)
+    EncodeBlock();
+
+  file.Seek(0, SEEK_SET);
+  WriteStreamInfo();
+
+  file.Close();
+}
+
+void FlacFileWriter::WriteStreamInfo()
+{
+  std::vector<u8> header;
+  BitWriter writer(header);
+
+  writer.Write(0x664C6143, 32);  // "fLaC"
+
+  // Metadata block header: last block, STREAMINFO, 34 bytes.
+  writer.Write(1, 1);
+  writer.Write(0, 7);
+  writer.Write(34, 24);
+
+  writer.Write(BLOCK_SIZE, 16);  // Minimum block size
+  writer.Write(BLOCK_SIZE, 16);  // Maximum block size
+  writer.Write(0, 24);           // Minimum frame size (unknown)
+  writer.Write(0, 24);           // Maximum frame size (unknown)
+  writer.Write(current_sample_rate, 20);
+  writer.Write(2 - 1, 3);
+  writer.Write(BITS_PER_SAMPLE - 1, 5);
+  writer.Write(static_cast<u32>(total_samples >> 32), 4);
+  writer.Write(static_cast<u32>(total_samples), 32);
+  for (int i = 0; i < 4; ++i)
+    writer.Write(0, 32);  // MD5 of the audio data (not computed)
+
+  file.WriteBytes(header.data(), header.size());
+}
+
+void FlacFileWriter::EncodeBlock()
+{
+  const u32 block_size = block_fill;
+
+  std::vector<s32> left(block_size), right(block_size), mid(block_size), side(block_size);
+  for (u32 i = 0; i < block_size; ++i)
+  {
+    left[i] = block[2 * i];
+    right[i] = block[2 * i + 1];
+    mid[i] = (left[i] + right[i]) >> 1;
+    side[i] = left[i] - right[i];
+  }
+
+  // Pick the stereo decorrelation which gives the smallest frame.
+  std::vector<u32> folded;
+  const SubframePlan left_plan = PlanSubframe(left, BITS_PER_SAMPLE, &folded);
+  const SubframePlan right_plan = PlanSubframe(right, BITS_PER_SAMPLE, &folded);
+  const SubframePlan mid_plan = PlanSubframe(mid, BITS_PER_SAMPLE, &folded);
+  const SubframePlan side_plan = PlanSubframe(side, BITS_PER_SAMPLE + 1, &folded);
+
+  struct Choice
+  {
+    ChannelAssignment assignment;
+    const std::vector<s32>* channels[2];
+    u32 bits_per_sample[2];
+    const SubframePlan* plans[2];
+  };
+  const std::array<Choice, 4> choices{{
+      {ChannelAssignment::Independent,
+       {&left, &right},
+       {BITS_PER_SAMPLE, BITS_PER_SAMPLE},
+       {&left_plan, &right_plan}},
+      {ChannelAssignment::LeftSide,
+       {&left, &side},
+       {BITS_PER_SAMPLE, BITS_PER_SAMPLE + 1},
+       {&left_plan, &side_plan}},
+      {ChannelAssignment::SideRight,
+       {&side, &right},
+       {BITS_PER_SAMPLE + 1, BITS_PER_SAMPLE},
+       {&side_plan, &right_plan}},
+      {ChannelAssignment::MidSide,
+       {&mid, &side},
+       {BITS_PER_SAMPLE, BITS_PER_SAMPLE + 1},
+       {&mid_plan, &side_plan}},
+  }};
+  const Choice& choice = *std::min_element(
+      choices.begin(), choices.end(), [](const Choice& a, const Choice& b) {
+        return a.plans[0]->bits + a.plans[1]->bits < b.plans[0]->bits + b.plans[1]->bits;
+      });
+
+  BitWriter writer(frame_buffer);
+
+  // Frame header
+  writer.Write(0xFFF8, 16);  // Sync code, fixed block size stream
+  writer.Write(0x7, 4);      // Block size stored at the end of the header
+  writer.Write(0x0, 4);      // Sample rate taken from STREAMINFO
+  writer.Write(static_cast<u32>(choice.assignment), 4);
+  writer.Write(0x4, 3);  // 16 bits per sample
+  writer.Write(0, 1);
+  writer.WriteUTF8(frame_number);
+  writer.Write(block_size - 1, 16);
+  writer.Write(CRC8(frame_buffer.data(), frame_buffer.size()), 8);
+
+  for (int channel = 0; channel < 2; ++channel)
+  {
+    WriteSubframe(writer, *choice.channels[channel], choice.bits_per_sample[channel],
+                  *choice.plans[channel], &folded);
+  }
+
+  writer.AlignToByte();
+  writer.Write(CRC16(frame_buffer.data(), frame_buffer.size()), 16);
+
+  file.WriteBytes(frame_buffer.data(), frame_buffer.size());
+
+  total_samples += block_size;
+  ++frame_number;
+  block_fill = 0;
+}
+
+void FlacFileWriter::AddStereoSamplesBE(const short* sample_data, u32 count, int sample_rate)
+{
+  if (!file)
+    ERROR_LOG_FMT(AUDIO, "FlacFileWriter - file not open.");
+
+  if (skip_silence)
+  {
+    if (std::all_of(sample_data, sample_data + count * 2, [](short x) { return x == 0; }))
+      return;
+  }
+
+  if (sample_rate != current_sample_rate)
+  {
+    Stop();
+    file_index++;
+    std::ostringstream filename;
+    filename << File::GetUserPath(D_DUMPAUDIO_IDX) << basename << file_index << ".flac";
+    Start(filename.str(), sample_rate);
+    current_sample_rate = sample_rate;
+  }
+
+  while (count > 0)
+  {
+    const u32 chunk = std::min(count, BLOCK_SIZE - block_fill);
+    AudioCommon::ConvertStereoSamplesBE(&block[block_fill * 2], sample_data, chunk);
+    block_fill += chunk;
+    sample_data += chunk * 2;
+    count -= chunk;
+
+    if (block_fill == BLOCK_SIZE)
+      EncodeBlock();
+  }
+}
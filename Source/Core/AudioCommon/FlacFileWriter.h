@@ -0,0 +1,59 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// ---------------------------------------------------------------------------------
+// Class: FlacFileWriter
+// Description: Writes 16-bit stereo audio streams to a FLAC file. Has the same
+// interface as WaveFileWriter, but the output is losslessly compressed.
+// Samples are buffered and encoded one block at a time, so this is meant to be
+// used from a thread which isn't time critical (see AudioDumper).
+// ---------------------------------------------------------------------------------
+
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/IOFile.h"
+
+class FlacFileWriter
+{
+public:
+  FlacFileWriter();
+  ~FlacFileWriter();
+
+  FlacFileWriter(const FlacFileWriter&) = delete;
+  FlacFileWriter& operator=(const FlacFileWriter&) = delete;
+  FlacFileWriter(FlacFileWriter&&) = delete;
+  FlacFileWriter& operator=(FlacFileWriter&&) = delete;
+
+  bool Start(const std::string& filename, unsigned int HLESampleRate);
+  // Writes to a file which has already been opened. Unlike the above, this never shows any
+  // dialogs, so it can be used from any thread.
+  void Start(File::IOFile new_file, unsigned int HLESampleRate);
+  void Stop();
+
+  void SetSkipSilence(bool skip) { skip_silence = skip; }
+  void AddStereoSamplesBE(const short* sample_data, u32 count, int sample_rate);  // big endian
+  u64 GetTotalSamples() const { return total_samples; }
+
+  static constexpr u32 BLOCK_SIZE = 4096;
+
+private:
+  void WriteStreamInfo();
+  void EncodeBlock();
+
+  File::IOFile file;
+  bool skip_silence = false;
+  u64 total_samples = 0;
+  u32 frame_number = 0;
+  // Native endian samples of the current block, left channel first.
+  std::array<short, BLOCK_SIZE * 2> block{};
+  u32 block_fill = 0;
+  std::vector<u8> frame_buffer;
+  std::string basename;
+  int current_sample_rate;
+  int file_index = 0;
+};
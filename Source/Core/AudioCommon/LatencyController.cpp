@@ -0,0 +1,144 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "AudioCommon/LatencyController.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+#include "Common/Logging/Log.h"
+
+namespace AudioCommon
+{
+// Length of a measurement window. Adjustments are only made at the end of a window.
+constexpr u32 WINDOW_MS = 500;
+// Number of consecutive windows without problems before a buffer is shrunk.
+constexpr u32 STABLE_WINDOWS = 4;
+
+constexpr u32 BACKEND_SHRINK_MS = 1;
+constexpr u32 MIN_FIFO_MS = 2;
+constexpr u32 MAX_FIFO_MS = 200;
+constexpr u32 FIFO_GROW_MS = 4;
+constexpr u32 FIFO_SHRINK_MS = 1;
+// How much audio must be left in the FIFO after a callback for it to be considered safe.
+constexpr u32 FIFO_MARGIN_MS = 2;
+
+LatencyController::LatencyController(u32 sample_rate, u32 min_backend_frames,
+                                     u32 max_backend_frames, u32 initial_backend_frames,
+                                     u32 initial_fifo_ms)
+    : m_sample_rate(sample_rate), m_min_backend_frames(min_backend_frames),
+      m_max_backend_frames(std::max(min_backend_frames, max_backend_frames)),
+      m_backend_frames(std::clamp(initial_backend_frames, min_backend_frames,
+                                  std::max(min_backend_frames, max_backend_frames))),
+      m_fifo_target_ms(std::clamp(initial_fifo_ms, MIN_FIFO_MS, MAX_FIFO_MS))
+{
+}
+
+void LatencyController::OnCallback(u32 requested_frames, u32 queued_frames)
+{
+  const auto now = std::chrono::steady_clock::now();
+  if (m_last_callback)
+  {
+    // The backend should ask for data at the rate it consumes it. Any deviation from that has to
+    // be absorbed by the backend buffer.
+    const auto interval =
+        std::chrono::duration_cast<std::chrono::microseconds>(now - *m_last_callback).count();
+    const s64 expected = static_cast<s64>(requested_frames) * 1000000 / m_sample_rate;
+    const u32 jitter = static_cast<u32>(std::min<s64>(std::abs(interval - expected), 1000000));
+    m_window_max_jitter_us = std::max(m_window_max_jitter_us, jitter);
+  }
+  m_last_callback = now;
+
+  if (queued_frames < requested_frames)
+    m_window_fifo_starved = true;
+
+  m_window_max_requested = std::max(m_window_max_requested, requested_frames);
+  m_window_min_queued = std::min(m_window_min_queued, queued_frames);
+  m_window_queued_sum += queued_frames;
+  ++m_window_callbacks;
+
+  m_window_frames += requested_frames;
+  if (m_window_frames >= m_sample_rate * WINDOW_MS / 1000)
+    EndWindow();
+}
+
+void LatencyController::OnBackendUnderrun()
+{
+  ++m_window_backend_underruns;
+}
+
+void LatencyController::EndWindow()
+{
+  const u32 frames_per_ms = std::max(m_sample_rate / 1000, 1u);
+
+  u32 backend_frames = m_backend_frames.load(std::memory_order_relaxed);
+  // When the backend buffer can't grow any further, the mixer FIFO has to make up for it.
+  if (m_window_backend_underruns != 0 && backend_frames == m_max_backend_frames)
+    m_window_fifo_starved = true;
+
+  if (m_window_backend_underruns != 0)
+  {
+    // Grow quickly, shrink slowly.
+    backend_frames = std::min(m_max_backend_frames, backend_frames + backend_frames / 4 + 1);
+    m_backend_stable_windows = 0;
+  }
+  else if (++m_backend_stable_windows >= STABLE_WINDOWS)
+  {
+    // The buffer must be able to cover one callback plus twice the worst jitter we have seen.
+    const u64 required =
+        m_window_max_requested + u64{2} * m_window_max_jitter_us * m_sample_rate / 1000000;
+    const u32 floor = static_cast<u32>(
+        std::clamp<u64>(required, m_min_backend_frames, m_max_backend_frames));
+    if (backend_frames > floor)
+    {
+      const u32 step = std::min(backend_frames, BACKEND_SHRINK_MS * frames_per_ms);
+      backend_frames = std::max(floor, backend_frames - step);
+    }
+    m_backend_stable_windows = 0;
+  }
+
+  u32 fifo_ms = m_fifo_target_ms.load(std::memory_order_relaxed);
+  if (m_window_fifo_starved)
+  {
+    fifo_ms = std::min(MAX_FIFO_MS, fifo_ms + FIFO_GROW_MS);
+    m_fifo_stable_windows = 0;
+  }
+  else if (++m_fifo_stable_windows >= STABLE_WINDOWS)
+  {
+    const u32 margin_ms = m_window_min_queued > m_window_max_requested ?
+                              (m_window_min_queued - m_window_max_requested) / frames_per_ms :
+                              0;
+    if (margin_ms > FIFO_MARGIN_MS)
+      fifo_ms = std::max(MIN_FIFO_MS, fifo_ms - FIFO_SHRINK_MS);
+    m_fifo_stable_windows = 0;
+  }
+
+  const u64 average_queued = m_window_queued_sum / std::max(m_window_callbacks, 1u);
+  const u32 latency_ms = static_cast<u32>((backend_frames + average_queued) / frames_per_ms);
+  if (backend_frames != m_backend_frames.load(std::memory_order_relaxed) ||
+      fifo_ms != m_fifo_target_ms.load(std::memory_order_relaxed))
+  {
+    INFO_LOG_FMT(AUDIO,
+                 "Adaptive latency: backend {} frames, mixer FIFO target {} ms, latency {} ms",
+                 backend_frames, fifo_ms, latency_ms);
+  }
+  else
+  {
+    DEBUG_LOG_FMT(AUDIO, "Adaptive latency: {} ms, {} backend underruns", latency_ms,
+                  m_window_backend_underruns);
+  }
+  m_backend_frames.store(backend_frames, std::memory_order_relaxed);
+  m_fifo_target_ms.store(fifo_ms, std::memory_order_relaxed);
+  m_latency_ms.store(latency_ms, std::memory_order_relaxed);
+
+  m_window_frames = 0;
+  m_window_callbacks = 0;
+  m_window_max_requested = 0;
+  m_window_max_jitter_us = 0;
+  m_window_min_queued = std::numeric_limits<u32>::max();
+  m_window_queued_sum = 0;
+  m_window_backend_underruns = 0;
+  m_window_fifo_starved = false;
+}
+}  // namespace AudioCommon
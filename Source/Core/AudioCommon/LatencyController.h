@@ -0,0 +1,69 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <optional>
+
+#include "Common/CommonTypes.h"
+
+namespace AudioCommon
+{
+// Keeps the amount of buffered audio as low as the system allows without underruns.
+//
+// It is fed from the audio callback and adjusts two things at runtime:
+//  * the backend buffer size, based on the callback jitter and backend underruns;
+//  * the mixer FIFO target fill level (which drives the FIFO resampling ratio), based on how
+//    close the FIFO comes to running dry.
+// Backends which can't resize their buffer while running use a fixed range for the first one, and
+// their underruns grow the mixer FIFO target instead.
+class LatencyController
+{
+public:
+  LatencyController(u32 sample_rate, u32 min_backend_frames, u32 max_backend_frames,
+                    u32 initial_backend_frames, u32 initial_fifo_ms);
+
+  // Called from the audio thread before mixing, with the number of frames the backend asks for
+  // and the number of frames currently queued in the mixer.
+  void OnCallback(u32 requested_frames, u32 queued_frames);
+  // Called from the audio thread when the backend ran out of data.
+  void OnBackendUnderrun();
+
+  u32 GetBackendFrames() const { return m_backend_frames.load(std::memory_order_relaxed); }
+  u32 GetFIFOTargetMs() const { return m_fifo_target_ms.load(std::memory_order_relaxed); }
+
+  // Returns the latency achieved over the last measurement window: the backend buffer plus the
+  // average amount of audio queued in the mixer. Can be called from any thread.
+  u32 GetLatencyMs() const { return m_latency_ms.load(std::memory_order_relaxed); }
+
+private:
+  void EndWindow();
+
+  const u32 m_sample_rate;
+  const u32 m_min_backend_frames;
+  const u32 m_max_backend_frames;
+
+  std::atomic<u32> m_backend_frames;
+  std::atomic<u32> m_fifo_target_ms;
+  std::atomic<u32> m_latency_ms{0};
+
+  std::optional<std::chrono::steady_clock::time_point> m_last_callback;
+
+  // Statistics for the current measurement window.
+  u32 m_window_frames = 0;
+  u32 m_window_callbacks = 0;
+  u32 m_window_max_requested = 0;
+  u32 m_window_max_jitter_us = 0;
+  u32 m_window_min_queued = std::numeric_limits<u32>::max();
+  u64 m_window_queued_sum = 0;
+  u32 m_window_backend_underruns = 0;
+  bool m_window_fifo_starved = false;
+
+  // Number of consecutive windows without problems, used to shrink the buffers slowly.
+  u32 m_backend_stable_windows = 0;
+  u32 m_fifo_stable_windows = 0;
+};
+}  // namespace AudioCommon
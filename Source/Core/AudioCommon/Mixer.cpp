@@ -5,9 +5,14 @@
 #include "AudioCommon/Enums.h"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstring>
 
+#ifdef _M_X86
+#include <emmintrin.h>
+#endif
+
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
@@ -31,7 +36,9 @@ static u32 DPL2QualityToFrameBlockSize(AudioCommon::DPL2Quality quality)
 }
 
 Mixer::Mixer(unsigned int BackendSampleRate)
-    : m_sampleRate(BackendSampleRate), m_stretcher(BackendSampleRate),
+    : m_sampleRate(BackendSampleRate),
+      m_sinc_resampling(Config::Get(Config::MAIN_AUDIO_SINC_RESAMPLING)),
+      m_stretcher(BackendSampleRate),
       m_surround_decoder(BackendSampleRate,
                          DPL2QualityToFrameBlockSize(Config::Get(Config::MAIN_DPL2_QUALITY)))
 {
@@ -51,6 +58,216 @@ void Mixer::DoState(PointerWrap& p)
     mixer.DoState(p);
 }
 
+namespace
+{
+// Output frames resampled at once by MixerFifo::Mix.
+constexpr u32 RESAMPLE_BLOCK_SIZE = 64;
+
+// Number of input frames used for each output frame by the windowed-sinc resampler, centered
+// around the interpolation point.
+constexpr u32 SINC_TAPS = 8;
+constexpr u32 SINC_HISTORY = SINC_TAPS / 2 - 1;
+constexpr u32 SINC_PHASE_BITS = 8;
+
+// Windowed-sinc filter coefficients for each fractional position between two input frames, in
+// 2.14 fixed point. Every coefficient is stored twice so that it can be applied to interleaved
+// stereo frames directly.
+using SincCoefficients = std::array<s16, SINC_TAPS * 2>;
+
+std::array<SincCoefficients, 1 << SINC_PHASE_BITS> BuildSincTable()
+{
+  // Cut off slightly below the input Nyquist frequency to leave room for the transition band.
+  constexpr double CUTOFF = 0.9;
+  constexpr double PI = 3.14159265358979323846;
+  constexpr int HALF_TAPS = SINC_TAPS / 2;
+
+  std::array<SincCoefficients, 1 << SINC_PHASE_BITS> table;
+  for (size_t phase = 0; phase < table.size(); ++phase)
+  {
+    const double frac = static_cast<double>(phase) / table.size();
+
+    std::array<double, SINC_TAPS> taps;
+    double sum = 0.0;
+    for (int i = 0; i < static_cast<int>(taps.size()); ++i)
+    {
+      // Distance between the input frame and the interpolation point.
+      const double x = (i - static_cast<int>(SINC_HISTORY)) - frac;
+      const double sinc = x == 0.0 ? 1.0 : std::sin(PI * CUTOFF * x) / (PI * CUTOFF * x);
+      // Blackman window spanning all taps.
+      const double w = 0.42 + 0.5 * std::cos(PI * x / HALF_TAPS) +
+                       0.08 * std::cos(2.0 * PI * x / HALF_TAPS);
+      taps[i] = sinc * w;
+      sum += taps[i];
+    }
+
+    // Normalize each phase so that a constant signal passes through unchanged.
+    s32 total = 0;
+    for (size_t i = 0; i < taps.size(); ++i)
+    {
+      const s16 coef = static_cast<s16>(std::lround(taps[i] / sum * (1 << 14)));
+      table[phase][2 * i] = table[phase][2 * i + 1] = coef;
+      total += coef;
+    }
+    table[phase][2 * SINC_HISTORY] += (1 << 14) - total;
+    table[phase][2 * SINC_HISTORY + 1] += (1 << 14) - total;
+  }
+  return table;
+}
+
+const auto s_sinc_table = BuildSincTable();
+
+#ifdef _M_X86
+// SSE2 lacks a 32-bit low multiply.
+__m128i MultiplyLow32(__m128i a, __m128i b)
+{
+  const __m128i even = _mm_mul_epu32(a, b);
+  const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+  return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                            _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+#endif
+
+// Applies the volume to resampled frames and adds them to the output.
+void MixResampledFrames(short* samples, const s32* frames, u32 num_frames, s32 lvolume,
+                        s32 rvolume)
+{
+  u32 i = 0;
+#ifdef _M_X86
+  const __m128i volume = _mm_setr_epi32(rvolume, lvolume, rvolume, lvolume);
+  const __m128i min_sample = _mm_set1_epi16(-32767);
+  for (; i + 4 <= num_frames * 2; i += 4)
+  {
+    const __m128i resampled = _mm_loadu_si128(reinterpret_cast<const __m128i*>(frames + i));
+    const __m128i scaled = _mm_srai_epi32(MultiplyLow32(resampled, volume), 8);
+    const __m128i current = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(samples + i));
+    const __m128i extended = _mm_srai_epi32(_mm_unpacklo_epi16(current, current), 16);
+    const __m128i sum = _mm_add_epi32(scaled, extended);
+    const __m128i clamped = _mm_max_epi16(_mm_packs_epi32(sum, sum), min_sample);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(samples + i), clamped);
+  }
+#endif
+  for (; i < num_frames * 2; i += 2)
+  {
+    const int sampleR = ((frames[i] * rvolume) >> 8) + samples[i];
+    samples[i] = std::clamp(sampleR, -32767, 32767);
+    const int sampleL = ((frames[i + 1] * lvolume) >> 8) + samples[i + 1];
+    samples[i + 1] = std::clamp(sampleL, -32767, 32767);
+  }
+}
+}  // namespace
+
+short Mixer::MixerFifo::ReadBuffer(u32 index) const
+{
+  return m_little_endian ? m_buffer[index & INDEX_MASK] :
+                           Common::swap16(m_buffer[index & INDEX_MASK]);
+}
+
+// Linearly interpolates up to max_frames frames. Each output frame is stored right channel first,
+// matching the output buffer.
+u32 Mixer::MixerFifo::ResampleLinear(s32* output, u32 max_frames, u32& indexR, u32 indexW,
+                                     u32 ratio)
+{
+  alignas(16) std::array<s32, RESAMPLE_BLOCK_SIZE * 2> current;
+  alignas(16) std::array<s32, RESAMPLE_BLOCK_SIZE * 2> next;
+  alignas(16) std::array<s32, RESAMPLE_BLOCK_SIZE * 2> frac;
+
+  // Walking the read position is inherently serial, so gather the inputs first.
+  u32 num_frames = 0;
+  for (; num_frames < max_frames && ((indexW - indexR) & INDEX_MASK) > 2; ++num_frames)
+  {
+    current[2 * num_frames] = ReadBuffer(indexR + 1);
+    current[2 * num_frames + 1] = ReadBuffer(indexR);
+    next[2 * num_frames] = ReadBuffer(indexR + 3);
+    next[2 * num_frames + 1] = ReadBuffer(indexR + 2);
+    frac[2 * num_frames] = frac[2 * num_frames + 1] = static_cast<u16>(m_frac);
+
+    m_frac += ratio;
+    indexR += 2 * (u16)(m_frac >> 16);
+    m_frac &= 0xffff;
+  }
+
+  u32 i = 0;
+#ifdef _M_X86
+  for (; i + 4 <= num_frames * 2; i += 4)
+  {
+    const __m128i c = _mm_load_si128(reinterpret_cast<const __m128i*>(&current[i]));
+    const __m128i n = _mm_load_si128(reinterpret_cast<const __m128i*>(&next[i]));
+    const __m128i f = _mm_load_si128(reinterpret_cast<const __m128i*>(&frac[i]));
+    const __m128i delta = MultiplyLow32(_mm_sub_epi32(n, c), f);
+    const __m128i result = _mm_srai_epi32(_mm_add_epi32(_mm_slli_epi32(c, 16), delta), 16);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), result);
+  }
+#endif
+  for (; i < num_frames * 2; ++i)
+    output[i] = ((current[i] << 16) + (next[i] - current[i]) * frac[i]) >> 16;
+
+  return num_frames;
+}
+
+// Interpolates up to max_frames frames using a windowed-sinc filter.
+u32 Mixer::MixerFifo::ResampleSinc(s32* output, u32 max_frames, u32& indexR, u32 indexW,
+                                   u32 ratio)
+{
+  u32 num_frames = 0;
+  for (; num_frames < max_frames && ((indexW - indexR) & INDEX_MASK) > 2 * (SINC_TAPS / 2);
+       ++num_frames)
+  {
+    const SincCoefficients& coefs = s_sinc_table[m_frac >> (16 - SINC_PHASE_BITS)];
+    const u32 start = indexR - 2 * SINC_HISTORY;
+
+    alignas(16) std::array<s16, SINC_TAPS * 2> window;
+    if ((start & INDEX_MASK) + window.size() <= m_buffer.size())
+    {
+      std::memcpy(window.data(), &m_buffer[start & INDEX_MASK], sizeof(window));
+      if (!m_little_endian)
+      {
+        for (s16& sample : window)
+          sample = Common::swap16(sample);
+      }
+    }
+    else
+    {
+      for (u32 i = 0; i < window.size(); ++i)
+        window[i] = ReadBuffer(start + i);
+    }
+
+#ifdef _M_X86
+    __m128i sum = _mm_setzero_si128();
+    for (u32 i = 0; i < window.size(); i += 8)
+    {
+      const __m128i x = _mm_load_si128(reinterpret_cast<const __m128i*>(&window[i]));
+      const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&coefs[i]));
+      const __m128i lo = _mm_mullo_epi16(x, c);
+      const __m128i hi = _mm_mulhi_epi16(x, c);
+      sum = _mm_add_epi32(sum, _mm_unpacklo_epi16(lo, hi));
+      sum = _mm_add_epi32(sum, _mm_unpackhi_epi16(lo, hi));
+    }
+    // sum holds the left and right totals of the even and odd taps. Add them up, round, and
+    // store the result right channel first.
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_srai_epi32(_mm_add_epi32(sum, _mm_set1_epi32(1 << 13)), 14);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(output + 2 * num_frames),
+                     _mm_shuffle_epi32(sum, _MM_SHUFFLE(3, 2, 0, 1)));
+#else
+    s32 left = 1 << 13;
+    s32 right = 1 << 13;
+    for (u32 i = 0; i < window.size(); i += 2)
+    {
+      left += window[i] * coefs[i];
+      right += window[i + 1] * coefs[i + 1];
+    }
+    output[2 * num_frames] = right >> 14;
+    output[2 * num_frames + 1] = left >> 14;
+#endif
+
+    m_frac += ratio;
+    indexR += 2 * (u16)(m_frac >> 16);
+    m_frac &= 0xffff;
+  }
+
+  return num_frames;
+}
+
 // Executed from sound stream thread
 unsigned int Mixer::MixerFifo::Mix(short* samples, unsigned int numSamples,
                                    bool consider_framelimit)
@@ -64,8 +281,8 @@ unsigned int Mixer::MixerFifo::Mix(short* samples, unsigned int numSamples,
   // so we will just ignore new written data while interpolating.
   // Without this cache, the compiler wouldn't be allowed to optimize the
   // interpolation loop.
-  u32 indexR = m_indexR.load();
-  u32 indexW = m_indexW.load();
+  u32 indexR = m_indexR.load(std::memory_order_relaxed);
+  u32 indexW = m_indexW.load(std::memory_order_acquire);
 
   // render numleft sample pairs to samples[]
   // advance indexR with sample position
@@ -77,7 +294,10 @@ unsigned int Mixer::MixerFifo::Mix(short* samples, unsigned int numSamples,
   {
     float numLeft = static_cast<float>(((indexW - indexR) & INDEX_MASK) / 2);
 
-    u32 low_waterwark = m_input_sample_rate * SConfig::GetInstance().iTimingVariance / 1000;
+    const u32 target_ms = m_mixer->m_fifo_target_ms.load(std::memory_order_relaxed);
+    u32 low_waterwark =
+        m_input_sample_rate *
+        (target_ms != 0 ? target_ms : SConfig::GetInstance().iTimingVariance) / 1000;
     low_waterwark = std::min(low_waterwark, MAX_SAMPLES / 2);
 
     m_numLeftI = (numLeft + m_numLeftI * (CONTROL_AVG - 1)) / CONTROL_AVG;
@@ -95,32 +315,22 @@ unsigned int Mixer::MixerFifo::Mix(short* samples, unsigned int numSamples,
   s32 lvolume = m_LVolume.load();
   s32 rvolume = m_RVolume.load();
 
-  const auto read_buffer = [this](auto index) {
-    return m_little_endian ? m_buffer[index] : Common::swap16(m_buffer[index]);
-  };
-
-  // TODO: consider a higher-quality resampling algorithm.
-  for (; currentSample < numSamples * 2 && ((indexW - indexR) & INDEX_MASK) > 2; currentSample += 2)
+  // Resample in blocks: the read position is advanced serially while gathering the input frames,
+  // and the filtering, volume and mixing are then done on the whole block at once.
+  while (currentSample < numSamples * 2)
   {
-    u32 indexR2 = indexR + 2;  // next sample
-
-    s16 l1 = read_buffer(indexR & INDEX_MASK);   // current
-    s16 l2 = read_buffer(indexR2 & INDEX_MASK);  // next
-    int sampleL = ((l1 << 16) + (l2 - l1) * (u16)m_frac) >> 16;
-    sampleL = (sampleL * lvolume) >> 8;
-    sampleL += samples[currentSample + 1];
-    samples[currentSample + 1] = std::clamp(sampleL, -32767, 32767);
-
-    s16 r1 = read_buffer((indexR + 1) & INDEX_MASK);   // current
-    s16 r2 = read_buffer((indexR2 + 1) & INDEX_MASK);  // next
-    int sampleR = ((r1 << 16) + (r2 - r1) * (u16)m_frac) >> 16;
-    sampleR = (sampleR * rvolume) >> 8;
-    sampleR += samples[currentSample];
-    samples[currentSample] = std::clamp(sampleR, -32767, 32767);
-
-    m_frac += ratio;
-    indexR += 2 * (u16)(m_frac >> 16);
-    m_frac &= 0xffff;
+    alignas(16) std::array<s32, RESAMPLE_BLOCK_SIZE * 2> resampled;
+    const u32 max_frames = std::min(RESAMPLE_BLOCK_SIZE, numSamples - currentSample / 2);
+    const u32 num_frames =
+        m_mixer->m_sinc_resampling ?
+            ResampleSinc(resampled.data(), max_frames, indexR, indexW, ratio) :
+            ResampleLinear(resampled.data(), max_frames, indexR, indexW, ratio);
+
+    MixResampledFrames(samples + currentSample, resampled.data(), num_frames, lvolume, rvolume);
+    currentSample += num_frames * 2;
+
+    if (num_frames < max_frames)
+      break;
   }
 
   // Actual number of samples written to the buffer without padding.
@@ -128,8 +338,8 @@ unsigned int Mixer::MixerFifo::Mix(short* samples, unsigned int numSamples,
 
   // Padding
   short s[2];
-  s[0] = read_buffer((indexR - 1) & INDEX_MASK);
-  s[1] = read_buffer((indexR - 2) & INDEX_MASK);
+  s[0] = ReadBuffer(indexR - 1);
+  s[1] = ReadBuffer(indexR - 2);
   s[0] = (s[0] * rvolume) >> 8;
   s[1] = (s[1] * lvolume) >> 8;
   for (; currentSample < numSamples * 2; currentSample += 2)
@@ -142,7 +352,7 @@ unsigned int Mixer::MixerFifo::Mix(short* samples, unsigned int numSamples,
   }
 
   // Flush cached variable
-  m_indexR.store(indexR);
+  m_indexR.store(indexR, std::memory_order_release);
 
   return actual_sample_count;
 }
@@ -217,12 +427,16 @@ void Mixer::MixerFifo::PushSamples(const short* samples, unsigned int num_sample
   // Cache access in non-volatile variable
   // indexR isn't allowed to cache in the audio throttling loop as it
   // needs to get updates to not deadlock.
-  u32 indexW = m_indexW.load();
+  u32 indexW = m_indexW.load(std::memory_order_relaxed);
 
   // Check if we have enough free space
-  // indexW == m_indexR results in empty buffer, so indexR must always be smaller than indexW
-  if (num_samples * 2 + ((indexW - m_indexR.load()) & INDEX_MASK) >= MAX_SAMPLES * 2)
+  // indexW == m_indexR results in empty buffer, so indexR must always be smaller than indexW.
+  // The frames right before indexR are kept as history for the sinc resampler.
+  if (num_samples * 2 + ((indexW - m_indexR.load(std::memory_order_acquire)) & INDEX_MASK) >=
+      MAX_SAMPLES * 2 - 2 * SINC_HISTORY)
+  {
     return;
+  }
 
   // AyuanX: Actual re-sampling work has been moved to sound thread
   // to alleviate the workload on main thread
@@ -238,7 +452,7 @@ void Mixer::MixerFifo::PushSamples(const short* samples, unsigned int num_sample
     memcpy(&m_buffer[indexW & INDEX_MASK], samples, num_samples * 4);
   }
 
-  m_indexW.fetch_add(num_samples * 2);
+  m_indexW.store(indexW + num_samples * 2, std::memory_order_release);
 }
 
 void Mixer::PushSamples(const short* samples, unsigned int num_samples)
@@ -246,7 +460,7 @@ void Mixer::PushSamples(const short* samples, unsigned int num_samples)
   m_dma_mixer.PushSamples(samples, num_samples);
   int sample_rate = m_dma_mixer.GetInputSampleRate();
   if (m_log_dsp_audio)
-    m_wave_writer_dsp.AddStereoSamplesBE(samples, num_samples, sample_rate);
+    m_dumper_dsp.AddStereoSamplesBE(samples, num_samples, sample_rate);
 }
 
 void Mixer::PushStreamingSamples(const short* samples, unsigned int num_samples)
@@ -254,7 +468,7 @@ void Mixer::PushStreamingSamples(const short* samples, unsigned int num_samples)
   m_streaming_mixer.PushSamples(samples, num_samples);
   int sample_rate = m_streaming_mixer.GetInputSampleRate();
   if (m_log_dtk_audio)
-    m_wave_writer_dtk.AddStereoSamplesBE(samples, num_samples, sample_rate);
+    m_dumper_dtk.AddStereoSamplesBE(samples, num_samples, sample_rate);
 }
 
 void Mixer::PushWiimoteSpeakerSamples(const short* samples, unsigned int num_samples,
@@ -315,16 +529,15 @@ void Mixer::StartLogDTKAudio(const std::string& filename)
 {
   if (!m_log_dtk_audio)
   {
-    bool success = m_wave_writer_dtk.Start(filename, m_streaming_mixer.GetInputSampleRate());
+    bool success = m_dumper_dtk.Start(filename, m_streaming_mixer.GetInputSampleRate());
     if (success)
     {
       m_log_dtk_audio = true;
-      m_wave_writer_dtk.SetSkipSilence(false);
       NOTICE_LOG_FMT(AUDIO, "Starting DTK Audio logging");
     }
     else
     {
-      m_wave_writer_dtk.Stop();
+      m_dumper_dtk.Stop();
       NOTICE_LOG_FMT(AUDIO, "Unable to start DTK Audio logging");
     }
   }
@@ -339,7 +552,7 @@ void Mixer::StopLogDTKAudio()
   if (m_log_dtk_audio)
   {
     m_log_dtk_audio = false;
-    m_wave_writer_dtk.Stop();
+    m_dumper_dtk.Stop();
     NOTICE_LOG_FMT(AUDIO, "Stopping DTK Audio logging");
   }
   else
@@ -352,16 +565,15 @@ void Mixer::StartLogDSPAudio(const std::string& filename)
 {
   if (!m_log_dsp_audio)
   {
-    bool success = m_wave_writer_dsp.Start(filename, m_dma_mixer.GetInputSampleRate());
+    bool success = m_dumper_dsp.Start(filename, m_dma_mixer.GetInputSampleRate());
     if (success)
     {
       m_log_dsp_audio = true;
-      m_wave_writer_dsp.SetSkipSilence(false);
       NOTICE_LOG_FMT(AUDIO, "Starting DSP Audio logging");
     }
     else
     {
-      m_wave_writer_dsp.Stop();
+      m_dumper_dsp.Stop();
       NOTICE_LOG_FMT(AUDIO, "Unable to start DSP Audio logging");
     }
   }
@@ -376,7 +588,7 @@ void Mixer::StopLogDSPAudio()
   if (m_log_dsp_audio)
   {
     m_log_dsp_audio = false;
-    m_wave_writer_dsp.Stop();
+    m_dumper_dsp.Stop();
     NOTICE_LOG_FMT(AUDIO, "Stopping DSP Audio logging");
   }
   else
@@ -6,9 +6,9 @@
 #include <array>
 #include <atomic>
 
+#include "AudioCommon/AudioDumper.h"
 #include "AudioCommon/AudioStretcher.h"
 #include "AudioCommon/SurroundDecoder.h"
-#include "AudioCommon/WaveFile.h"
 #include "Common/CommonTypes.h"
 
 class PointerWrap;
@@ -48,6 +48,13 @@ public:
   void StartLogDSPAudio(const std::string& filename);
   void StopLogDSPAudio();
 
+  // Number of output samples queued in the DMA FIFO.
+  unsigned int AvailableSamples() const { return m_dma_mixer.AvailableSamples(); }
+
+  // Overrides the FIFO fill level the resampling ratio is adjusted towards, which is normally
+  // given by the timing variance setting. 0 restores the default.
+  void SetFIFOTargetLatency(u32 ms) { m_fifo_target_ms.store(ms, std::memory_order_relaxed); }
+
   float GetCurrentSpeed() const { return m_speed.load(); }
   void UpdateSpeed(float val) { m_speed.store(val); }
 
@@ -76,12 +83,18 @@ private:
     unsigned int AvailableSamples() const;
 
   private:
+    short ReadBuffer(u32 index) const;
+    u32 ResampleLinear(s32* output, u32 max_frames, u32& indexR, u32 indexW, u32 ratio);
+    u32 ResampleSinc(s32* output, u32 max_frames, u32& indexR, u32 indexW, u32 ratio);
+
     Mixer* m_mixer;
     unsigned m_input_sample_rate;
     bool m_little_endian;
     std::array<short, MAX_SAMPLES * 2> m_buffer{};
-    std::atomic<u32> m_indexW{0};
-    std::atomic<u32> m_indexR{0};
+    // The FIFO has a single producer (the emulation thread) and a single consumer (the audio
+    // thread). Keep the two indices on separate cache lines so they don't bounce between cores.
+    alignas(64) std::atomic<u32> m_indexW{0};
+    alignas(64) std::atomic<u32> m_indexR{0};
     // Volume ranges from 0-256
     std::atomic<s32> m_LVolume{256};
     std::atomic<s32> m_RVolume{256};
@@ -95,18 +108,21 @@ private:
   std::array<MixerFifo, 4> m_gba_mixers{MixerFifo{this, 48000, true}, MixerFifo{this, 48000, true},
                                         MixerFifo{this, 48000, true}, MixerFifo{this, 48000, true}};
   unsigned int m_sampleRate;
+  bool m_sinc_resampling;
 
   bool m_is_stretching = false;
   AudioCommon::AudioStretcher m_stretcher;
   AudioCommon::SurroundDecoder m_surround_decoder;
   std::array<short, MAX_SAMPLES * 2> m_scratch_buffer;
 
-  WaveFileWriter m_wave_writer_dtk;
-  WaveFileWriter m_wave_writer_dsp;
+  AudioCommon::AudioDumper m_dumper_dtk;
+  AudioCommon::AudioDumper m_dumper_dsp;
 
   bool m_log_dtk_audio = false;
   bool m_log_dsp_audio = false;
 
   // Current rate of emulation (1.0 = 100% speed)
   std::atomic<float> m_speed{0.0f};
+
+  std::atomic<u32> m_fifo_target_ms{0};
 };
@@ -9,11 +9,16 @@
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Common/Thread.h"
+#include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 
 namespace
 {
 const size_t BUFFER_SAMPLES = 512;  // ~10 ms - needs to be at least 240 for surround
+// Bounds of the buffer size in adaptive latency mode.
+const u32 MIN_ADAPTIVE_BUFFER_SAMPLES = 128;           // ~3 ms
+const u32 MIN_ADAPTIVE_SURROUND_BUFFER_SAMPLES = 240;  // ~5 ms
+const u32 MAX_ADAPTIVE_BUFFER_SAMPLES = 8192;
 }
 
 PulseAudio::PulseAudio() = default;
@@ -25,6 +30,15 @@ bool PulseAudio::Init()
 
   NOTICE_LOG_FMT(AUDIO, "PulseAudio backend using {} channels", m_channels);
 
+  if (Config::Get(Config::MAIN_AUDIO_ADAPTIVE_LATENCY))
+  {
+    m_latency_controller = std::make_unique<AudioCommon::LatencyController>(
+        m_mixer->GetSampleRate(),
+        m_stereo ? MIN_ADAPTIVE_BUFFER_SAMPLES : MIN_ADAPTIVE_SURROUND_BUFFER_SAMPLES,
+        MAX_ADAPTIVE_BUFFER_SAMPLES, static_cast<u32>(BUFFER_SAMPLES),
+        SConfig::GetInstance().iTimingVariance);
+  }
+
   m_run_thread.Set();
   m_thread = std::thread(&PulseAudio::SoundLoop, this);
 
@@ -158,6 +172,14 @@ void PulseAudio::StateCallback(pa_context* c)
 // on underflow, increase pulseaudio latency in ~10ms steps
 void PulseAudio::UnderflowCallback(pa_stream* s)
 {
+  if (m_latency_controller)
+  {
+    // The buffer is resized in the next write callback.
+    m_latency_controller->OnBackendUnderrun();
+    WARN_LOG_FMT(AUDIO, "pulseaudio underflow");
+    return;
+  }
+
   m_pa_ba.tlength += BUFFER_SAMPLES * m_channels * m_bytespersample;
   pa_operation* op = pa_stream_set_buffer_attr(s, &m_pa_ba, nullptr, nullptr);
   pa_operation_unref(op);
@@ -178,6 +200,12 @@ void PulseAudio::WriteCallback(pa_stream* s, size_t length)
   if (!buffer || m_pa_error < 0)
     return;  // error will be printed from main loop
 
+  if (m_latency_controller)
+  {
+    m_latency_controller->OnCallback(frames, m_mixer->AvailableSamples());
+    m_mixer->SetFIFOTargetLatency(m_latency_controller->GetFIFOTargetMs());
+  }
+
   if (m_stereo)
   {
     // use the raw s16 stereo mix
@@ -197,6 +225,22 @@ void PulseAudio::WriteCallback(pa_stream* s, size_t length)
   }
 
   m_pa_error = pa_stream_write(s, buffer, trunc_length, nullptr, 0, PA_SEEK_RELATIVE);
+
+  if (m_latency_controller)
+  {
+    const u32 tlength = m_latency_controller->GetBackendFrames() * bytes_per_frame;
+    if (tlength != m_pa_ba.tlength)
+    {
+      m_pa_ba.tlength = tlength;
+      pa_operation* op = pa_stream_set_buffer_attr(s, &m_pa_ba, nullptr, nullptr);
+      pa_operation_unref(op);
+    }
+  }
+}
+
+u32 PulseAudio::GetLatencyMs() const
+{
+  return m_latency_controller ? m_latency_controller->GetLatencyMs() : 0;
 }
 
 // Callbacks that forward to internal methods (required because PulseAudio is a C API).
@@ -7,6 +7,9 @@
 #include <pulse/pulseaudio.h>
 #endif
 
+#include <memory>
+
+#include "AudioCommon/LatencyController.h"
 #include "AudioCommon/SoundStream.h"
 #include "Common/CommonTypes.h"
 #include "Common/Flag.h"
@@ -22,6 +25,7 @@ public:
   bool Init() override;
   bool SetRunning(bool running) override { return true; }
   static bool IsValid() { return true; }
+  u32 GetLatencyMs() const override;
   void StateCallback(pa_context* c);
   void WriteCallback(pa_stream* s, size_t length);
   void UnderflowCallback(pa_stream* s);
@@ -51,5 +55,7 @@ private:
   pa_context* m_pa_ctx;
   pa_stream* m_pa_s;
   pa_buffer_attr m_pa_ba;
+
+  std::unique_ptr<AudioCommon::LatencyController> m_latency_controller;
 #endif
 };
@@ -22,4 +22,7 @@ public:
   virtual void SetVolume(int) {}
   // Returns true if successful.
   virtual bool SetRunning(bool running) { return false; }
+  // Returns the output latency in milliseconds, including the audio queued in the mixer,
+  // or 0 if the backend doesn't track it.
+  virtual u32 GetLatencyMs() const { return 0; }
 };
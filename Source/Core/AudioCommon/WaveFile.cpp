@@ -3,7 +3,13 @@
 
 #include "AudioCommon/WaveFile.h"
 
+#include <cstring>
 #include <string>
+#include <utility>
+
+#ifdef _M_X86
+#include <emmintrin.h>
+#endif
 
 #include "Common/CommonTypes.h"
 #include "Common/FileUtil.h"
@@ -16,6 +22,33 @@
 
 constexpr size_t WaveFileWriter::BUFFER_SIZE;
 
+namespace AudioCommon
+{
+void ConvertStereoSamplesBE(short* output, const short* input, u32 count)
+{
+  // Swapping the channels and the byte order of both samples is the same as reversing the bytes
+  // of each 32-bit frame.
+  u32 i = 0;
+#ifdef _M_X86
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128i frames = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i * 2));
+    frames = _mm_or_si128(_mm_slli_epi16(frames, 8), _mm_srli_epi16(frames, 8));
+    frames = _mm_shufflelo_epi16(frames, _MM_SHUFFLE(2, 3, 0, 1));
+    frames = _mm_shufflehi_epi16(frames, _MM_SHUFFLE(2, 3, 0, 1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i * 2), frames);
+  }
+#endif
+  for (; i < count; ++i)
+  {
+    u32 frame;
+    std::memcpy(&frame, input + i * 2, sizeof(frame));
+    frame = Common::swap32(frame);
+    std::memcpy(output + i * 2, &frame, sizeof(frame));
+  }
+}
+}  // namespace AudioCommon
+
 WaveFileWriter::WaveFileWriter()
 {
 }
@@ -49,8 +82,8 @@ bool WaveFileWriter::Start(const std::string& filename, unsigned int HLESampleRa
     return false;
   }
 
-  file.Open(filename, "wb");
-  if (!file)
+  File::IOFile new_file(filename, "wb");
+  if (!new_file)
   {
     PanicAlertFmtT(
         "The file {0} could not be opened for writing. Please check if it's already opened "
@@ -59,11 +92,17 @@ bool WaveFileWriter::Start(const std::string& filename, unsigned int HLESampleRa
     return false;
   }
 
-  audio_size = 0;
-
   if (basename.empty())
     SplitPath(filename, nullptr, &basename, nullptr);
 
+  Start(std::move(new_file), HLESampleRate);
+  return true;
+}
+
+void WaveFileWriter::Start(File::IOFile new_file, unsigned int HLESampleRate)
+{
+  file = std::move(new_file);
+  audio_size = 0;
   current_sample_rate = HLESampleRate;
 
   // -----------------
@@ -87,9 +126,7 @@ bool WaveFileWriter::Start(const std::string& filename, unsigned int HLESampleRa
 
   // We are now at offset 44
   if (file.Tell() != 44)
-    PanicAlertFmt("Wrong offset: {}", file.Tell());
-
-  return true;
+    ERROR_LOG_FMT(AUDIO, "WaveFileWriter - wrong offset: {}", file.Tell());
 }
 
 void WaveFileWriter::Stop()
@@ -136,12 +173,8 @@ void WaveFileWriter::AddStereoSamplesBE(const short* sample_data, u32 count, int
       return;
   }
 
-  for (u32 i = 0; i < count; i++)
-  {
-    // Flip the audio channels from RL to LR
-    conv_buffer[2 * i] = Common::swap16((u16)sample_data[2 * i + 1]);
-    conv_buffer[2 * i + 1] = Common::swap16((u16)sample_data[2 * i]);
-  }
+  // Flip the audio channels from RL to LR
+  AudioCommon::ConvertStereoSamplesBE(conv_buffer.data(), sample_data, count);
 
   if (sample_rate != current_sample_rate)
   {
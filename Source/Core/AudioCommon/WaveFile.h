@@ -31,6 +31,9 @@ public:
   WaveFileWriter& operator=(WaveFileWriter&&) = delete;
 
   bool Start(const std::string& filename, unsigned int HLESampleRate);
+  // Writes to a file which has already been opened. Unlike the above, this never shows any
+  // dialogs, so it can be used from any thread.
+  void Start(File::IOFile new_file, unsigned int HLESampleRate);
   void Stop();
 
   void SetSkipSilence(bool skip) { skip_silence = skip; }
@@ -50,3 +53,10 @@ private:
   int current_sample_rate;
   int file_index = 0;
 };
+
+namespace AudioCommon
+{
+// Converts big endian stereo samples with the right channel first, as the DSP produces them, to
+// native endian samples with the left channel first, as audio file formats store them.
+void ConvertStereoSamplesBE(short* output, const short* input, u32 count);
+}  // namespace AudioCommon
@@ -1,25 +1,198 @@
 // Copyright 2017 Dolphin Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include "Common/Crypto/AES.h"
+
+#include <algorithm>
+#include <iterator>
+
 #include <mbedtls/aes.h>
 
-#include "Common/Crypto/AES.h"
+#include "Common/CPUDetect.h"
+#include "Common/Intrinsics.h"
 
 namespace Common::AES
 {
-std::vector<u8> DecryptEncrypt(const u8* key, u8* iv, const u8* src, size_t size, Mode mode)
+namespace
 {
-  mbedtls_aes_context aes_ctx;
-  std::vector<u8> buffer(size);
+class ContextMbedTLS final : public Context
+{
+public:
+  ContextMbedTLS(const u8* key, Mode mode) : m_mode(mode)
+  {
+    mbedtls_aes_init(&m_ctx);
+    if (mode == Mode::Encrypt)
+      mbedtls_aes_setkey_enc(&m_ctx, key, 128);
+    else
+      mbedtls_aes_setkey_dec(&m_ctx, key, 128);
+  }
+
+  ~ContextMbedTLS() override { mbedtls_aes_free(&m_ctx); }
+
+  bool CryptCBC(u8* iv, const u8* src, u8* dst, size_t size) const override
+  {
+    // mbedtls only reads from the context, but does not declare it const.
+    return mbedtls_aes_crypt_cbc(const_cast<mbedtls_aes_context*>(&m_ctx),
+                                 m_mode == Mode::Encrypt ? MBEDTLS_AES_ENCRYPT :
+                                                           MBEDTLS_AES_DECRYPT,
+                                 size, iv, src, dst) == 0;
+  }
+
+private:
+  mbedtls_aes_context m_ctx;
+  Mode m_mode;
+};
+
+#if defined(_M_X86_64)
+
+#if defined(__GNUC__) || defined(__clang__)
+#define FUNCTION_TARGET_AES [[gnu::target("aes,sse4.1")]]
+#else
+#define FUNCTION_TARGET_AES
+#endif
+
+class ContextAESNI final : public Context
+{
+public:
+  ContextAESNI(const u8* key, Mode mode) : m_mode(mode) { ExpandKey(key); }
+
+  bool CryptCBC(u8* iv, const u8* src, u8* dst, size_t size) const override
+  {
+    // The loops below only handle whole blocks.
+    if (size % BLOCK_SIZE != 0)
+      return false;
+
+    if (m_mode == Mode::Encrypt)
+      EncryptCBC(iv, src, dst, size);
+    else
+      DecryptCBC(iv, src, dst, size);
+    return true;
+  }
 
-  if (mode == Mode::Encrypt)
-    mbedtls_aes_setkey_enc(&aes_ctx, key, 128);
-  else
-    mbedtls_aes_setkey_dec(&aes_ctx, key, 128);
+private:
+  static constexpr size_t NUM_ROUNDS = 10;
+  static constexpr size_t BLOCK_SIZE = 16;
 
-  mbedtls_aes_crypt_cbc(&aes_ctx, mode == Mode::Encrypt ? MBEDTLS_AES_ENCRYPT : MBEDTLS_AES_DECRYPT,
-                        size, iv, src, buffer.data());
+  template <int rcon>
+  FUNCTION_TARGET_AES static __m128i ExpandRound(__m128i key)
+  {
+    __m128i assist = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(key, rcon), 0xff);
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    return _mm_xor_si128(key, assist);
+  }
 
+  FUNCTION_TARGET_AES void ExpandKey(const u8* key)
+  {
+    __m128i keys[NUM_ROUNDS + 1];
+    keys[0] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key));
+    keys[1] = ExpandRound<0x01>(keys[0]);
+    keys[2] = ExpandRound<0x02>(keys[1]);
+    keys[3] = ExpandRound<0x04>(keys[2]);
+    keys[4] = ExpandRound<0x08>(keys[3]);
+    keys[5] = ExpandRound<0x10>(keys[4]);
+    keys[6] = ExpandRound<0x20>(keys[5]);
+    keys[7] = ExpandRound<0x40>(keys[6]);
+    keys[8] = ExpandRound<0x80>(keys[7]);
+    keys[9] = ExpandRound<0x1b>(keys[8]);
+    keys[10] = ExpandRound<0x36>(keys[9]);
+
+    if (m_mode == Mode::Encrypt)
+    {
+      std::copy(std::begin(keys), std::end(keys), std::begin(m_round_keys));
+      return;
+    }
+
+    // The equivalent inverse cipher uses the round keys in reverse order, with InvMixColumns
+    // applied to all but the first and last one.
+    m_round_keys[0] = keys[NUM_ROUNDS];
+    for (size_t i = 1; i < NUM_ROUNDS; ++i)
+      m_round_keys[i] = _mm_aesimc_si128(keys[NUM_ROUNDS - i]);
+    m_round_keys[NUM_ROUNDS] = keys[0];
+  }
+
+  FUNCTION_TARGET_AES void EncryptCBC(u8* iv, const u8* src, u8* dst, size_t size) const
+  {
+    // Each block depends on the previous ciphertext, so there is nothing to interleave here.
+    __m128i state = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iv));
+    for (size_t offset = 0; offset < size; offset += BLOCK_SIZE)
+    {
+      const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + offset));
+      state = _mm_xor_si128(_mm_xor_si128(block, state), m_round_keys[0]);
+      for (size_t i = 1; i < NUM_ROUNDS; ++i)
+        state = _mm_aesenc_si128(state, m_round_keys[i]);
+      state = _mm_aesenclast_si128(state, m_round_keys[NUM_ROUNDS]);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + offset), state);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(iv), state);
+  }
+
+  FUNCTION_TARGET_AES void DecryptCBC(u8* iv, const u8* src, u8* dst, size_t size) const
+  {
+    // Unlike encryption, CBC decryption of each block only depends on ciphertext, so several
+    // blocks can be kept in flight to hide the latency of aesdec.
+    constexpr size_t BATCH = 8;
+
+    __m128i prev = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iv));
+    size_t offset = 0;
+    for (; offset + BATCH * BLOCK_SIZE <= size; offset += BATCH * BLOCK_SIZE)
+    {
+      __m128i in[BATCH];
+      __m128i state[BATCH];
+      for (size_t j = 0; j < BATCH; ++j)
+      {
+        in[j] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + offset + j * BLOCK_SIZE));
+        state[j] = _mm_xor_si128(in[j], m_round_keys[0]);
+      }
+      for (size_t i = 1; i < NUM_ROUNDS; ++i)
+      {
+        for (size_t j = 0; j < BATCH; ++j)
+          state[j] = _mm_aesdec_si128(state[j], m_round_keys[i]);
+      }
+      for (size_t j = 0; j < BATCH; ++j)
+      {
+        state[j] = _mm_aesdeclast_si128(state[j], m_round_keys[NUM_ROUNDS]);
+        state[j] = _mm_xor_si128(state[j], j == 0 ? prev : in[j - 1]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + offset + j * BLOCK_SIZE), state[j]);
+      }
+      prev = in[BATCH - 1];
+    }
+
+    for (; offset < size; offset += BLOCK_SIZE)
+    {
+      const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + offset));
+      __m128i state = _mm_xor_si128(in, m_round_keys[0]);
+      for (size_t i = 1; i < NUM_ROUNDS; ++i)
+        state = _mm_aesdec_si128(state, m_round_keys[i]);
+      state = _mm_xor_si128(_mm_aesdeclast_si128(state, m_round_keys[NUM_ROUNDS]), prev);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + offset), state);
+      prev = in;
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(iv), prev);
+  }
+
+  __m128i m_round_keys[NUM_ROUNDS + 1];
+  Mode m_mode;
+};
+
+#endif
+}  // Anonymous namespace
+
+std::unique_ptr<Context> CreateContext(const u8* key, Mode mode)
+{
+#if defined(_M_X86_64)
+  if (cpu_info.bAES)
+    return std::make_unique<ContextAESNI>(key, mode);
+#endif
+  return std::make_unique<ContextMbedTLS>(key, mode);
+}
+
+std::vector<u8> DecryptEncrypt(const u8* key, u8* iv, const u8* src, size_t size, Mode mode)
+{
+  std::vector<u8> buffer(size);
+  CreateContext(key, mode)->CryptCBC(iv, src, buffer.data(), size);
   return buffer;
 }
 
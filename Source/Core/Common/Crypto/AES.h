@@ -4,6 +4,7 @@
 #pragma once
 
 #include <cstddef>
+#include <memory>
 #include <vector>
 
 #include "Common/CommonTypes.h"
@@ -15,6 +16,25 @@ enum class Mode
   Decrypt,
   Encrypt,
 };
+
+// An expanded AES-128 key that can be reused for any number of CBC operations.
+// Creating a context is comparatively expensive, so callers that process many buffers with
+// the same key should keep one around instead of using the convenience functions below.
+// Contexts are immutable after creation and may be shared between threads.
+class Context
+{
+public:
+  virtual ~Context() = default;
+
+  // Encrypts or decrypts (depending on the mode the context was created with) size bytes from
+  // src to dst. iv is updated for chaining subsequent calls. src and dst may point to the same
+  // buffer. Returns false without touching any of the buffers if size isn't a multiple of 16.
+  virtual bool CryptCBC(u8* iv, const u8* src, u8* dst, size_t size) const = 0;
+};
+
+// Uses AES-NI if it is available on the host, and mbedtls otherwise.
+std::unique_ptr<Context> CreateContext(const u8* key, Mode mode);
+
 std::vector<u8> DecryptEncrypt(const u8* key, u8* iv, const u8* src, size_t size, Mode mode);
 
 // Convenience functions
@@ -132,6 +132,48 @@ void MemArena::ReleaseView(void* view, size_t size)
 #endif
 }
 
+bool MemArena::ProtectView(void* view, size_t size, ViewAccess access)
+{
+#ifdef _WIN32
+  DWORD protection = PAGE_NOACCESS;
+  if (access == ViewAccess::ReadOnly)
+    protection = PAGE_READONLY;
+  else if (access == ViewAccess::ReadWrite)
+    protection = PAGE_READWRITE;
+
+  DWORD old_protection;
+  if (!VirtualProtect(view, size, protection, &old_protection))
+  {
+    ERROR_LOG_FMT(MEMMAP, "VirtualProtect failed: {}", GetLastErrorString());
+    return false;
+  }
+#else
+  int protection = PROT_NONE;
+  if (access == ViewAccess::ReadOnly)
+    protection = PROT_READ;
+  else if (access == ViewAccess::ReadWrite)
+    protection = PROT_READ | PROT_WRITE;
+
+  if (mprotect(view, size, protection) != 0)
+  {
+    ERROR_LOG_FMT(MEMMAP, "mprotect failed: {}", LastStrerrorString());
+    return false;
+  }
+#endif
+  return true;
+}
+
+size_t MemArena::GetHostPageSize()
+{
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwPageSize;
+#else
+  return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
 u8* MemArena::FindMemoryBase()
 {
 #if _ARCH_32
@@ -25,6 +25,18 @@ public:
   void* CreateView(s64 offset, size_t size, void* base = nullptr);
   void ReleaseView(void* view, size_t size);
 
+  // Changes the host protection of (part of) a view. The range must be aligned to the host page
+  // size and lie entirely within views created by CreateView.
+  enum class ViewAccess
+  {
+    None,
+    ReadOnly,
+    ReadWrite,
+  };
+  bool ProtectView(void* view, size_t size, ViewAccess access);
+
+  static size_t GetHostPageSize();
+
   // This finds 1 GB in 32-bit, 16 GB in 64-bit.
   static u8* FindMemoryBase();
 
@@ -64,6 +64,7 @@ bool IsSettingSaveable(const Config::Location& config_location)
       &Config::MAIN_ENABLE_SAVESTATES.GetLocation(),
       &Config::MAIN_FALLBACK_REGION.GetLocation(),
       &Config::MAIN_REAL_WII_REMOTE_REPEAT_REPORTS.GetLocation(),
+      &Config::MAIN_DVD_PREFETCH.GetLocation(),
 
       // Main.Interface
 
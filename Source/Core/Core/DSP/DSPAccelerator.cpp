@@ -5,12 +5,67 @@
 
 #include "Core/DSP/DSPAccelerator.h"
 
+#ifdef _M_X86
+#include <emmintrin.h>
+#endif
+
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 
 namespace DSP
 {
+constexpr u32 START_END_ADDRESS_MASK = 0x3fffffff;
+constexpr u32 CURRENT_ADDRESS_MASK = 0xbfffffff;
+
+void DecodeADPCMNibbles(const u8* frame, u32 scale_shift, s32* out)
+{
+#ifdef _M_X86
+  const __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(frame));
+  const __m128i low_mask = _mm_set1_epi8(0x0F);
+  const __m128i high = _mm_and_si128(_mm_srli_epi16(bytes, 4), low_mask);
+  const __m128i low = _mm_and_si128(bytes, low_mask);
+
+  // Interleave so that the high nibble of each byte comes first, then sign extend the nibbles
+  // with (x ^ 8) - 8.
+  const __m128i sign = _mm_set1_epi8(8);
+  const __m128i nibbles = _mm_sub_epi8(_mm_xor_si128(_mm_unpacklo_epi8(high, low), sign), sign);
+
+  const __m128i nibble_signs = _mm_cmpgt_epi8(_mm_setzero_si128(), nibbles);
+  const __m128i words_lo = _mm_unpacklo_epi8(nibbles, nibble_signs);
+  const __m128i words_hi = _mm_unpackhi_epi8(nibbles, nibble_signs);
+
+  const __m128i shift = _mm_cvtsi32_si128(static_cast<int>(scale_shift));
+  const auto store = [&](int index, __m128i words) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + index), _mm_sll_epi32(words, shift));
+  };
+  store(0, _mm_srai_epi32(_mm_unpacklo_epi16(words_lo, words_lo), 16));
+  store(4, _mm_srai_epi32(_mm_unpackhi_epi16(words_lo, words_lo), 16));
+  store(8, _mm_srai_epi32(_mm_unpacklo_epi16(words_hi, words_hi), 16));
+  store(12, _mm_srai_epi32(_mm_unpackhi_epi16(words_hi, words_hi), 16));
+#else
+  for (u32 i = 0; i < 16; ++i)
+  {
+    int nibble = (i & 1) ? (frame[i >> 1] & 0xF) : (frame[i >> 1] >> 4);
+    if (nibble >= 8)
+      nibble -= 16;
+    out[i] = nibble * (1 << scale_shift);
+  }
+#endif
+}
+
+void Accelerator::LoadADPCMFrame()
+{
+  const u32 frame_address = m_current_address & ~15;
+  std::array<u8, 8> frame;
+  for (u32 i = 0; i < 8; ++i)
+    frame[i] = ReadMemory((frame_address >> 1) + i);
+
+  m_adpcm_frame_address = frame_address;
+  m_adpcm_frame_scale = m_pred_scale & 0xF;
+  DecodeADPCMNibbles(frame.data(), m_adpcm_frame_scale, m_adpcm_frame.data());
+}
+
 u16 Accelerator::ReadD3()
 {
   u16 val = 0;
@@ -45,6 +100,8 @@ void Accelerator::WriteD3(u16 value)
   // Pikmin 2 Wii writes non-stop to 0x10008000-0x1000801f (non-zero values too)
   // Zelda TP Wii writes non-stop to 0x10000000-0x1000001f (non-zero values too)
 
+  m_adpcm_frame_address = INVALID_FRAME;
+
   switch (m_sample_format)
   {
   case 0xA:  // u16 writes
@@ -76,19 +133,19 @@ u16 Accelerator::Read(const s16* coefs)
   {
   case 0x00:  // ADPCM audio
   {
-    int scale = 1 << (m_pred_scale & 0xF);
     int coef_idx = (m_pred_scale >> 4) & 0x7;
 
     s32 coef1 = coefs[coef_idx * 2 + 0];
     s32 coef2 = coefs[coef_idx * 2 + 1];
 
-    int temp = (m_current_address & 1) ? (ReadMemory(m_current_address >> 1) & 0xF) :
-                                         (ReadMemory(m_current_address >> 1) >> 4);
-
-    if (temp >= 8)
-      temp -= 16;
+    if ((m_current_address & ~15) != m_adpcm_frame_address ||
+        (m_pred_scale & 0xF) != m_adpcm_frame_scale)
+    {
+      LoadADPCMFrame();
+    }
+    const s32 scaled_nibble = m_adpcm_frame[m_current_address & 15];
 
-    s32 val32 = (scale * temp) + ((0x400 + coef1 * m_yn1 + coef2 * m_yn2) >> 11);
+    s32 val32 = scaled_nibble + ((0x400 + coef1 * m_yn1 + coef2 * m_yn2) >> 11);
     val = static_cast<s16>(std::clamp<s32>(val32, -0x7FFF, 0x7FFF));
     step_size_bytes = 2;
 
@@ -156,7 +213,8 @@ u16 Accelerator::Read(const s16* coefs)
     OnEndException();
   }
 
-  SetCurrentAddress(m_current_address);
+  // Not SetCurrentAddress, which would drop the cached ADPCM frame.
+  m_current_address &= CURRENT_ADDRESS_MASK;
   return val;
 }
 
@@ -170,10 +228,9 @@ void Accelerator::DoState(PointerWrap& p)
   p.Do(m_yn2);
   p.Do(m_pred_scale);
   p.Do(m_reads_stopped);
-}
 
-constexpr u32 START_END_ADDRESS_MASK = 0x3fffffff;
-constexpr u32 CURRENT_ADDRESS_MASK = 0xbfffffff;
+  m_adpcm_frame_address = INVALID_FRAME;
+}
 
 void Accelerator::SetStartAddress(u32 address)
 {
@@ -188,6 +245,7 @@ void Accelerator::SetEndAddress(u32 address)
 void Accelerator::SetCurrentAddress(u32 address)
 {
   m_current_address = address & CURRENT_ADDRESS_MASK;
+  m_adpcm_frame_address = INVALID_FRAME;
 }
 
 void Accelerator::SetSampleFormat(u16 format)
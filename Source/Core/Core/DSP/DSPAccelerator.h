@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <array>
+
 #include "Common/CommonTypes.h"
 
 class PointerWrap;
@@ -54,5 +56,23 @@ protected:
   // and updating the current address register, unless the YN2 register is written to.
   // This is kept track of internally; this state is not exposed via any register.
   bool m_reads_stopped = false;
+
+private:
+  void LoadADPCMFrame();
+
+  static constexpr u32 INVALID_FRAME = 0xffffffff;
+
+  // The last ADPCM frame that was read from memory, with every nibble already sign extended and
+  // multiplied by the scale. Sequential reads only have to fetch and unpack memory once per
+  // frame instead of once per sample. This is not part of the hardware state, and it is dropped
+  // whenever the current address is set from outside, which is what ucodes do when switching
+  // to another voice.
+  u32 m_adpcm_frame_address = INVALID_FRAME;
+  u16 m_adpcm_frame_scale = 0;
+  std::array<s32, 16> m_adpcm_frame{};
 };
+
+// Unpacks the 16 nibbles of an 8-byte ADPCM frame (including the header byte), sign extends them
+// and multiplies them by 1 << scale_shift.
+void DecodeADPCMNibbles(const u8* frame, u32 scale_shift, s32* out);
 }  // namespace DSP
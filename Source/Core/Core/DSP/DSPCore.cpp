@@ -8,6 +8,7 @@
 #include <array>
 #include <memory>
 #include <type_traits>
+#include <vector>
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
@@ -589,6 +590,20 @@ bool DSPCore::IsJITCreated() const
   return m_dsp_jit != nullptr;
 }
 
+void DSPCore::SetJITProfilingEnabled(bool enabled)
+{
+  if (m_dsp_jit)
+    m_dsp_jit->SetProfilingEnabled(enabled);
+}
+
+std::vector<JIT::BlockProfile> DSPCore::GetJITProfileResults() const
+{
+  if (!m_dsp_jit)
+    return {};
+
+  return m_dsp_jit->GetProfileResults();
+}
+
 void DSPCore::DoState(PointerWrap& p)
 {
   m_dsp.DoState(p);
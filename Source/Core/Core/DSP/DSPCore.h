@@ -9,6 +9,7 @@
 #include <cstddef>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "Common/Event.h"
 #include "Core/DSP/DSPAnalyzer.h"
@@ -29,6 +30,7 @@ class Interpreter;
 
 namespace JIT
 {
+struct BlockProfile;
 class DSPEmitter;
 }
 
@@ -556,6 +558,13 @@ public:
   // Whether or not the JIT has been created.
   bool IsJITCreated() const;
 
+  // Enables or disables counting how often each JIT block runs.
+  void SetJITProfilingEnabled(bool enabled);
+
+  // Retrieves the run counts of the JIT blocks, most executed first.
+  // Empty if profiling is disabled or the JIT isn't in use.
+  std::vector<JIT::BlockProfile> GetJITProfileResults() const;
+
   // Writes or loads state for savestates.
   void DoState(PointerWrap& p);
 
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 
@@ -16,6 +17,15 @@ class DSPCore;
 
 namespace DSP::JIT
 {
+struct BlockProfile
+{
+  u16 address;
+  u16 size;  // In instructions
+  u64 run_count;
+  // Runs which started from the dispatcher rather than through a link from another block.
+  u64 dispatch_count;
+};
+
 class DSPEmitter
 {
 public:
@@ -25,6 +35,13 @@ public:
   virtual void ClearIRAM() = 0;
 
   virtual void DoState(PointerWrap& p) = 0;
+
+  // Counts how often each block runs. Changing this discards all compiled code, which happens
+  // the next time RunCycles is called.
+  virtual void SetProfilingEnabled(bool enabled) = 0;
+  // Returns the blocks which have run since profiling was enabled, most executed first.
+  // Must not be called while RunCycles is running on another thread.
+  virtual std::vector<BlockProfile> GetProfileResults() const = 0;
 };
 
 class DSPEmitterNull final : public DSPEmitter
@@ -33,6 +50,8 @@ public:
   u16 RunCycles(u16) override { return 0; }
   void ClearIRAM() override {}
   void DoState(PointerWrap&) override {}
+  void SetProfilingEnabled(bool) override {}
+  std::vector<BlockProfile> GetProfileResults() const override { return {}; }
 };
 
 std::unique_ptr<DSPEmitter> CreateDSPEmitter(DSPCore& dsp);
@@ -50,6 +50,16 @@ DSPEmitter::~DSPEmitter()
 
 u16 DSPEmitter::RunCycles(u16 cycles)
 {
+  const bool profiling_requested = m_profiling_requested.load(std::memory_order_relaxed);
+  if (profiling_requested != m_profiling_enabled)
+  {
+    // The counters are baked into the compiled code, so everything has to be recompiled.
+    m_profiling_enabled = profiling_requested;
+    m_block_run_counts.assign(m_profiling_enabled ? MAX_BLOCKS : 0, 0);
+    m_block_dispatch_counts.assign(m_profiling_enabled ? MAX_BLOCKS : 0, 0);
+    ClearIRAMandDSPJITCodespaceReset();
+  }
+
   if (m_dsp_core.DSPState().external_interrupt_waiting.exchange(false, std::memory_order_acquire))
   {
     m_dsp_core.CheckExternalInterrupt();
@@ -83,6 +93,28 @@ void DSPEmitter::ClearIRAM()
   m_dsp_core.DSPState().reset_dspjit_codespace = true;
 }
 
+void DSPEmitter::SetProfilingEnabled(bool enabled)
+{
+  m_profiling_requested.store(enabled, std::memory_order_relaxed);
+}
+
+std::vector<BlockProfile> DSPEmitter::GetProfileResults() const
+{
+  std::vector<BlockProfile> results;
+  for (size_t i = 0; i < m_block_run_counts.size(); ++i)
+  {
+    if (m_block_run_counts[i] != 0)
+    {
+      results.push_back({static_cast<u16>(i), m_block_size[i], m_block_run_counts[i],
+                         m_block_dispatch_counts[i]});
+    }
+  }
+  std::sort(results.begin(), results.end(), [](const BlockProfile& a, const BlockProfile& b) {
+    return a.run_count > b.run_count;
+  });
+  return results;
+}
+
 void DSPEmitter::ClearIRAMandDSPJITCodespaceReset()
 {
   ClearCodeSpace();
@@ -232,10 +264,22 @@ void DSPEmitter::Compile(u16 start_addr)
 
   const u8* entryPoint = AlignCode16();
 
+  if (m_profiling_enabled)
+  {
+    MOV(64, R(RAX), ImmPtr(&m_block_dispatch_counts[start_addr]));
+    ADD(64, MatR(RAX), Imm8(1));
+  }
+
   m_gpr.LoadRegs();
 
   m_block_link_entry = GetCodePtr();
 
+  if (m_profiling_enabled)
+  {
+    MOV(64, R(RAX), ImmPtr(&m_block_run_counts[start_addr]));
+    ADD(64, MatR(RAX), Imm8(1));
+  }
+
   m_compile_pc = start_addr;
   bool fixup_pc = false;
   m_block_size[start_addr] = 0;
@@ -288,6 +332,7 @@ void DSPEmitter::Compile(u16 start_addr)
       }
       else
       {
+        WriteIndirectBlockLink();
         MOV(16, R(EAX), Imm16(m_block_size[start_addr]));
       }
       JMP(m_return_dispatcher, true);
@@ -387,6 +432,7 @@ void DSPEmitter::Compile(u16 start_addr)
   }
   else
   {
+    WriteIndirectBlockLink();
     MOV(16, R(EAX), Imm16(m_block_size[start_addr]));
   }
   JMP(m_return_dispatcher, true);
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <list>
 #include <vector>
@@ -34,6 +35,9 @@ public:
   void DoState(PointerWrap& p) override;
   void ClearIRAM() override;
 
+  void SetProfilingEnabled(bool enabled) override;
+  std::vector<BlockProfile> GetProfileResults() const override;
+
   // Ext commands
   void l(UDSPInstruction opc);
   void ln(UDSPInstruction opc);
@@ -213,6 +217,7 @@ private:
 
   void WriteBranchExit();
   void WriteBlockLink(u16 dest);
+  void WriteIndirectBlockLink();
 
   void ReJitConditional(UDSPInstruction opc, void (DSPEmitter::*conditional_fn)(UDSPInstruction));
   void r_jcc(UDSPInstruction opc);
@@ -327,6 +332,13 @@ private:
 
   u16 m_cycles_left = 0;
 
+  // Set from other threads, applied by RunCycles.
+  std::atomic<bool> m_profiling_requested = false;
+  bool m_profiling_enabled = false;
+  // Indexed by block address. Only allocated while profiling is enabled.
+  std::vector<u64> m_block_run_counts;
+  std::vector<u64> m_block_dispatch_counts;
+
   // The index of the last stored ext value (compile time).
   int m_store_index = -1;
   int m_store_index2 = -1;
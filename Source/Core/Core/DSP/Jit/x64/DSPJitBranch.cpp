@@ -5,6 +5,7 @@
 
 #include "Core/DSP/DSPAnalyzer.h"
 #include "Core/DSP/DSPCore.h"
+#include "Core/DSP/DSPHost.h"
 #include "Core/DSP/DSPTables.h"
 #include "Core/DSP/Jit/x64/DSPEmitter.h"
 
@@ -106,6 +107,7 @@ void DSPEmitter::WriteBranchExit()
   }
   else
   {
+    WriteIndirectBlockLink();
     MOV(16, R(EAX), Imm16(m_block_size[m_start_address]));
   }
   JMP(m_return_dispatcher, true);
@@ -141,6 +143,51 @@ void DSPEmitter::WriteBlockLink(u16 dest)
   }
 }
 
+void DSPEmitter::WriteIndirectBlockLink()
+{
+  // Jump to the block at the address in g_dsp.pc if it is linkable, rather than going back to
+  // the dispatcher. Unlike WriteBlockLink, this works for destinations which are only known at
+  // runtime (loop ends, returns, conditional and register jumps), and keeps the statically
+  // allocated registers live across them. The registers must have been saved already.
+  // Falls through if the block cannot be linked to.
+  //
+  // Only the statically allocated registers (the accumulators, see STATIC_REG_ACCS) carry over
+  // into the linked block. Every other guest register is written back at each block exit and
+  // loaded again when the next block first uses it. Keeping those in host registers as well would
+  // need each block entry to expect a fixed register assignment, which the cache doesn't track.
+  FixupBranch interrupt_waiting;
+  if (Host::OnThread())
+  {
+    CMP(8, M_SDSP_external_interrupt_waiting(), Imm8(0));
+    interrupt_waiting = J_CC(CC_NE);
+  }
+  TEST(8, M_SDSP_cr(), Imm8(CR_HALT));
+  FixupBranch halted = J_CC(CC_NZ);
+
+  MOVZX(32, 16, ECX, M_SDSP_pc());
+  MOV(64, R(RAX), ImmPtr(m_block_links.data()));
+  MOV(64, R(RDX), MComplex(RAX, RCX, SCALE_8, 0));
+  TEST(64, R(RDX), R(RDX));
+  FixupBranch not_linkable = J_CC(CC_Z);
+
+  // Check if we have enough cycles to execute the next block
+  MOV(64, R(RAX), ImmPtr(m_block_size.data()));
+  MOVZX(32, 16, ECX, MComplex(RAX, RCX, SCALE_2, 0));
+  ADD(32, R(ECX), Imm32(m_block_size[m_start_address]));
+  MOV(64, R(RAX), ImmPtr(&m_cycles_left));
+  CMP(16, MatR(RAX), R(ECX));
+  FixupBranch not_enough_cycles = J_CC(CC_BE);
+
+  SUB(16, MatR(RAX), Imm16(m_block_size[m_start_address]));
+  JMPptr(R(RDX));
+
+  if (Host::OnThread())
+    SetJumpTarget(interrupt_waiting);
+  SetJumpTarget(halted);
+  SetJumpTarget(not_linkable);
+  SetJumpTarget(not_enough_cycles);
+}
+
 void DSPEmitter::r_jcc(const UDSPInstruction opc)
 {
   const u16 dest = m_dsp_core.DSPState().ReadIMEM(m_compile_pc + 1);
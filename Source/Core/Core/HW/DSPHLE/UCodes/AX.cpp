@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <array>
 #include <iterator>
+#include <optional>
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
@@ -13,11 +14,13 @@
 #include "Common/IOFile.h"
 #include "Common/Logging/Log.h"
 #include "Common/Swap.h"
+#include "Core/Config/MainSettings.h"
 #include "Core/DolphinAnalytics.h"
 #include "Core/HW/DSP.h"
 #include "Core/HW/DSPHLE/DSPHLE.h"
 #include "Core/HW/DSPHLE/MailHandler.h"
 #include "Core/HW/DSPHLE/UCodes/AXStructs.h"
+#include "Core/HW/DSPHLE/UCodes/AXWorkerPool.h"
 
 #define AX_GC
 #include "Core/HW/DSPHLE/UCodes/AXVoice.h"
@@ -28,6 +31,10 @@ AXUCode::AXUCode(DSPHLE* dsphle, u32 crc)
     : UCodeInterface(dsphle, crc), m_cmdlist_size(0), m_compressor_pos(0)
 {
   INFO_LOG_FMT(DSPHLE, "Instantiating AXUCode: crc={:08x}", crc);
+
+  const int worker_threads = Config::Get(Config::MAIN_AX_WORKER_THREADS);
+  if (worker_threads > 0)
+    m_worker_pool = std::make_unique<AXWorkerPool>(static_cast<u32>(worker_threads));
 }
 
 AXUCode::~AXUCode()
@@ -415,15 +422,33 @@ void AXUCode::ProcessPBList(u32 pb_addr)
   // 32KHz to 48KHz, but AX always process at 32KHz.
   constexpr u32 spms = 32;
 
-  AXPB pb;
+  // A PB can only be processed out of order if none of its updates touch the link to the next
+  // PB (which we need to know in advance) or the updates fields themselves.
+  const auto get_next_pb = [this](u32 addr) -> std::optional<u32> {
+    constexpr u16 updates_begin = offsetof(AXPB, updates) / sizeof(u16);
+    constexpr u16 updates_end = updates_begin + sizeof(PBUpdates) / sizeof(u16);
 
-  while (pb_addr)
-  {
-    AXBuffers buffers = {{m_samples_left, m_samples_right, m_samples_surround, m_samples_auxA_left,
-                          m_samples_auxA_right, m_samples_auxA_surround, m_samples_auxB_left,
-                          m_samples_auxB_right, m_samples_auxB_surround}};
+    AXPB pb;
+    ReadPB(addr, pb, m_crc);
+
+    u32 num_updates = 0;
+    for (u16 count : pb.updates.num_updates)
+      num_updates += count;
+
+    const u16* updates = (u16*)HLEMemory_Get_Pointer(HILO_TO_32(pb.updates.data));
+    for (u32 i = 0; i < num_updates; ++i)
+    {
+      const u16 update_off = Common::swap16(updates[2 * i]);
+      if (update_off < 2 || (update_off >= updates_begin && update_off < updates_end))
+        return std::nullopt;
+    }
 
-    ReadPB(pb_addr, pb, m_crc);
+    return HILO_TO_32(pb.next_pb);
+  };
+
+  const auto process_pb = [this](u32 addr, AXBuffers buffers) -> u32 {
+    AXPB pb;
+    ReadPB(addr, pb, m_crc);
 
     u32 updates_addr = HILO_TO_32(pb.updates.data);
     u16* updates = (u16*)HLEMemory_Get_Pointer(updates_addr);
@@ -440,9 +465,15 @@ void AXUCode::ProcessPBList(u32 pb_addr)
         ptr += spms;
     }
 
-    WritePB(pb_addr, pb, m_crc);
-    pb_addr = HILO_TO_32(pb.next_pb);
-  }
+    WritePB(addr, pb, m_crc);
+    return HILO_TO_32(pb.next_pb);
+  };
+
+  const AXBuffers buffers = {{m_samples_left, m_samples_right, m_samples_surround,
+                              m_samples_auxA_left, m_samples_auxA_right, m_samples_auxA_surround,
+                              m_samples_auxB_left, m_samples_auxB_right, m_samples_auxB_surround}};
+
+  ProcessPBs(m_worker_pool.get(), pb_addr, buffers, get_next_pb, process_pb);
 }
 
 void AXUCode::MixAUXSamples(int aux_id, u32 write_addr, u32 read_addr)
@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include "Common/BitUtils.h"
 #include "Common/CommonTypes.h"
 #include "Common/Swap.h"
@@ -18,6 +20,7 @@
 
 namespace DSP::HLE
 {
+class AXWorkerPool;
 class DSPHLE;
 
 // We can't directly use the mixer_control field from the PB because it does
@@ -100,6 +103,9 @@ protected:
 
   u16 m_compressor_pos;
 
+  // Used to process voices in parallel. Null if voices are processed serially.
+  std::unique_ptr<AXWorkerPool> m_worker_pool;
+
   void LoadResamplingCoefficients();
 
   // Copy a command list from memory to our temp buffer
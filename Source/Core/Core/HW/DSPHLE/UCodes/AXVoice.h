@@ -12,8 +12,15 @@
 #endif
 
 #include <algorithm>
-#include <functional>
+#include <array>
+#include <iterator>
 #include <memory>
+#include <optional>
+#include <vector>
+
+#ifdef _M_X86
+#include <emmintrin.h>
+#endif
 
 #include "Common/CommonTypes.h"
 #include "Core/DSP/DSPAccelerator.h"
@@ -21,6 +28,7 @@
 #include "Core/HW/DSP.h"
 #include "Core/HW/DSPHLE/UCodes/AX.h"
 #include "Core/HW/DSPHLE/UCodes/AXStructs.h"
+#include "Core/HW/DSPHLE/UCodes/AXWorkerPool.h"
 #include "Core/HW/Memmap.h"
 
 namespace DSP::HLE
@@ -86,6 +94,16 @@ union AXBuffers
 #endif
 };
 
+// Returns the number of samples in each of the AXBuffers.
+constexpr u32 GetAXBufferSize(size_t index)
+{
+#ifdef AX_GC
+  return 32 * 5;
+#else
+  return index < 12 ? 32 * 3 : 6 * 3;
+#endif
+}
+
 // Determines if this version of the UCode has a PBLowPassFilter in its AXPB layout.
 bool HasLpf(u32 crc)
 {
@@ -145,8 +163,8 @@ void WritePB(u32 addr, const PB_TYPE& pb, u32 crc)
   }
 }
 
-// Simulated accelerator state.
-static PB_TYPE* acc_pb;
+// Simulated accelerator state. This is per thread so that voices can be processed in parallel.
+static thread_local PB_TYPE* acc_pb;
 
 class HLEAccelerator final : public Accelerator
 {
@@ -184,7 +202,7 @@ protected:
   void WriteMemory(u32 address, u8 value) override { WriteARAM(value, address); }
 };
 
-static std::unique_ptr<Accelerator> s_accelerator = std::make_unique<HLEAccelerator>();
+static thread_local std::unique_ptr<Accelerator> s_accelerator = std::make_unique<HLEAccelerator>();
 
 // Sets up the simulated accelerator.
 void AcceleratorSetup(PB_TYPE* pb)
@@ -213,6 +231,8 @@ u16 AcceleratorGetSample()
 // If srctype is SRCTYPE_POLYPHASE, coefficients need to be provided as well
 // (or the srctype will automatically be changed to LINEAR).
 //
+// <input_callback> is called with the index of each input sample, in order.
+//
 // Returns the current position after resampling (including fractional part).
 //
 // The input to output ratio is set in <ratio>, which is a floating point num
@@ -227,7 +247,8 @@ u16 AcceleratorGetSample()
 // We start getting samples not from sample 0, but 0.<curr_pos_frac>. This
 // avoids discontinuities in the audio stream, especially with very low ratios
 // which interpolate a lot of values between two "real" samples.
-u32 ResampleAudio(std::function<s16(u32)> input_callback, s16* output, u32 count, s16* last_samples,
+template <typename InputCallback>
+u32 ResampleAudio(InputCallback input_callback, s16* output, u32 count, s16* last_samples,
                   u32 curr_pos, u32 ratio, int srctype, const s16* coeffs)
 {
   int read_samples_count = 0;
@@ -347,9 +368,31 @@ void GetInputSamples(PB_TYPE& pb, s16* samples, u16 count, const s16* coeffs)
 
   if (coeffs)
     coeffs += pb.coef_select * 0x200;
-  u32 curr_pos =
-      ResampleAudio([](u32) { return AcceleratorGetSample(); }, samples, count, pb.src.last_samples,
-                    pb.src.cur_addr_frac, HILO_TO_32(pb.src.ratio), pb.src_type, coeffs);
+
+  // Work out how many input samples the resampler is going to consume, and
+  // decode all of them up front. The accelerator is only ever read
+  // sequentially, so this is equivalent to decoding on demand, but it keeps
+  // the resampling loop free of accelerator calls.
+  const u32 ratio = HILO_TO_32(pb.src.ratio);
+  u64 input_count = count;
+  if (pb.src_type == SRCTYPE_LINEAR || pb.src_type == SRCTYPE_POLYPHASE)
+    input_count = (u64{pb.src.cur_addr_frac} + u64{ratio} * count) >> 16;
+
+  u32 curr_pos;
+  std::array<s16, 8 * MAX_SAMPLES_PER_FRAME> input;
+  if (input_count <= input.size())
+  {
+    for (u32 i = 0; i < input_count; ++i)
+      input[i] = AcceleratorGetSample();
+    curr_pos = ResampleAudio([&input](u32 i) { return input[i]; }, samples, count,
+                             pb.src.last_samples, pb.src.cur_addr_frac, ratio, pb.src_type, coeffs);
+  }
+  else
+  {
+    // Extremely high ratios: decode as we go instead.
+    curr_pos = ResampleAudio([](u32) { return AcceleratorGetSample(); }, samples, count,
+                             pb.src.last_samples, pb.src.cur_addr_frac, ratio, pb.src_type, coeffs);
+  }
   pb.src.cur_addr_frac = (curr_pos & 0xFFFF);
 
   // Update current position, YN1, YN2 and pred scale in the PB.
@@ -360,30 +403,80 @@ void GetInputSamples(PB_TYPE& pb, s16* samples, u16 count, const s16* coeffs)
   pb.adpcm.pred_scale = s_accelerator->GetPredScale();
 }
 
+// Multiplies samples by a 1.15 fixed point volume, adding volume_delta to the
+// volume after each sample. output may be the same buffer as input.
+void ApplyVolume(s16* output, const s16* input, u32 count, u16& volume, u16 volume_delta)
+{
+  u32 i = 0;
+
+#ifdef _M_X86
+  // A s16 * u16 product always fits in 32 bits, so it can be built from the
+  // 16-bit low and high halves. PMULHW treats the volume as signed, which is
+  // corrected for by adding the sample back whenever the volume's top bit is
+  // set. PACKSSDW then saturates to [-32768, 32767], leaving only the lower
+  // bound of the clamp to apply.
+  const __m128i lane_index = _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7);
+  const __m128i min_sample = _mm_set1_epi16(-32767);
+  const __m128i delta8 = _mm_set1_epi16(static_cast<s16>(volume_delta * 8));
+  __m128i volumes = _mm_add_epi16(_mm_set1_epi16(static_cast<s16>(volume)),
+                                  _mm_mullo_epi16(lane_index, _mm_set1_epi16(volume_delta)));
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+    const __m128i lo = _mm_mullo_epi16(in, volumes);
+    const __m128i hi = _mm_add_epi16(_mm_mulhi_epi16(in, volumes),
+                                     _mm_and_si128(in, _mm_srai_epi16(volumes, 15)));
+    const __m128i prod_lo = _mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 15);
+    const __m128i prod_hi = _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 15);
+    const __m128i result = _mm_max_epi16(_mm_packs_epi32(prod_lo, prod_hi), min_sample);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), result);
+
+    volumes = _mm_add_epi16(volumes, delta8);
+    volume += volume_delta * 8;
+  }
+#endif
+
+  for (; i < count; ++i)
+  {
+    s64 sample = input[i];
+    sample *= volume;
+    sample >>= 15;
+    output[i] = std::clamp((s32)sample, -32767, 32767);  // -32768 ?
+    volume += volume_delta;
+  }
+}
+
 // Add samples to an output buffer, with optional volume ramping.
 void MixAdd(int* out, const s16* input, u32 count, u16* pvol, s16* dpop, bool ramp)
 {
-  u16& volume = pvol[0];
-  u16 volume_delta = pvol[1];
+  if (count == 0)
+    return;
 
   // If volume ramping is disabled, set volume_delta to 0. That way, the
   // mixing loop can avoid testing if volume ramping is enabled at each step,
   // and just add volume_delta.
-  if (!ramp)
-    volume_delta = 0;
+  const u16 volume_delta = ramp ? pvol[1] : 0;
 
-  for (u32 i = 0; i < count; ++i)
-  {
-    s64 sample = input[i];
-    sample *= volume;
-    sample >>= 15;
-    sample = std::clamp((s32)sample, -32767, 32767);  // -32768 ?
-
-    out[i] += (s16)sample;
-    volume += volume_delta;
+  s16 scaled[MAX_SAMPLES_PER_FRAME];
+  ApplyVolume(scaled, input, count, pvol[0], volume_delta);
 
-    *dpop = (s16)sample;
+  u32 i = 0;
+#ifdef _M_X86
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(scaled + i));
+    // Sign extend to 32 bits by placing each sample in the upper half and shifting it back down.
+    const __m128i samples_lo = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+    const __m128i samples_hi = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+    __m128i* dst = reinterpret_cast<__m128i*>(out + i);
+    _mm_storeu_si128(dst, _mm_add_epi32(_mm_loadu_si128(dst), samples_lo));
+    _mm_storeu_si128(dst + 1, _mm_add_epi32(_mm_loadu_si128(dst + 1), samples_hi));
   }
+#endif
+  for (; i < count; ++i)
+    out[i] += scaled[i];
+
+  *dpop = scaled[count - 1];
 }
 
 // Execute a low pass filter on the samples using one history value. Returns
@@ -409,12 +502,8 @@ void ProcessVoice(PB_TYPE& pb, const AXBuffers& buffers, u16 count, AXMixControl
   GetInputSamples(pb, samples, count, coeffs);
 
   // Apply a global volume ramp using the volume envelope parameters.
-  for (u32 i = 0; i < count; ++i)
-  {
-    samples[i] = std::clamp(((s32)samples[i] * pb.vol_env.cur_volume) >> 15, -32767,
-                            32767);  // -32768 ?
-    pb.vol_env.cur_volume += pb.vol_env.cur_volume_delta;
-  }
+  ApplyVolume(samples, samples, count, pb.vol_env.cur_volume,
+              static_cast<u16>(pb.vol_env.cur_volume_delta));
 
   // Optionally, execute a low pass filter
   if (pb.lpf.enabled)
@@ -528,6 +617,90 @@ void ProcessVoice(PB_TYPE& pb, const AXBuffers& buffers, u16 count, AXMixControl
 #endif
 }
 
+// Processes a linked list of PBs starting at pb_addr.
+//
+// process_pb(addr, buffers) processes a single PB and returns the address of the next one.
+// get_next_pb(addr) returns the address of the PB following the one at addr without processing
+// it, or std::nullopt if that PB must not be processed out of order.
+//
+// When a worker pool is given and the list is long enough, it is split into contiguous shards
+// which are processed in parallel. The first worker mixes directly into the output buffers, the
+// others into zeroed private buffers which are then added in worker order. Since mixing only
+// ever adds to the buffers, the result is the same as when processing the list serially.
+template <typename GetNextPB, typename ProcessPB>
+void ProcessPBs(AXWorkerPool* pool, u32 pb_addr, const AXBuffers& buffers, GetNextPB get_next_pb,
+                ProcessPB process_pb)
+{
+  constexpr u32 MAX_PARALLEL_PBS = 256;
+  constexpr u32 MIN_PBS_PER_WORKER = 4;
+
+  if (pool)
+  {
+    std::array<u32, MAX_PARALLEL_PBS> pbs;
+    u32 num_pbs = 0;
+    bool can_shard = true;
+    for (u32 addr = pb_addr; addr;)
+    {
+      if (num_pbs == pbs.size())
+      {
+        can_shard = false;
+        break;
+      }
+      pbs[num_pbs++] = addr;
+
+      const std::optional<u32> next = get_next_pb(addr);
+      if (!next)
+      {
+        can_shard = false;
+        break;
+      }
+      addr = *next;
+    }
+
+    const u32 num_workers = pool->GetWorkerCount();
+    if (can_shard && num_pbs >= num_workers * MIN_PBS_PER_WORKER)
+    {
+      u32 private_size = 0;
+      for (size_t i = 0; i < std::size(buffers.ptrs); ++i)
+        private_size += GetAXBufferSize(i);
+
+      std::vector<int> private_buffers((num_workers - 1) * private_size, 0);
+
+      pool->Run([&](u32 worker) {
+        AXBuffers worker_buffers = buffers;
+        if (worker != 0)
+        {
+          int* ptr = private_buffers.data() + (worker - 1) * private_size;
+          for (size_t i = 0; i < std::size(worker_buffers.ptrs); ++i)
+          {
+            worker_buffers.ptrs[i] = ptr;
+            ptr += GetAXBufferSize(i);
+          }
+        }
+
+        const u32 end = num_pbs * (worker + 1) / num_workers;
+        for (u32 i = num_pbs * worker / num_workers; i < end; ++i)
+          process_pb(pbs[i], worker_buffers);
+      });
+
+      const int* src = private_buffers.data();
+      for (u32 worker = 1; worker < num_workers; ++worker)
+      {
+        for (size_t i = 0; i < std::size(buffers.ptrs); ++i)
+        {
+          int* dst = buffers.ptrs[i];
+          for (u32 j = 0; j < GetAXBufferSize(i); ++j)
+            dst[j] += *src++;
+        }
+      }
+      return;
+    }
+  }
+
+  while (pb_addr)
+    pb_addr = process_pb(pb_addr, buffers);
+}
+
 }  // namespace
 }  // inline namespace AXGC/AXWii
 }  // namespace DSP::HLE
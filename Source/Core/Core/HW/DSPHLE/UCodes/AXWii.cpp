@@ -7,6 +7,7 @@
 
 #include <algorithm>
 #include <array>
+#include <optional>
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
@@ -449,19 +450,20 @@ void AXWiiUCode::ProcessPBList(u32 pb_addr)
   // 32KHz to 48KHz, but AX always process at 32KHz.
   constexpr u32 spms = 32;
 
-  AXPBWii pb;
+  // Old AXWii versions apply updates and forward the Wiimote buffers per ms, so they always
+  // process the list serially.
+  const auto get_next_pb = [this](u32 addr) -> std::optional<u32> {
+    if (m_old_axwii)
+      return std::nullopt;
 
-  while (pb_addr)
-  {
-    AXBuffers buffers = {{m_samples_left,      m_samples_right,      m_samples_surround,
-                          m_samples_auxA_left, m_samples_auxA_right, m_samples_auxA_surround,
-                          m_samples_auxB_left, m_samples_auxB_right, m_samples_auxB_surround,
-                          m_samples_auxC_left, m_samples_auxC_right, m_samples_auxC_surround,
-                          m_samples_wm0,       m_samples_aux0,       m_samples_wm1,
-                          m_samples_aux1,      m_samples_wm2,        m_samples_aux2,
-                          m_samples_wm3,       m_samples_aux3}};
+    AXPBWii pb;
+    ReadPB(addr, pb, m_crc);
+    return HILO_TO_32(pb.next_pb);
+  };
 
-    ReadPB(pb_addr, pb, m_crc);
+  const auto process_pb = [this](u32 addr, AXBuffers buffers) -> u32 {
+    AXPBWii pb;
+    ReadPB(addr, pb, m_crc);
 
     u16 num_updates[3];
     u16 updates[1024];
@@ -486,9 +488,19 @@ void AXWiiUCode::ProcessPBList(u32 pb_addr)
                    m_coeffs_available ? m_coeffs : nullptr);
     }
 
-    WritePB(pb_addr, pb, m_crc);
-    pb_addr = HILO_TO_32(pb.next_pb);
-  }
+    WritePB(addr, pb, m_crc);
+    return HILO_TO_32(pb.next_pb);
+  };
+
+  const AXBuffers buffers = {{m_samples_left,      m_samples_right,      m_samples_surround,
+                              m_samples_auxA_left, m_samples_auxA_right, m_samples_auxA_surround,
+                              m_samples_auxB_left, m_samples_auxB_right, m_samples_auxB_surround,
+                              m_samples_auxC_left, m_samples_auxC_right, m_samples_auxC_surround,
+                              m_samples_wm0,       m_samples_aux0,       m_samples_wm1,
+                              m_samples_aux1,      m_samples_wm2,        m_samples_aux2,
+                              m_samples_wm3,       m_samples_aux3}};
+
+  ProcessPBs(m_worker_pool.get(), pb_addr, buffers, get_next_pb, process_pb);
 }
 
 void AXWiiUCode::MixAUXSamples(int aux_id, u32 write_addr, u32 read_addr, u16 volume)
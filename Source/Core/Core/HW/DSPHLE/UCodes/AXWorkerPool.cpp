@@ -0,0 +1,42 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Core/HW/DSPHLE/UCodes/AXWorkerPool.h"
+
+namespace DSP::HLE
+{
+AXWorkerPool::AXWorkerPool(u32 num_threads)
+{
+  m_threads.reserve(num_threads);
+  for (u32 i = 0; i < num_threads; ++i)
+  {
+    m_threads.push_back(std::make_unique<Common::WorkQueueThread<u32>>(
+        [this](u32 index) { WorkerFunction(index); }));
+  }
+}
+
+AXWorkerPool::~AXWorkerPool() = default;
+
+void AXWorkerPool::Run(const std::function<void(u32)>& job)
+{
+  m_job = &job;
+  m_pending.store(static_cast<u32>(m_threads.size()));
+
+  for (u32 i = 0; i < m_threads.size(); ++i)
+    m_threads[i]->EmplaceItem(i + 1);
+
+  job(0);
+
+  if (!m_threads.empty())
+    m_done.Wait();
+  m_job = nullptr;
+}
+
+void AXWorkerPool::WorkerFunction(u32 index)
+{
+  (*m_job)(index);
+
+  if (m_pending.fetch_sub(1) == 1)
+    m_done.Set();
+}
+}  // namespace DSP::HLE
@@ -0,0 +1,41 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Event.h"
+#include "Common/WorkQueueThread.h"
+
+namespace DSP::HLE
+{
+// A small fork/join pool used by the AX ucodes to process voices in parallel.
+// Run() calls the job once per worker, with the worker index as argument, and
+// returns once all of them are done. Worker 0 always runs on the calling thread.
+class AXWorkerPool
+{
+public:
+  explicit AXWorkerPool(u32 num_threads);
+  ~AXWorkerPool();
+
+  AXWorkerPool(const AXWorkerPool&) = delete;
+  AXWorkerPool& operator=(const AXWorkerPool&) = delete;
+
+  u32 GetWorkerCount() const { return static_cast<u32>(m_threads.size()) + 1; }
+
+  void Run(const std::function<void(u32)>& job);
+
+private:
+  void WorkerFunction(u32 index);
+
+  std::vector<std::unique_ptr<Common::WorkQueueThread<u32>>> m_threads;
+  const std::function<void(u32)>* m_job = nullptr;
+  std::atomic<u32> m_pending{0};
+  Common::Event m_done;
+};
+}  // namespace DSP::HLE
@@ -5,8 +5,13 @@
 
 #include <algorithm>
 #include <array>
+#include <cstdint>
 #include <map>
 
+#ifdef _M_X86
+#include <emmintrin.h>
+#endif
+
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
@@ -963,6 +968,211 @@ struct ReverbPB
 };
 #pragma pack(pop)
 
+#ifdef _M_X86
+// Multiplies signed samples by an unsigned volume. Returns the full 32-bit products of the first
+// and last four samples.
+static void MultiplyByVolume(__m128i samples, u16 vol, __m128i* products_lo, __m128i* products_hi)
+{
+  const __m128i volume = _mm_set1_epi16(static_cast<s16>(vol));
+  const __m128i low = _mm_mullo_epi16(samples, volume);
+  __m128i high = _mm_mulhi_epi16(samples, volume);
+  // mulhi treats the volume as signed, which makes volumes from 0x8000 up 0x10000 too small.
+  if (vol >= 0x8000)
+    high = _mm_add_epi16(high, samples);
+  *products_lo = _mm_unpacklo_epi16(low, high);
+  *products_hi = _mm_unpackhi_epi16(low, high);
+}
+#endif
+
+void ZeldaAudioRenderer::ApplyVolumeInPlace(s16* buf, size_t count, u16 vol, u32 int_bits)
+{
+  const u32 shift = 16 - int_bits;
+  size_t i = 0;
+#ifdef _M_X86
+  const __m128i shift_count = _mm_cvtsi32_si128(static_cast<int>(shift));
+  for (; i < (count & ~size_t{7}); i += 8)
+  {
+    __m128i* samples = reinterpret_cast<__m128i*>(buf + i);
+    __m128i lo, hi;
+    MultiplyByVolume(_mm_loadu_si128(samples), vol, &lo, &hi);
+    // Packing clamps the results.
+    _mm_storeu_si128(samples, _mm_packs_epi32(_mm_sra_epi32(lo, shift_count),
+                                              _mm_sra_epi32(hi, shift_count)));
+  }
+#endif
+  for (; i < count; ++i)
+  {
+    s32 tmp = (u32)buf[i] * (u32)vol;
+    tmp >>= shift;
+
+    buf[i] = (s16)std::clamp(tmp, -0x8000, 0x7FFF);
+  }
+}
+
+s32 ZeldaAudioRenderer::AddBuffersWithVolumeRamp(s16* dst, const s16* src, size_t count, s32 vol,
+                                                 s32 step)
+{
+  if (!vol && !step)
+    return vol;
+
+  size_t i = 0;
+#ifdef _M_X86
+  // Each lane has its own volume, ahead of the previous lane by one step.
+  const u32 vol_u = static_cast<u32>(vol);
+  const u32 step_u = static_cast<u32>(step);
+  __m128i volumes_lo =
+      _mm_setr_epi32(vol_u, vol_u + step_u, vol_u + 2 * step_u, vol_u + 3 * step_u);
+  __m128i volumes_hi = _mm_add_epi32(volumes_lo, _mm_set1_epi32(4 * step_u));
+  const __m128i step8 = _mm_set1_epi32(8 * step_u);
+  for (; i < (count & ~size_t{7}); i += 8)
+  {
+    // The integer parts of the volumes fit in 16 bits, so packing doesn't clamp them.
+    const __m128i volumes =
+        _mm_packs_epi32(_mm_srai_epi32(volumes_lo, 16), _mm_srai_epi32(volumes_hi, 16));
+    const __m128i samples =
+        _mm_mulhi_epi16(volumes, _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+    __m128i* out = reinterpret_cast<__m128i*>(dst + i);
+    _mm_storeu_si128(out, _mm_add_epi16(_mm_loadu_si128(out), samples));
+
+    volumes_lo = _mm_add_epi32(volumes_lo, step8);
+    volumes_hi = _mm_add_epi32(volumes_hi, step8);
+  }
+  vol = static_cast<s32>(vol_u + static_cast<u32>(i) * step_u);
+#endif
+  for (; i < count; ++i)
+  {
+    dst[i] += ((vol >> 16) * src[i]) >> 16;
+    vol += step;
+  }
+
+  return vol;
+}
+
+void ZeldaAudioRenderer::AddBuffersWithVolume(s16* dst, const s16* src, size_t count, u16 vol)
+{
+  size_t i = 0;
+#ifdef _M_X86
+  for (; i < (count & ~size_t{7}); i += 8)
+  {
+    __m128i lo, hi;
+    MultiplyByVolume(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), vol, &lo, &hi);
+    const __m128i samples = _mm_packs_epi32(_mm_srai_epi32(lo, 15), _mm_srai_epi32(hi, 15));
+    __m128i* out = reinterpret_cast<__m128i*>(dst + i);
+    _mm_storeu_si128(out, _mm_add_epi16(_mm_loadu_si128(out), samples));
+  }
+#endif
+  for (; i < count; ++i)
+  {
+    s32 vol_src = ((s32)src[i] * (s32)vol) >> 15;
+    dst[i] += std::clamp(vol_src, -0x8000, 0x7FFF);
+  }
+}
+
+void ZeldaAudioRenderer::ApplyReverbFilter(s16* buf, size_t count, const s16* coeffs)
+{
+  // Each output sample only depends on input samples at or after its own
+  // position, so the buffer can be filtered in place from front to back.
+  size_t i = 0;
+#ifdef _M_X86
+  const __m128i taps = _mm_loadu_si128(reinterpret_cast<const __m128i*>(coeffs));
+  for (; i < (count & ~size_t{3}); i += 4)
+  {
+    const __m128i m0 =
+        _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + i)), taps);
+    const __m128i m1 =
+        _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + i + 1)), taps);
+    const __m128i m2 =
+        _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + i + 2)), taps);
+    const __m128i m3 =
+        _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + i + 3)), taps);
+
+    // Horizontal sums of m0..m3.
+    const __m128i m01 = _mm_add_epi32(_mm_unpacklo_epi32(m0, m1), _mm_unpackhi_epi32(m0, m1));
+    const __m128i m23 = _mm_add_epi32(_mm_unpacklo_epi32(m2, m3), _mm_unpackhi_epi32(m2, m3));
+    const __m128i sums = _mm_add_epi32(_mm_unpacklo_epi64(m01, m23), _mm_unpackhi_epi64(m01, m23));
+
+    const __m128i samples = _mm_srai_epi32(sums, 15);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(buf + i), _mm_packs_epi32(samples, samples));
+  }
+#endif
+  for (; i < count; ++i)
+  {
+    s32 sample = 0;
+    for (u16 j = 0; j < 8; ++j)
+      sample += (s32)buf[i + j] * coeffs[j];
+    sample >>= 15;
+    buf[i] = std::clamp(sample, -0x8000, 0x7FFF);
+  }
+}
+
+u32 ZeldaAudioRenderer::ResampleInterpolated(s16* dst, size_t count, const s16* src, u32 pos,
+                                             u32 ratio, const s16* coeffs)
+{
+  // We have 0x40 * 4 coeffs that need to be selected based on the
+  // most significant bits of the fractional part of the position. 12
+  // bits >> 6 = 6 bits = 0x40. Multiply by 4 since there are 4
+  // consecutive coeffs.
+  const auto coeffs_for = [coeffs](u32 position) { return &coeffs[((position & 0xFFF) >> 6) * 4]; };
+
+  size_t i = 0;
+#ifdef _M_X86
+  for (; i < (count & ~size_t{3}); i += 4)
+  {
+    __m128i inputs[4];
+    __m128i taps[4];
+    for (size_t j = 0; j < 4; ++j)
+    {
+      inputs[j] = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&src[pos >> 12]));
+      taps[j] = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(coeffs_for(pos)));
+      pos += ratio;
+    }
+    const __m128i m01 = _mm_madd_epi16(_mm_unpacklo_epi64(inputs[0], inputs[1]),
+                                       _mm_unpacklo_epi64(taps[0], taps[1]));
+    const __m128i m23 = _mm_madd_epi16(_mm_unpacklo_epi64(inputs[2], inputs[3]),
+                                       _mm_unpacklo_epi64(taps[2], taps[3]));
+    // The sums of the first two and of the last two products of each sample.
+    const __m128 m01_ps = _mm_castsi128_ps(m01);
+    const __m128 m23_ps = _mm_castsi128_ps(m23);
+    const __m128i first = _mm_castps_si128(_mm_shuffle_ps(m01_ps, m23_ps, _MM_SHUFFLE(2, 0, 2, 0)));
+    const __m128i last = _mm_castps_si128(_mm_shuffle_ps(m01_ps, m23_ps, _MM_SHUFFLE(3, 1, 3, 1)));
+
+    // The whole sum can take up to 33 bits, so add up the halves after
+    // shifting them, and carry the bits shifted out separately. The halves
+    // themselves are exact, except for 2 * -0x8000 * -0x8000, which wraps
+    // around to -0x80000000 (a value they can't have otherwise).
+    const __m128i wrapped_fix = _mm_set1_epi32(0x20000);
+    const __m128i min = _mm_set1_epi32(INT32_MIN);
+    const __m128i fraction_mask = _mm_set1_epi32(0x7FFF);
+    const __m128i first_shifted = _mm_add_epi32(
+        _mm_srai_epi32(first, 15), _mm_and_si128(_mm_cmpeq_epi32(first, min), wrapped_fix));
+    const __m128i last_shifted = _mm_add_epi32(
+        _mm_srai_epi32(last, 15), _mm_and_si128(_mm_cmpeq_epi32(last, min), wrapped_fix));
+    const __m128i carry = _mm_srli_epi32(
+        _mm_add_epi32(_mm_and_si128(first, fraction_mask), _mm_and_si128(last, fraction_mask)),
+        15);
+    const __m128i samples = _mm_add_epi32(_mm_add_epi32(first_shifted, last_shifted), carry);
+
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(samples, samples));
+  }
+#endif
+  for (; i < count; ++i)
+  {
+    const s16* sample_coeffs = coeffs_for(pos);
+    const s16* input = &src[pos >> 12];
+
+    s64 dst_sample_unclamped = 0;
+    for (size_t j = 0; j < 4; ++j)
+      dst_sample_unclamped += (s64)2 * sample_coeffs[j] * input[j];
+    dst_sample_unclamped >>= 16;
+
+    dst[i] = (s16)std::clamp<s64>(dst_sample_unclamped, -0x8000, 0x7FFF);
+
+    pos += ratio;
+  }
+
+  return pos;
+}
+
 void ZeldaAudioRenderer::PrepareFrame()
 {
   if (m_prepared)
@@ -1076,17 +1286,11 @@ void ZeldaAudioRenderer::ApplyReverb(bool post_rendering)
       for (u16 i = 0; i < 8; ++i)
         (*last8_samples_buffers[rpb_idx])[i] = buffer[0x50 + i];
 
-      auto ApplyFilter = [&]() {
-        // Filter the buffer using provided coefficients.
-        for (u16 i = 0; i < 0x50; ++i)
-        {
-          s32 sample = 0;
-          for (u16 j = 0; j < 8; ++j)
-            sample += (s32)buffer[i + j] * rpb.filter_coeffs[j];
-          sample >>= 15;
-          buffer[i] = std::clamp(sample, -0x8000, 0x7FFF);
-        }
-      };
+      // Filter the buffer using provided coefficients.
+      std::array<s16, 8> filter_coeffs;
+      for (size_t i = 0; i < filter_coeffs.size(); ++i)
+        filter_coeffs[i] = rpb.filter_coeffs[i];
+      auto ApplyFilter = [&]() { ApplyReverbFilter(buffer.data(), 0x50, filter_coeffs.data()); };
 
       // LSB set -> pre-filtering.
       if (rpb.enabled & 1)
@@ -1509,25 +1713,8 @@ void ZeldaAudioRenderer::Resample(VPB* vpb, const s16* src, MixingBuffer* dst)
   }
   else
   {
-    for (auto& dst_sample : *dst)
-    {
-      // We have 0x40 * 4 coeffs that need to be selected based on the
-      // most significant bits of the fractional part of the position. 12
-      // bits >> 6 = 6 bits = 0x40. Multiply by 4 since there are 4
-      // consecutive coeffs.
-      u32 coeffs_idx = ((pos & 0xFFF) >> 6) * 4;
-      const s16* coeffs = &m_resampling_coeffs[coeffs_idx];
-      const s16* input = &src[pos >> 12];
-
-      s64 dst_sample_unclamped = 0;
-      for (size_t i = 0; i < 4; ++i)
-        dst_sample_unclamped += (s64)2 * coeffs[i] * input[i];
-      dst_sample_unclamped >>= 16;
-
-      dst_sample = (s16)std::clamp<s64>(dst_sample_unclamped, -0x8000, 0x7FFF);
-
-      pos += ratio;
-    }
+    pos = ResampleInterpolated(dst->data(), dst->size(), src, pos, ratio,
+                               m_resampling_coeffs.data());
   }
 
   for (u32 i = 0; i < 4; ++i)
@@ -3,6 +3,8 @@
 
 #include "Core/HW/DSPLLE/DSPLLE.h"
 
+#include <algorithm>
+#include <chrono>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -15,6 +17,7 @@
 #include "Common/Logging/Log.h"
 #include "Common/MemoryUtil.h"
 #include "Common/Thread.h"
+#include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/DSP/DSPAccelerator.h"
@@ -33,8 +36,8 @@ DSPLLE::DSPLLE() = default;
 
 DSPLLE::~DSPLLE()
 {
-  m_dsp_core.Shutdown();
   DSP_StopSoundStream();
+  m_dsp_core.Shutdown();
 }
 
 void DSPLLE::DoState(PointerWrap& p)
@@ -59,7 +62,7 @@ void DSPLLE::DSPThread(DSPLLE* dsp_lle)
 
   while (dsp_lle->m_is_running.IsSet())
   {
-    const int cycles = static_cast<int>(dsp_lle->m_cycle_count.load());
+    const u32 cycles = dsp_lle->m_cycle_count.load();
     if (cycles > 0)
     {
       std::unique_lock dsp_thread_lock(dsp_lle->m_dsp_thread_mutex, std::try_to_lock);
@@ -67,13 +70,16 @@ void DSPLLE::DSPThread(DSPLLE* dsp_lle)
       {
         if (dsp_lle->m_dsp_core.IsJITCreated())
         {
-          dsp_lle->m_dsp_core.RunCycles(cycles);
+          dsp_lle->m_dsp_core.RunCycles(static_cast<int>(cycles));
         }
         else
         {
-          dsp_lle->m_dsp_core.GetInterpreter().RunCyclesThread(cycles);
+          dsp_lle->m_dsp_core.GetInterpreter().RunCyclesThread(static_cast<int>(cycles));
         }
-        dsp_lle->m_cycle_count.store(0);
+        // The CPU thread may have queued more cycles in the meantime, so only
+        // retire the ones we actually ran.
+        dsp_lle->m_cycle_count.fetch_sub(cycles);
+        dsp_lle->m_ppc_event.Set();
         continue;
       }
     }
@@ -149,6 +155,8 @@ bool DSPLLE::Initialize(bool wii, bool dsp_thread)
 
   m_wii = wii;
   m_is_dsp_on_thread = dsp_thread;
+  m_max_skew_cycles = static_cast<u32>(std::max(Config::Get(Config::MAIN_DSP_THREAD_MAX_SKEW), 0));
+  m_thread_stats = {};
 
   m_dsp_core.Reset();
 
@@ -166,22 +174,51 @@ bool DSPLLE::Initialize(bool wii, bool dsp_thread)
 
 void DSPLLE::DSP_StopSoundStream()
 {
-  if (!m_is_dsp_on_thread)
+  if (!m_is_dsp_on_thread || !m_dsp_thread.joinable())
     return;
 
   m_is_running.Clear();
   m_ppc_event.Set();
   m_dsp_event.Set();
   m_dsp_thread.join();
+
+  INFO_LOG_FMT(DSPLLE, "DSP thread stopped: the CPU stalled {} times for a total of {} us",
+               m_thread_stats.stall_count, m_thread_stats.stall_time_us);
+}
+
+void DSPLLE::WaitForDSPThread(u32 max_pending_cycles)
+{
+  if (!m_is_dsp_on_thread || !m_is_running.IsSet() || m_cycle_count.load() <= max_pending_cycles)
+    return;
+
+  const auto start = std::chrono::steady_clock::now();
+  do
+  {
+    m_dsp_event.Set();
+    m_ppc_event.Wait();
+  } while (m_cycle_count.load() > max_pending_cycles && m_is_running.IsSet());
+
+  const auto stall_time = std::chrono::steady_clock::now() - start;
+  ++m_thread_stats.stall_count;
+  m_thread_stats.stall_time_us +=
+      std::chrono::duration_cast<std::chrono::microseconds>(stall_time).count();
 }
 
 void DSPLLE::Shutdown()
 {
+  // The thread must not run the core while it is being torn down.
+  DSP_StopSoundStream();
   m_dsp_core.Shutdown();
 }
 
+// The CPU polls the mailboxes and the control register in loops while it waits for the DSP, so
+// reading them only brings the DSP thread within half of m_max_skew_cycles instead of draining its
+// queue, which would stall every iteration. Control register writes reset, halt or interrupt the
+// DSP, so those only happen once the DSP thread has caught up completely.
 u16 DSPLLE::DSP_WriteControlRegister(u16 value)
 {
+  WaitForDSPThread(0);
+
   m_dsp_core.GetInterpreter().WriteCR(value);
 
   if ((value & CR_EXTERNAL_INT) != 0)
@@ -206,16 +243,22 @@ u16 DSPLLE::DSP_WriteControlRegister(u16 value)
 
 u16 DSPLLE::DSP_ReadControlRegister()
 {
+  WaitForDSPThread(m_max_skew_cycles / 2);
+
   return m_dsp_core.GetInterpreter().ReadCR();
 }
 
 u16 DSPLLE::DSP_ReadMailBoxHigh(bool cpu_mailbox)
 {
+  WaitForDSPThread(m_max_skew_cycles / 2);
+
   return m_dsp_core.ReadMailboxHigh(cpu_mailbox ? Mailbox::CPU : Mailbox::DSP);
 }
 
 u16 DSPLLE::DSP_ReadMailBoxLow(bool cpu_mailbox)
 {
+  WaitForDSPThread(m_max_skew_cycles / 2);
+
   return m_dsp_core.ReadMailboxLow(cpu_mailbox ? Mailbox::CPU : Mailbox::DSP);
 }
 
@@ -251,7 +294,7 @@ void DSPLLE::DSP_WriteMailBoxLow(bool cpu_mailbox, u16 value)
 
 void DSPLLE::DSP_Update(int cycles)
 {
-  const int dsp_cycles = cycles / 6;
+  int dsp_cycles = cycles / 6;
 
   if (dsp_cycles <= 0)
     return;
@@ -264,6 +307,9 @@ void DSPLLE::DSP_Update(int cycles)
       m_is_dsp_on_thread = false;
       m_request_disable_thread = false;
       SConfig::GetInstance().bDSPThread = false;
+
+      // Run whatever the thread did not get to before it stopped.
+      dsp_cycles += static_cast<int>(m_cycle_count.exchange(0));
     }
   }
 
@@ -275,10 +321,11 @@ void DSPLLE::DSP_Update(int cycles)
   }
   else
   {
-    // Wait for DSP thread to complete its cycle. Note: this logic should be thought through.
-    m_ppc_event.Wait();
+    // Let the DSP thread run ahead on its own, and only block once it falls
+    // too far behind the CPU.
     m_cycle_count.fetch_add(dsp_cycles);
     m_dsp_event.Set();
+    WaitForDSPThread(m_max_skew_cycles);
   }
 }
 
@@ -300,7 +347,6 @@ void DSPLLE::PauseAndLock(bool do_lock, bool unpause_on_unlock)
     if (m_is_dsp_on_thread)
     {
       // Signal the DSP thread so it can perform any outstanding work now (if any)
-      m_ppc_event.Wait();
       m_dsp_event.Set();
     }
   }
@@ -38,9 +38,24 @@ public:
   void DSP_StopSoundStream() override;
   u32 DSP_UpdateRate() override;
 
+  // Number of cycles queued for the DSP thread that it hasn't run yet.
+  u32 GetPendingCycles() const { return m_cycle_count.load(); }
+
+  // Time the CPU thread spent waiting for the DSP thread to catch up.
+  struct ThreadStats
+  {
+    u64 stall_count = 0;
+    u64 stall_time_us = 0;
+  };
+  ThreadStats GetThreadStats() const { return m_thread_stats; }
+
 private:
   static void DSPThread(DSPLLE* dsp_lle);
 
+  // Blocks until the DSP thread has at most max_pending_cycles cycles left to run.
+  // Does nothing when the DSP is not running on its own thread.
+  void WaitForDSPThread(u32 max_pending_cycles);
+
   DSPCore m_dsp_core;
   std::thread m_dsp_thread;
   std::mutex m_dsp_thread_mutex;
@@ -51,5 +66,9 @@ private:
   Common::Event m_dsp_event;
   Common::Event m_ppc_event;
   bool m_request_disable_thread = false;
+
+  // How many cycles the DSP thread may lag behind the CPU before the CPU blocks.
+  u32 m_max_skew_cycles = 0;
+  ThreadStats m_thread_stats;
 };
 }  // namespace DSP::LLE
@@ -3,6 +3,8 @@
 
 #include "Core/HW/DVD/DVDThread.h"
 
+#include <algorithm>
+#include <chrono>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -21,6 +23,7 @@
 #include "Common/Thread.h"
 #include "Common/Timer.h"
 
+#include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
@@ -43,6 +46,10 @@ struct ReadRequest
   u32 length;
   DiscIO::Partition partition;
 
+  // Set by the DVD thread instead of filling in the result buffer when the data can be copied
+  // straight out of a memory mapped disc image. Always nullptr in savestates.
+  const u8* mapped_data;
+
   // This determines which code DVDInterface will run to reply
   // to the emulated software. We can't use callbacks,
   // because function pointers can't be stored in savestates.
@@ -66,6 +73,11 @@ static void StopDVDThread();
 
 static void DVDThread();
 static void WaitUntilIdle();
+static void CopyMappedResultsToBuffers();
+
+static void UpdatePrefetchWindow(std::optional<size_t> accessed_index);
+static bool HasPrefetchWork();
+static void PrefetchChunk(std::vector<u8>* buffer);
 
 static void StartReadInternal(bool copy_to_ram, u32 output_address, u64 dvd_offset, u32 length,
                               const DiscIO::Partition& partition,
@@ -87,6 +99,19 @@ static std::map<u64, ReadResult> s_result_map;
 
 static std::unique_ptr<DiscIO::Volume> s_disc;
 
+// When prefetching is enabled, the DVD thread records which files the game reads and uses the
+// recording from previous sessions to read upcoming files while it would otherwise be idle.
+// This warms up the host's page cache, which helps the most with slow or networked storage.
+constexpr u64 PREFETCH_CHUNK_SIZE = 0x40000;
+constexpr u64 PREFETCH_MAX_FILE_SIZE = 0x1000000;
+constexpr size_t PREFETCH_LOOKAHEAD_FILES = 16;
+
+static bool s_prefetch_enabled = false;
+static FileMonitor::AccessProfile s_access_profile;
+static size_t s_prefetch_index;
+static u64 s_prefetch_offset;
+static size_t s_prefetch_end;
+
 void Start()
 {
   s_finish_read = CoreTiming::RegisterEvent("FinishReadDVDThread", FinishRead);
@@ -113,6 +138,9 @@ static void StartDVDThread()
 void Stop()
 {
   StopDVDThread();
+  s_result_map.clear();
+  s_access_profile.Save();
+  s_access_profile.Clear();
   s_disc.reset();
 }
 
@@ -138,10 +166,9 @@ void DoState(PointerWrap& p)
 
   // Move all results from s_result_queue to s_result_map because
   // PointerWrap::Do supports std::map but not Common::SPSCQueue.
-  // This won't affect the behavior of FinishRead.
-  ReadResult result;
-  while (s_result_queue.Pop(result))
-    s_result_map.emplace(result.first.id, std::move(result));
+  // This won't affect the behavior of FinishRead. Pointers into the
+  // disc image can't be savestated, so that data gets copied too.
+  CopyMappedResultsToBuffers();
 
   // Both queues are now empty, so we don't need to savestate them.
   p.Do(s_result_map);
@@ -176,7 +203,20 @@ void DoState(PointerWrap& p)
 void SetDisc(std::unique_ptr<DiscIO::Volume> disc)
 {
   WaitUntilIdle();
+  // Results that haven't been consumed yet may point into the old disc's mapping
+  CopyMappedResultsToBuffers();
+  s_access_profile.Save();
   s_disc = std::move(disc);
+
+  s_prefetch_enabled = s_disc && Config::Get(Config::MAIN_DVD_PREFETCH);
+  if (s_prefetch_enabled)
+    s_access_profile.Load(*s_disc);
+  else
+    s_access_profile.Clear();
+
+  s_prefetch_index = 0;
+  s_prefetch_offset = 0;
+  s_prefetch_end = 0;
 }
 
 bool HasDisc()
@@ -253,6 +293,23 @@ void WaitUntilIdle()
   StartDVDThread();
 }
 
+static void CopyMappedResultsToBuffers()
+{
+  ReadResult result;
+  while (s_result_queue.Pop(result))
+    s_result_map.emplace(result.first.id, std::move(result));
+
+  for (auto& [id, map_result] : s_result_map)
+  {
+    ReadRequest& request = map_result.first;
+    if (!request.mapped_data)
+      continue;
+
+    map_result.second.assign(request.mapped_data, request.mapped_data + request.length);
+    request.mapped_data = nullptr;
+  }
+}
+
 void StartRead(u64 dvd_offset, u32 length, const DiscIO::Partition& partition,
                DVDInterface::ReplyType reply_type, s64 ticks_until_completion)
 {
@@ -280,6 +337,7 @@ static void StartReadInternal(bool copy_to_ram, u32 output_address, u64 dvd_offs
   request.dvd_offset = dvd_offset;
   request.length = length;
   request.partition = partition;
+  request.mapped_data = nullptr;
   request.reply_type = reply_type;
 
   u64 id = s_next_id++;
@@ -341,7 +399,7 @@ static void FinishRead(u64 id, s64 cycles_late)
                     (SystemTimers::GetTicksPerSecond() / 1000000));
 
   DVDInterface::DIInterruptType interrupt;
-  if (buffer.size() != request.length)
+  if (!request.mapped_data && buffer.size() != request.length)
   {
     PanicAlertFmtT("The disc could not be read (at {0:#x} - {1:#x}).", request.dvd_offset,
                    request.dvd_offset + request.length);
@@ -352,7 +410,10 @@ static void FinishRead(u64 id, s64 cycles_late)
   else
   {
     if (request.copy_to_ram)
-      Memory::CopyToEmu(request.output_address, buffer.data(), request.length);
+    {
+      const u8* data = request.mapped_data ? request.mapped_data : buffer.data();
+      Memory::CopyToEmu(request.output_address, data, request.length);
+    }
 
     interrupt = DVDInterface::DIInterruptType::TCINT;
   }
@@ -361,13 +422,72 @@ static void FinishRead(u64 id, s64 cycles_late)
   DVDInterface::FinishExecutingCommand(request.reply_type, interrupt, cycles_late, buffer);
 }
 
+static void UpdatePrefetchWindow(std::optional<size_t> accessed_index)
+{
+  if (!accessed_index)
+    return;
+
+  // If the game has caught up with the prefetcher, continue from the file after this one
+  if (*accessed_index >= s_prefetch_index)
+  {
+    s_prefetch_index = *accessed_index + 1;
+    s_prefetch_offset = 0;
+  }
+
+  s_prefetch_end = std::max(s_prefetch_end, *accessed_index + 1 + PREFETCH_LOOKAHEAD_FILES);
+}
+
+static bool HasPrefetchWork()
+{
+  return s_prefetch_enabled &&
+         s_prefetch_index < std::min(s_prefetch_end, s_access_profile.GetEntries().size());
+}
+
+static void PrefetchChunk(std::vector<u8>* buffer)
+{
+  const FileMonitor::AccessProfile::Entry& entry = s_access_profile.GetEntries()[s_prefetch_index];
+
+  // Large files (like videos) tend to be streamed, so there's little point in reading all of them
+  const u64 size = std::min(entry.file_size, PREFETCH_MAX_FILE_SIZE);
+  const u64 length = std::min(PREFETCH_CHUNK_SIZE, size - s_prefetch_offset);
+
+  buffer->resize(length);
+  s_disc->Read(entry.file_offset + s_prefetch_offset, length, buffer->data(),
+               DiscIO::Partition(entry.partition_offset));
+
+  s_prefetch_offset += length;
+  if (s_prefetch_offset >= size)
+  {
+    ++s_prefetch_index;
+    s_prefetch_offset = 0;
+  }
+}
+
 static void DVDThread()
 {
   Common::SetCurrentThreadName("DVD thread");
 
+  // WaitUntilIdle restarts this thread before the CPU thread accesses s_disc directly, and the CPU
+  // thread doesn't submit new requests until it's done with s_disc. Not prefetching until a
+  // request has been handled thus ensures that the two threads never use s_disc at the same time.
+  bool may_prefetch = false;
+  std::vector<u8> prefetch_buffer;
+
   while (true)
   {
-    s_request_queue_expanded.Wait();
+    if (may_prefetch && HasPrefetchWork())
+    {
+      // Prefetch in small steps so that requests from the game don't have to wait for long
+      if (!s_request_queue_expanded.WaitFor(std::chrono::milliseconds(0)))
+      {
+        PrefetchChunk(&prefetch_buffer);
+        continue;
+      }
+    }
+    else
+    {
+      s_request_queue_expanded.Wait();
+    }
 
     if (s_dvd_thread_exiting.IsSet())
       return;
@@ -376,15 +496,33 @@ static void DVDThread()
     while (s_request_queue.Pop(request))
     {
       FileMonitor::Log(*s_disc, request.partition, request.dvd_offset);
-
-      std::vector<u8> buffer(request.length);
-      if (!s_disc->Read(request.dvd_offset, request.length, buffer.data(), request.partition))
-        buffer.resize(0);
+      if (s_prefetch_enabled)
+      {
+        UpdatePrefetchWindow(
+            s_access_profile.Record(*s_disc, request.partition, request.dvd_offset));
+      }
+
+      // If the disc image is memory mapped, FinishRead can copy to emulated RAM directly from
+      // the mapping, so the data only gets paged in from the host's page cache once
+      std::vector<u8> buffer;
+      if (request.copy_to_ram)
+      {
+        request.mapped_data =
+            s_disc->GetMappedData(request.dvd_offset, request.length, request.partition);
+      }
+
+      if (!request.mapped_data)
+      {
+        buffer.resize(request.length);
+        if (!s_disc->Read(request.dvd_offset, request.length, buffer.data(), request.partition))
+          buffer.resize(0);
+      }
 
       request.realtime_done_us = Common::Timer::GetTimeUs();
 
       s_result_queue.Push(ReadResult(std::move(request), std::move(buffer)));
       s_result_queue_expanded.Set();
+      may_prefetch = true;
 
       if (s_dvd_thread_exiting.IsSet())
         return;
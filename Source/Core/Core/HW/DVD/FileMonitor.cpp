@@ -12,6 +12,7 @@
 #include <fmt/format.h>
 
 #include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
 #include "Common/Logging/Log.h"
 #include "Common/Logging/LogManager.h"
 #include "Common/StringUtil.h"
@@ -90,4 +91,113 @@ void Log(const DiscIO::Volume& volume, const DiscIO::Partition& partition, u64 o
   s_previous_file_offset = file_offset;
 }
 
+void AccessProfile::Load(const DiscIO::Volume& volume)
+{
+  Clear();
+
+  const DiscIO::Partition partition = volume.GetGamePartition();
+  const std::string game_id = volume.GetGameID(partition);
+  if (game_id.empty())
+    return;
+
+  m_path = fmt::format("{}DVDAccessProfiles/{}_{}_{}.txt", File::GetUserPath(D_CACHE_IDX), game_id,
+                       volume.GetDiscNumber(partition).value_or(0),
+                       volume.GetRevision(partition).value_or(0));
+
+  std::string contents;
+  if (!File::ReadFileToString(m_path, contents))
+    return;
+
+  for (const std::string& line : SplitString(contents, '\n'))
+  {
+    const std::vector<std::string> fields = SplitString(line, ' ');
+    Entry entry;
+    if (fields.size() != 3 || !TryParse(fields[0], &entry.partition_offset, 16) ||
+        !TryParse(fields[1], &entry.file_offset, 16) || !TryParse(fields[2], &entry.file_size, 16))
+    {
+      continue;
+    }
+
+    AddEntry(entry);
+  }
+
+  INFO_LOG_FMT(FILEMON, "Loaded DVD access profile with {} files from {}", m_entries.size(),
+               m_path);
+}
+
+void AccessProfile::Save()
+{
+  if (!m_dirty || m_path.empty())
+    return;
+
+  std::string contents;
+  for (const Entry& entry : m_entries)
+  {
+    contents += fmt::format("{:x} {:x} {:x}\n", entry.partition_offset, entry.file_offset,
+                            entry.file_size);
+  }
+
+  if (!File::CreateFullPath(m_path) || !File::WriteStringToFile(m_path, contents))
+    ERROR_LOG_FMT(FILEMON, "Failed to write DVD access profile to {}", m_path);
+
+  m_dirty = false;
+}
+
+void AccessProfile::Clear()
+{
+  m_path.clear();
+  m_entries.clear();
+  m_indices.clear();
+  m_last_index.reset();
+  m_dirty = false;
+}
+
+std::optional<size_t> AccessProfile::Record(const DiscIO::Volume& volume,
+                                            const DiscIO::Partition& partition, u64 offset)
+{
+  if (m_path.empty())
+    return std::nullopt;
+
+  // Games usually read a file in several consecutive requests, so check the last file first
+  if (m_last_index)
+  {
+    const Entry& entry = m_entries[*m_last_index];
+    if (entry.partition_offset == partition.offset && offset >= entry.file_offset &&
+        offset - entry.file_offset < entry.file_size)
+    {
+      return m_last_index;
+    }
+  }
+
+  const DiscIO::FileSystem* file_system = volume.GetFileSystem(partition);
+  if (!file_system)
+    return std::nullopt;
+
+  const std::unique_ptr<DiscIO::FileInfo> file_info = file_system->FindFileInfo(offset);
+  if (!file_info)
+    return std::nullopt;
+
+  const auto it = m_indices.find({partition.offset, file_info->GetOffset()});
+  if (it != m_indices.end())
+  {
+    m_last_index = it->second;
+  }
+  else
+  {
+    AddEntry({partition.offset, file_info->GetOffset(), file_info->GetSize()});
+    m_last_index = m_entries.size() - 1;
+    m_dirty = true;
+  }
+
+  return m_last_index;
+}
+
+void AccessProfile::AddEntry(const Entry& entry)
+{
+  const auto [it, inserted] =
+      m_indices.emplace(std::make_pair(entry.partition_offset, entry.file_offset), m_entries.size());
+  if (inserted)
+    m_entries.push_back(entry);
+}
+
 }  // namespace FileMonitor
@@ -3,6 +3,12 @@
 
 #pragma once
 
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "Common/CommonTypes.h"
 
 namespace DiscIO
@@ -14,4 +20,40 @@ class Volume;
 namespace FileMonitor
 {
 void Log(const DiscIO::Volume& volume, const DiscIO::Partition& partition, u64 offset);
-}
+
+// Keeps track of the order in which a game first accesses the files on a disc, so that a later
+// session can read them ahead of time. Profiles are stored in the cache directory.
+class AccessProfile
+{
+public:
+  struct Entry
+  {
+    u64 partition_offset;
+    u64 file_offset;
+    u64 file_size;
+  };
+
+  // Loads the profile of the given disc, or starts an empty one if there is none yet
+  void Load(const DiscIO::Volume& volume);
+  // Writes the profile back to disk if new files have been recorded since it was loaded
+  void Save();
+  void Clear();
+
+  // Returns the index of the entry for the file containing the given offset, appending a new
+  // entry if the file hasn't been accessed before. Returns std::nullopt if there is no file there.
+  std::optional<size_t> Record(const DiscIO::Volume& volume, const DiscIO::Partition& partition,
+                               u64 offset);
+
+  const std::vector<Entry>& GetEntries() const { return m_entries; }
+
+private:
+  void AddEntry(const Entry& entry);
+
+  std::string m_path;
+  std::vector<Entry> m_entries;
+  // Maps (partition offset, file offset) to an index in m_entries
+  std::map<std::pair<u64, u64>, size_t> m_indices;
+  std::optional<size_t> m_last_index;
+  bool m_dirty = false;
+};
+}  // namespace FileMonitor
@@ -3,6 +3,7 @@
 
 #include "Core/HW/MMIO.h"
 
+#include <algorithm>
 #include <functional>
 
 #include "Common/Assert.h"
@@ -408,6 +409,52 @@ void WriteHandler<T>::InitializeInvalid()
   ResetMethod(InvalidWrite<T>());
 }
 
+void Mapping::SetAccessCountingEnabled(bool enabled)
+{
+  if (enabled && !m_count_accesses)
+  {
+    if (!m_access_counts)
+      m_access_counts = std::make_unique<AccessCounters>();
+    m_access_counts->reads.fill(0);
+    m_access_counts->writes.fill(0);
+  }
+  m_count_accesses = enabled;
+}
+
+u64* Mapping::GetReadCounter(u32 addr)
+{
+  return m_count_accesses ? &m_access_counts->reads[UniqueID(addr)] : nullptr;
+}
+
+u64* Mapping::GetWriteCounter(u32 addr)
+{
+  return m_count_accesses ? &m_access_counts->writes[UniqueID(addr)] : nullptr;
+}
+
+std::vector<Mapping::AccessCount> Mapping::GetAccessCounts() const
+{
+  std::vector<AccessCount> counts;
+  if (!m_access_counts)
+    return counts;
+
+  for (u32 id = 0; id < NUM_MMIOS; ++id)
+  {
+    const u64 reads = m_access_counts->reads[id];
+    const u64 writes = m_access_counts->writes[id];
+    if (reads == 0 && writes == 0)
+      continue;
+
+    // Reverse UniqueID(). Wii registers are reported using their 0x0D00xxxx address.
+    const u32 address = ((id >> 16) == WII_BLOCK ? 0x0D000000 : 0x0C000000) | (id & 0xFFFF);
+    counts.push_back({address, reads, writes});
+  }
+
+  std::sort(counts.begin(), counts.end(), [](const AccessCount& a, const AccessCount& b) {
+    return a.reads + a.writes > b.reads + b.writes;
+  });
+  return counts;
+}
+
 // Define all the public specializations that are exported in MMIOHandlers.h.
 #define MaybeExtern
 MMIO_PUBLIC_SPECIALIZATIONS()
@@ -5,9 +5,11 @@
 
 #include <array>
 #include <atomic>
+#include <memory>
 #include <string>
 #include <tuple>
 #include <type_traits>
+#include <vector>
 
 #include "Common/Assert.h"
 #include "Common/BitUtils.h"
@@ -40,10 +42,10 @@ const u32 NUM_MMIOS = NUM_BLOCKS * BLOCK_SIZE;
 //
 // We have a special exception here for FIFO writes: these are handled via a
 // different mechanism and should not go through the normal MMIO access
-// interface.
+// interface. Writes anywhere in the page of the WG Pipe go to the FIFO.
 inline bool IsMMIOAddress(u32 address)
 {
-  if (address == 0x0C008000)
+  if ((address & 0xFFFFF000) == 0x0C008000)
     return false;  // WG Pipe
   if ((address & 0xFFFF0000) == 0x0C000000)
     return true;  // GameCube MMIOs
@@ -131,12 +133,16 @@ public:
   template <typename Unit>
   Unit Read(u32 addr)
   {
+    if (m_count_accesses)
+      ++m_access_counts->reads[UniqueID(addr)];
     return GetHandlerForRead<Unit>(addr).Read(addr);
   }
 
   template <typename Unit>
   void Write(u32 addr, Unit val)
   {
+    if (m_count_accesses)
+      ++m_access_counts->writes[UniqueID(addr)];
     GetHandlerForWrite<Unit>(addr).Write(addr, val);
   }
 
@@ -157,7 +163,41 @@ public:
     return GetWriteHandler<Unit>(UniqueID(addr) / sizeof(Unit));
   }
 
+  // Access counting interface.
+  //
+  // When enabled, every access to an MMIO register increments a per-address
+  // counter, including the accesses that the JIT inlined. This makes it easy
+  // to find out which registers a game is hammering. The counters are
+  // allocated on first use and never freed, so that JIT'd code holding a
+  // pointer to them stays valid even after counting gets disabled again.
+  struct AccessCount
+  {
+    u32 address;
+    u64 reads;
+    u64 writes;
+  };
+
+  void SetAccessCountingEnabled(bool enabled);
+  bool IsAccessCountingEnabled() const { return m_count_accesses; }
+
+  // Returns nullptr when access counting is disabled.
+  u64* GetReadCounter(u32 addr);
+  u64* GetWriteCounter(u32 addr);
+
+  // Returns the addresses that have been accessed since counting was last
+  // enabled, sorted by decreasing total access count.
+  std::vector<AccessCount> GetAccessCounts() const;
+
 private:
+  struct AccessCounters
+  {
+    std::array<u64, NUM_MMIOS> reads;
+    std::array<u64, NUM_MMIOS> writes;
+  };
+
+  std::unique_ptr<AccessCounters> m_access_counts;
+  bool m_count_accesses = false;
+
   // These arrays contain the handlers for each MMIO access type: read/write
   // to 8/16/32 bits. They are indexed using the UniqueID(addr) function
   // defined earlier, which maps an MMIO address to a unique ID by using the
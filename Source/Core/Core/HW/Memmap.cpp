@@ -10,8 +10,17 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstring>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
@@ -31,10 +40,12 @@
 #include "Core/HW/SI/SI.h"
 #include "Core/HW/VideoInterface.h"
 #include "Core/HW/WII_IPC.h"
+#include "Core/PowerPC/BreakPoints.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
 #include "Core/PowerPC/PowerPC.h"
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/PixelEngine.h"
+#include "VideoCommon/VideoBackendBase.h"
 
 namespace Memory
 {
@@ -181,6 +192,7 @@ struct LogicalMemoryView
 {
   void* mapped_pointer;
   u32 mapped_size;
+  u32 physical_address;
 };
 
 // Dolphin allocates memory to represent four regions:
@@ -208,7 +220,8 @@ struct LogicalMemoryView
 //
 // The 4GB starting at logical_base represents access from the CPU
 // with address translation turned on.  This mapping is computed based
-// on the BAT registers.
+// on the BAT registers, plus (with MMU emulation) the page table entries
+// that the MMU code has found to be safe to access directly.
 //
 // Each of these 4GB regions is followed by 4GB of empty space so overflows
 // in address computation in the JIT don't access the wrong memory.
@@ -227,6 +240,44 @@ static std::array<PhysicalMemoryRegion, 4> s_physical_regions;
 
 static std::vector<LogicalMemoryView> logical_mapped_entries;
 
+struct PageTableView
+{
+  u32 physical_address;
+  u32 size;
+};
+
+// Views of page table translated memory in the logical region, by logical address. Pages that are
+// next to each other in both address spaces share a view, but views never cross segments.
+static std::map<u32, PageTableView> s_page_table_views;
+static bool s_page_table_mappings_supported = false;
+
+// Every view is a mapping of its own on the host, and hosts limit how many of those a process may
+// have (vm.max_map_count on Linux defaults to 65530).
+constexpr size_t MAX_PAGE_TABLE_VIEWS = 0x4000;
+
+// Host pages of the physical fastmem view that are protected because memchecks watch them.
+// Logical views are recreated on every update, so only these need to be restored explicitly.
+static std::vector<u8*> s_memcheck_protected_physical_pages;
+
+// Effective address of each host page watched by memchecks, and whether reads are watched too.
+static std::map<u32, bool> s_memcheck_watched_pages;
+
+struct PendingGPUWrite
+{
+  u32 address;
+  u32 size;
+};
+
+// Physical memory that the GPU thread is still going to write to, and the host pages of the
+// fastmem views that are protected because of it, along with the physical page they map.
+static std::vector<PendingGPUWrite> s_pending_gpu_writes;
+static std::map<u8*, u32> s_pending_gpu_write_pages;
+static std::atomic<bool> s_has_pending_gpu_writes = false;
+
+// Pending GPU writes are added and removed on the GPU thread, which changes the protection of the
+// fastmem views while the CPU thread may be remapping them.
+static std::mutex s_view_protection_lock;
+
 void Init()
 {
   const auto get_mem1_size = [] {
@@ -343,15 +394,142 @@ bool InitFastmemArena()
   logical_base = physical_base + 0x200000000;
 #endif
 
+  // Page table mappings are 4 KiB each, so they need the host to map memory at that granularity.
+  // MapViewOfFileEx is limited to the 64 KiB allocation granularity on Windows. Only games that
+  // run with MMU emulation enabled rely on the page table in practice.
+#if !defined(_WIN32) && !defined(_ARCH_32)
+  s_page_table_mappings_supported = SConfig::GetInstance().bMMU &&
+                                    sysconf(_SC_PAGESIZE) == PowerPC::HW_PAGE_SIZE;
+#endif
+
   is_fastmem_arena_initialized = true;
   return true;
 }
 
+static bool IsMappedPhysicalAddress(u32 physical_address)
+{
+  return std::any_of(s_physical_regions.begin(), s_physical_regions.end(), [&](const auto& region) {
+    return region.active && physical_address >= region.physical_address &&
+           physical_address - region.physical_address < region.size;
+  });
+}
+
+// Accesses to memory watched by a memcheck fault and get backpatched to the slow path, which
+// evaluates the memcheck. Everything else in the same block keeps using fastmem.
+static void ProtectMemCheckPages(const PowerPC::BatTable& dbat_table)
+{
+  const u32 host_page_size = static_cast<u32>(Common::MemArena::GetHostPageSize());
+
+  for (u8* page : s_memcheck_protected_physical_pages)
+    g_arena.ProtectView(page, host_page_size, Common::MemArena::ViewAccess::ReadWrite);
+  s_memcheck_protected_physical_pages.clear();
+
+  // A page that is watched for reads by any memcheck must not be readable at all.
+  s_memcheck_watched_pages.clear();
+  for (const TMemCheck& mem_check : PowerPC::memchecks.GetMemChecks())
+  {
+    const u64 end = u64(mem_check.end_address) + 1;
+    for (u64 page = mem_check.start_address & ~(host_page_size - 1); page < end;
+         page += host_page_size)
+    {
+      s_memcheck_watched_pages[static_cast<u32>(page)] |= mem_check.is_break_on_read;
+    }
+  }
+
+  for (const auto& [page, watch_reads] : s_memcheck_watched_pages)
+  {
+    const auto access = watch_reads ? Common::MemArena::ViewAccess::None :
+                                      Common::MemArena::ViewAccess::ReadOnly;
+
+    // With address translation off, effective addresses are physical addresses.
+    if (IsMappedPhysicalAddress(page) &&
+        g_arena.ProtectView(physical_base + page, host_page_size, access))
+    {
+      s_memcheck_protected_physical_pages.push_back(physical_base + page);
+    }
+
+    const u32 bat_result = dbat_table[page >> PowerPC::BAT_INDEX_SHIFT];
+    if ((bat_result & PowerPC::BAT_MEMCHECK_BIT) == 0)
+      continue;
+    const u32 translated_address = (bat_result & PowerPC::BAT_RESULT_MASK) |
+                                   (page & (PowerPC::BAT_PAGE_SIZE - 1));
+    if (IsMappedPhysicalAddress(translated_address))
+      g_arena.ProtectView(logical_base + page, host_page_size, access);
+  }
+}
+
+static Common::MemArena::ViewAccess GetMemCheckAccess(u32 effective_page)
+{
+  const auto it = s_memcheck_watched_pages.find(effective_page);
+  if (it == s_memcheck_watched_pages.end())
+    return Common::MemArena::ViewAccess::ReadWrite;
+  return it->second ? Common::MemArena::ViewAccess::None : Common::MemArena::ViewAccess::ReadOnly;
+}
+
+static bool OverlapsPendingGPUWrite(u32 address, u32 size)
+{
+  return std::any_of(s_pending_gpu_writes.begin(), s_pending_gpu_writes.end(),
+                     [&](const PendingGPUWrite& write) {
+                       return u64(address) + size > write.address &&
+                              u64(write.address) + write.size > address;
+                     });
+}
+
+// Calls f(host_page, effective_page) for every host page of the fastmem views that maps the
+// given physical page.
+template <typename F>
+static void ForEachFastmemPage(u32 physical_page, F f)
+{
+  if (IsMappedPhysicalAddress(physical_page))
+    f(physical_base + physical_page, physical_page);
+
+  for (const LogicalMemoryView& view : logical_mapped_entries)
+  {
+    if (physical_page >= view.physical_address &&
+        physical_page - view.physical_address < view.mapped_size)
+    {
+      u8* host_page = static_cast<u8*>(view.mapped_pointer) + physical_page - view.physical_address;
+      f(host_page, static_cast<u32>(host_page - logical_base));
+    }
+  }
+}
+
+// Protects the host pages covering the range if a pending GPU write overlaps them, and restores
+// them otherwise. Must be called with s_view_protection_lock held.
+static void UpdatePendingGPUWriteProtection(u32 address, u32 size)
+{
+  if (!is_fastmem_arena_initialized)
+    return;
+
+  const u32 host_page_size = static_cast<u32>(Common::MemArena::GetHostPageSize());
+  const u64 end = u64(address) + size;
+  for (u64 page = address & ~(host_page_size - 1); page < end; page += host_page_size)
+  {
+    const u32 physical_page = static_cast<u32>(page);
+    const bool pending = OverlapsPendingGPUWrite(physical_page, host_page_size);
+    ForEachFastmemPage(physical_page, [&](u8* host_page, u32 effective_page) {
+      if (pending)
+      {
+        g_arena.ProtectView(host_page, host_page_size, Common::MemArena::ViewAccess::None);
+        s_pending_gpu_write_pages[host_page] = physical_page;
+      }
+      else if (s_pending_gpu_write_pages.erase(host_page) != 0)
+      {
+        g_arena.ProtectView(host_page, host_page_size, GetMemCheckAccess(effective_page));
+      }
+    });
+  }
+}
+
 void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table)
 {
   if (!is_fastmem_arena_initialized)
     return;
 
+  // Pages that were translated through the page table may be covered by a BAT now.
+  ClearPageTableMappings();
+
+  std::lock_guard lock(s_view_protection_lock);
   for (auto& entry : logical_mapped_entries)
   {
     g_arena.ReleaseView(entry.mapped_pointer, entry.mapped_size);
@@ -359,7 +537,7 @@ void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table)
   logical_mapped_entries.clear();
   for (u32 i = 0; i < dbat_table.size(); ++i)
   {
-    if (dbat_table[i] & PowerPC::BAT_PHYSICAL_BIT)
+    if (dbat_table[i] & (PowerPC::BAT_PHYSICAL_BIT | PowerPC::BAT_MEMCHECK_BIT))
     {
       u32 logical_address = i << PowerPC::BAT_INDEX_SHIFT;
       // TODO: Merge adjacent mappings to make this faster.
@@ -389,11 +567,251 @@ void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table)
                           intersection_start, mapped_size, logical_address);
             exit(0);
           }
-          logical_mapped_entries.push_back({mapped_pointer, mapped_size});
+          logical_mapped_entries.push_back({mapped_pointer, mapped_size, intersection_start});
         }
       }
     }
   }
+
+  ProtectMemCheckPages(dbat_table);
+
+  // The logical views are new, and memchecks may have restored pages of the physical view.
+  s_pending_gpu_write_pages.erase(s_pending_gpu_write_pages.lower_bound(logical_base),
+                                  s_pending_gpu_write_pages.end());
+  for (const PendingGPUWrite& write : s_pending_gpu_writes)
+    UpdatePendingGPUWriteProtection(write.address, write.size);
+}
+
+bool CanMapPageTableEntries()
+{
+  return is_fastmem_arena_initialized && s_page_table_mappings_supported;
+}
+
+static const PhysicalMemoryRegion* FindPhysicalRegion(u32 physical_address)
+{
+  const auto it =
+      std::find_if(s_physical_regions.begin(), s_physical_regions.end(), [&](const auto& region) {
+        return region.active && physical_address >= region.physical_address &&
+               physical_address - region.physical_address < region.size;
+      });
+  return it != s_physical_regions.end() ? &*it : nullptr;
+}
+
+static std::map<u32, PageTableView>::iterator FindPageTableView(u32 logical_address)
+{
+  auto it = s_page_table_views.upper_bound(logical_address);
+  if (it == s_page_table_views.begin())
+    return s_page_table_views.end();
+  --it;
+  if (logical_address - it->first >= it->second.size)
+    return s_page_table_views.end();
+  return it;
+}
+
+// Page table mappings are never protected for pending GPU writes, since those aren't deferred with
+// MMU emulation, so these don't need to take s_view_protection_lock. The fault handler can't wait
+// for it either.
+bool AddPageTableMapping(u32 logical_address, u32 physical_address)
+{
+  if (!CanMapPageTableEntries())
+    return false;
+
+  const auto it = FindPageTableView(logical_address);
+  if (it != s_page_table_views.end())
+  {
+    if (it->second.physical_address + (logical_address - it->first) == physical_address)
+      return false;
+    RemovePageTableMapping(logical_address);
+  }
+
+  const PhysicalMemoryRegion* region = FindPhysicalRegion(physical_address);
+  if (!region)
+    return false;
+
+  if (s_page_table_views.size() >= MAX_PAGE_TABLE_VIEWS)
+  {
+    // Rather than keeping track of which views are still in use, start over. Pages that are still
+    // being accessed get mapped again when the accesses fault.
+    ClearPageTableMappings();
+  }
+
+  // Views are merged if they are next to each other in both address spaces and in the same segment
+  // and physical region.
+  const auto can_merge = [region](u32 logical, const PageTableView& view, u32 next_logical,
+                                  u32 next_physical) {
+    return logical + view.size == next_logical &&
+           view.physical_address + view.size == next_physical &&
+           logical >> 28 == next_logical >> 28 &&
+           view.physical_address >= region->physical_address &&
+           next_physical - region->physical_address < region->size;
+  };
+
+  u32 view_logical = logical_address;
+  PageTableView view{physical_address, PowerPC::HW_PAGE_SIZE};
+  const auto next = s_page_table_views.upper_bound(logical_address);
+  const bool merge_next =
+      next != s_page_table_views.end() &&
+      can_merge(logical_address, view, next->first, next->second.physical_address);
+  if (next != s_page_table_views.begin())
+  {
+    const auto previous = std::prev(next);
+    if (can_merge(previous->first, previous->second, logical_address, physical_address))
+    {
+      view_logical = previous->first;
+      view.physical_address = previous->second.physical_address;
+      view.size += previous->second.size;
+    }
+  }
+  if (merge_next)
+    view.size += next->second.size;
+
+  // Mapping the merged view replaces the views it covers.
+  const u32 position = region->shm_position + view.physical_address - region->physical_address;
+  u8* base = logical_base + view_logical;
+  if (g_arena.CreateView(position, view.size, base) != base)
+  {
+    // Not fatal; accesses to these pages will simply take the slow path. The views that were
+    // supposed to be replaced may be gone already though.
+    WARN_LOG_FMT(MEMMAP,
+                 "Memory::AddPageTableMapping(): Failed to map 0x{:08X} to logical 0x{:08X}.",
+                 physical_address, logical_address);
+    ClearPageTableMappings();
+    return false;
+  }
+
+  if (merge_next)
+    s_page_table_views.erase(next);
+  s_page_table_views[view_logical] = view;
+  return true;
+}
+
+void RemovePageTableMapping(u32 logical_address)
+{
+  logical_address &= ~(PowerPC::HW_PAGE_SIZE - 1);
+  const auto it = FindPageTableView(logical_address);
+  if (it == s_page_table_views.end())
+    return;
+
+  const u32 view_logical = it->first;
+  const PageTableView view = it->second;
+  g_arena.ReleaseView(logical_base + logical_address, PowerPC::HW_PAGE_SIZE);
+  s_page_table_views.erase(it);
+
+  // The rest of the view stays mapped.
+  const u32 offset = logical_address - view_logical;
+  if (offset != 0)
+    s_page_table_views.emplace(view_logical, PageTableView{view.physical_address, offset});
+  const u32 tail_offset = offset + PowerPC::HW_PAGE_SIZE;
+  if (tail_offset < view.size)
+  {
+    s_page_table_views.emplace(view_logical + tail_offset,
+                               PageTableView{view.physical_address + tail_offset,
+                                             view.size - tail_offset});
+  }
+
+  if (s_page_table_views.size() > MAX_PAGE_TABLE_VIEWS)
+    ClearPageTableMappings();
+}
+
+void RemovePageTableMappingsInSegment(u32 segment)
+{
+  const u64 segment_start = u64(segment) << 28;
+  auto it = s_page_table_views.lower_bound(static_cast<u32>(segment_start));
+  while (it != s_page_table_views.end() && it->first < segment_start + 0x10000000)
+  {
+    g_arena.ReleaseView(logical_base + it->first, it->second.size);
+    it = s_page_table_views.erase(it);
+  }
+}
+
+void ClearPageTableMappings()
+{
+  for (const auto& [logical_address, view] : s_page_table_views)
+    g_arena.ReleaseView(logical_base + logical_address, view.size);
+  s_page_table_views.clear();
+}
+
+std::optional<u32> GetPageTableMapping(u32 logical_address)
+{
+  const auto it = FindPageTableView(logical_address);
+  if (it == s_page_table_views.end())
+    return std::nullopt;
+  return it->second.physical_address + (logical_address - it->first);
+}
+
+size_t GetPageTableViewCount()
+{
+  return s_page_table_views.size();
+}
+
+bool CanDeferGPUWrites()
+{
+  // The JIT only looks up accesses in the soft TLB without the fastmem arena, or with page table
+  // translation enabled. In single core mode, the fault handler would have to do the GPU's work
+  // itself, and graphics APIs can't be used from a signal handler.
+  const SConfig& config = SConfig::GetInstance();
+  return is_fastmem_arena_initialized && !config.bMMU && config.bCPUThread;
+}
+
+void AddPendingGPUWrite(u32 address, u32 size)
+{
+  std::lock_guard lock(s_view_protection_lock);
+  s_pending_gpu_writes.push_back({address, size});
+  s_has_pending_gpu_writes = true;
+  UpdatePendingGPUWriteProtection(address, size);
+}
+
+void RemovePendingGPUWrite(u32 address, u32 size)
+{
+  std::lock_guard lock(s_view_protection_lock);
+  const auto it = std::find_if(
+      s_pending_gpu_writes.begin(), s_pending_gpu_writes.end(),
+      [&](const PendingGPUWrite& write) { return write.address == address && write.size == size; });
+  if (it == s_pending_gpu_writes.end())
+    return;
+
+  s_pending_gpu_writes.erase(it);
+  s_has_pending_gpu_writes = !s_pending_gpu_writes.empty();
+  UpdatePendingGPUWriteProtection(address, size);
+}
+
+void WaitForGPUWrites(u32 address, u32 size)
+{
+  if (!s_has_pending_gpu_writes)
+    return;
+
+  {
+    std::lock_guard lock(s_view_protection_lock);
+    if (!OverlapsPendingGPUWrite(address, size))
+      return;
+  }
+
+  g_video_backend->Video_WaitForEFBCopies(address, size);
+}
+
+bool HandleFault(uintptr_t access_address)
+{
+  if (!s_has_pending_gpu_writes)
+    return false;
+
+  const u32 host_page_size = static_cast<u32>(Common::MemArena::GetHostPageSize());
+  u8* host_page = reinterpret_cast<u8*>(access_address & ~uintptr_t(host_page_size - 1));
+  u32 physical_page;
+  {
+    std::lock_guard lock(s_view_protection_lock);
+    const auto it = s_pending_gpu_write_pages.find(host_page);
+    if (it == s_pending_gpu_write_pages.end())
+      return false;
+    physical_page = it->second;
+  }
+
+  // The GPU thread restores the page once nothing is pending on it anymore, so the access can
+  // simply be retried. The fault is synchronous and the CPU thread never holds the lock while it
+  // runs JIT code, so waiting here can't deadlock. If the GPU thread has stopped taking requests,
+  // the page stays protected, and the JIT has to handle the fault instead.
+  WaitForGPUWrites(physical_page, host_page_size);
+  std::lock_guard lock(s_view_protection_lock);
+  return s_pending_gpu_write_pages.count(host_page) == 0;
 }
 
 void DoState(PointerWrap& p)
@@ -414,6 +832,12 @@ void Shutdown()
 {
   ShutdownFastmemArena();
 
+  {
+    std::lock_guard lock(s_view_protection_lock);
+    s_pending_gpu_writes.clear();
+    s_has_pending_gpu_writes = false;
+  }
+
   m_IsInitialized = false;
   for (const PhysicalMemoryRegion& region : s_physical_regions)
   {
@@ -442,16 +866,21 @@ void ShutdownFastmemArena()
     g_arena.ReleaseView(base, region.size);
   }
 
+  ClearPageTableMappings();
+  std::lock_guard lock(s_view_protection_lock);
   for (auto& entry : logical_mapped_entries)
   {
     g_arena.ReleaseView(entry.mapped_pointer, entry.mapped_size);
   }
   logical_mapped_entries.clear();
+  s_memcheck_protected_physical_pages.clear();
+  s_pending_gpu_write_pages.clear();
 
   physical_base = nullptr;
   logical_base = nullptr;
 
   is_fastmem_arena_initialized = false;
+  s_page_table_mappings_supported = false;
 }
 
 void Clear()
@@ -485,6 +914,7 @@ void CopyFromEmu(void* data, u32 address, size_t size)
   if (size == 0)
     return;
 
+  WaitForGPUWrites(address, static_cast<u32>(size));
   void* pointer = GetPointerForRange(address, size);
   if (!pointer)
   {
@@ -499,6 +929,7 @@ void CopyToEmu(u32 address, const void* data, size_t size)
   if (size == 0)
     return;
 
+  WaitForGPUWrites(address, static_cast<u32>(size));
   void* pointer = GetPointerForRange(address, size);
   if (!pointer)
   {
@@ -513,6 +944,7 @@ void Memset(u32 address, u8 value, size_t size)
   if (size == 0)
     return;
 
+  WaitForGPUWrites(address, static_cast<u32>(size));
   void* pointer = GetPointerForRange(address, size);
   if (!pointer)
   {
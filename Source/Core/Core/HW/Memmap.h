@@ -3,7 +3,9 @@
 
 #pragma once
 
+#include <cstddef>
 #include <memory>
+#include <optional>
 #include <string>
 
 #include "Common/CommonTypes.h"
@@ -68,6 +70,30 @@ void DoState(PointerWrap& p);
 
 void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table);
 
+// Fastmem mappings for page table translated memory. These are managed by the MMU, which only
+// maps pages whose translation the slow path would also produce without side effects, once they
+// are accessed. Accesses to pages that can't be mapped fault and are backpatched to the slow path
+// like any other fastmem access.
+bool CanMapPageTableEntries();
+// Returns whether a new mapping was created.
+bool AddPageTableMapping(u32 logical_address, u32 physical_address);
+void RemovePageTableMapping(u32 logical_address);
+void RemovePageTableMappingsInSegment(u32 segment);
+void ClearPageTableMappings();
+std::optional<u32> GetPageTableMapping(u32 logical_address);
+size_t GetPageTableViewCount();
+
+// Physical memory the GPU thread has yet to write, for EFB copies that are read back
+// asynchronously. Fastmem accesses to the host pages covering it fault, and both these faults and
+// slow path accesses wait for the video backend to finish the writes. The MMU's soft TLB bypasses
+// both, and so does single core mode, where there is no GPU thread to wait for. Writes may only be
+// deferred if CanDeferGPUWrites() returns true.
+bool CanDeferGPUWrites();
+void AddPendingGPUWrite(u32 address, u32 size);
+void RemovePendingGPUWrite(u32 address, u32 size);
+void WaitForGPUWrites(u32 address, u32 size);
+bool HandleFault(uintptr_t access_address);
+
 void Clear();
 
 // Routines to access physically addressed memory, designed for use by
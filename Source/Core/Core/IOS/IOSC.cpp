@@ -273,10 +273,12 @@ ReturnCode IOSC::DecryptEncrypt(Common::AES::Mode mode, Handle key_handle, u8* i
   if (entry->data.size() != AES128_KEY_SIZE)
     return IOSC_FAIL_INTERNAL;
 
-  const std::vector<u8> data =
-      Common::AES::DecryptEncrypt(entry->data.data(), iv, input, size, mode);
+  // The size comes straight from the guest. AES works on whole 16 byte blocks only.
+  if (size % 16 != 0)
+    return IOSC_EINVAL;
 
-  std::memcpy(output, data.data(), data.size());
+  if (!Common::AES::CreateContext(entry->data.data(), mode)->CryptCBC(iv, input, output, size))
+    return IOSC_FAIL_INTERNAL;
   return IPC_SUCCESS;
 }
 
@@ -214,13 +214,12 @@ void MemChecks::Add(const TMemCheck& memory_check)
   if (GetMemCheck(memory_check.start_address) != nullptr)
     return;
 
-  bool had_any = HasAny();
   Core::RunAsCPUThread([&] {
     m_mem_checks.push_back(memory_check);
-    // If this is the first one, clear the JIT cache so it can switch to
-    // watchpoint-compatible code.
-    if (!had_any)
-      JitInterface::ClearCache();
+    // Compiled code accesses constant addresses outside of watched memory directly, without the
+    // information needed to backpatch the access if it faults, so it can't survive the page being
+    // protected. The first memcheck also switches the JIT to watchpoint-compatible code.
+    JitInterface::ClearCache();
     PowerPC::DBATUpdated();
   });
 }
@@ -248,8 +247,7 @@ void MemChecks::Remove(u32 address)
 
   Core::RunAsCPUThread([&] {
     m_mem_checks.erase(iter);
-    if (!HasAny())
-      JitInterface::ClearCache();
+    JitInterface::ClearCache();
     PowerPC::DBATUpdated();
   });
 }
@@ -3,6 +3,7 @@
 
 #include "Core/PowerPC/CachedInterpreter/CachedInterpreter.h"
 
+#include "Common/BitUtils.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Core/ConfigManager.h"
@@ -11,13 +12,25 @@
 #include "Core/HW/CPU.h"
 #include "Core/PowerPC/Gekko.h"
 #include "Core/PowerPC/Jit64Common/Jit64Constants.h"
+#include "Core/PowerPC/MMU.h"
 #include "Core/PowerPC/PPCAnalyst.h"
 #include "Core/PowerPC/PowerPC.h"
 
+// Operands of an instruction that were extracted when the block was compiled, so that the
+// handler doesn't need to decode the instruction again every time it is executed.
+struct PredecodedOperands
+{
+  u32 imm;
+  u8 d;
+  u8 a;
+  u8 b;
+};
+
 struct CachedInterpreter::Instruction
 {
   using CommonCallback = void (*)(UGeckoInstruction);
   using ConditionalCallback = bool (*)(u32);
+  using PredecodedCallback = void (*)(PredecodedOperands);
 
   Instruction() {}
   Instruction(const CommonCallback c, UGeckoInstruction i)
@@ -30,20 +43,31 @@ struct CachedInterpreter::Instruction
   {
   }
 
-  enum class Type
+  Instruction(const PredecodedCallback c, PredecodedOperands o)
+      : predecoded_callback(c), operands(o), type(Type::Predecoded)
+  {
+  }
+
+  enum class Type : u8
   {
     Abort,
     Common,
     Conditional,
+    Predecoded,
   };
 
   union
   {
     const CommonCallback common_callback;
     const ConditionalCallback conditional_callback;
+    const PredecodedCallback predecoded_callback;
   };
 
-  u32 data = 0;
+  union
+  {
+    u32 data = 0;
+    PredecodedOperands operands;
+  };
   Type type = Type::Abort;
 };
 
@@ -94,6 +118,10 @@ void CachedInterpreter::ExecuteOneBlock()
       code->common_callback(UGeckoInstruction(code->data));
       break;
 
+    case Instruction::Type::Predecoded:
+      code->predecoded_callback(code->operands);
+      break;
+
     case Instruction::Type::Conditional:
       if (code->conditional_callback(code->data))
         return;
@@ -200,6 +228,150 @@ static bool CheckIdle(u32 idle_pc)
   return false;
 }
 
+static void LoadImmediate(PredecodedOperands operands)
+{
+  rGPR[operands.d] = operands.imm;
+}
+
+static void AddImmediate(PredecodedOperands operands)
+{
+  rGPR[operands.d] = rGPR[operands.a] + operands.imm;
+}
+
+static void OrImmediate(PredecodedOperands operands)
+{
+  rGPR[operands.d] = rGPR[operands.a] | operands.imm;
+}
+
+static void XorImmediate(PredecodedOperands operands)
+{
+  rGPR[operands.d] = rGPR[operands.a] ^ operands.imm;
+}
+
+static void MoveRegister(PredecodedOperands operands)
+{
+  rGPR[operands.d] = rGPR[operands.a];
+}
+
+static void RotateAndMask(PredecodedOperands operands)
+{
+  rGPR[operands.d] = Common::RotateLeft(rGPR[operands.a], operands.b) & operands.imm;
+}
+
+template <typename T>
+static void LoadZeroExtended(PredecodedOperands operands)
+{
+  const u32 address = rGPR[operands.a] + operands.imm;
+  u32 temp;
+  if constexpr (sizeof(T) == 1)
+    temp = PowerPC::Read_U8(address);
+  else if constexpr (sizeof(T) == 2)
+    temp = PowerPC::Read_U16(address);
+  else
+    temp = PowerPC::Read_U32(address);
+
+  if (!(PowerPC::ppcState.Exceptions & EXCEPTION_DSI))
+    rGPR[operands.d] = temp;
+}
+
+template <typename T>
+static void Store(PredecodedOperands operands)
+{
+  const u32 address = rGPR[operands.a] + operands.imm;
+  if constexpr (sizeof(T) == 1)
+    PowerPC::Write_U8(rGPR[operands.d], address);
+  else if constexpr (sizeof(T) == 2)
+    PowerPC::Write_U16(rGPR[operands.d], address);
+  else
+    PowerPC::Write_U32(rGPR[operands.d], address);
+}
+
+// Emits a specialized handler for the most common simple instructions. These behave exactly
+// like their Interpreter counterparts, but get their operands without decoding the instruction.
+bool CachedInterpreter::EmitPredecodedInstruction(UGeckoInstruction inst)
+{
+  const auto u8_reg = [](u32 reg) { return static_cast<u8>(reg); };
+
+  switch (inst.OPCD)
+  {
+  case 14:  // addi
+  case 15:  // addis
+  {
+    const u32 imm = inst.OPCD == 15 ? u32(inst.SIMM_16) << 16 : u32(inst.SIMM_16);
+    const auto callback = inst.RA == 0 ? LoadImmediate : AddImmediate;
+    m_code.emplace_back(callback, PredecodedOperands{imm, u8_reg(inst.RD), u8_reg(inst.RA), 0});
+    return true;
+  }
+
+  case 24:  // ori
+  case 25:  // oris
+  case 26:  // xori
+  case 27:  // xoris
+  {
+    const u32 imm = (inst.OPCD & 1) ? u32(inst.UIMM) << 16 : u32(inst.UIMM);
+    const auto callback = inst.OPCD < 26 ? OrImmediate : XorImmediate;
+    m_code.emplace_back(callback, PredecodedOperands{imm, u8_reg(inst.RA), u8_reg(inst.RS), 0});
+    return true;
+  }
+
+  case 21:  // rlwinmx
+    if (inst.Rc)
+      return false;
+    m_code.emplace_back(RotateAndMask, PredecodedOperands{MakeRotationMask(inst.MB, inst.ME),
+                                                          u8_reg(inst.RA), u8_reg(inst.RS),
+                                                          u8_reg(inst.SH)});
+    return true;
+
+  case 31:
+    // mr (orx with RS == RB)
+    if (inst.SUBOP10 != 444 || inst.Rc || inst.RS != inst.RB)
+      return false;
+    m_code.emplace_back(MoveRegister, PredecodedOperands{0, u8_reg(inst.RA), u8_reg(inst.RS), 0});
+    return true;
+
+  case 32:  // lwz
+  case 34:  // lbz
+  case 40:  // lhz
+  case 36:  // stw
+  case 38:  // stb
+  case 44:  // sth
+  {
+    // Absolute addressing is rare enough to leave to the Interpreter.
+    if (inst.RA == 0)
+      return false;
+
+    Instruction::PredecodedCallback callback;
+    switch (inst.OPCD)
+    {
+    case 32:
+      callback = LoadZeroExtended<u32>;
+      break;
+    case 34:
+      callback = LoadZeroExtended<u8>;
+      break;
+    case 40:
+      callback = LoadZeroExtended<u16>;
+      break;
+    case 36:
+      callback = Store<u32>;
+      break;
+    case 38:
+      callback = Store<u8>;
+      break;
+    default:
+      callback = Store<u16>;
+      break;
+    }
+    m_code.emplace_back(callback, PredecodedOperands{u32(inst.SIMM_16), u8_reg(inst.RD),
+                                                     u8_reg(inst.RA), 0});
+    return true;
+  }
+
+  default:
+    return false;
+  }
+}
+
 bool CachedInterpreter::HandleFunctionHooking(u32 address)
 {
   return HLE::ReplaceFunctionIfPossible(address, [&](u32 hook_index, HLE::HookType type) {
@@ -284,7 +456,8 @@ void CachedInterpreter::Jit(u32 address)
 
       if (endblock || memcheck)
         m_code.emplace_back(WritePC, op.address);
-      m_code.emplace_back(PPCTables::GetInterpreterOp(op.inst), op.inst);
+      if (!EmitPredecodedInstruction(op.inst))
+        m_code.emplace_back(PPCTables::GetInterpreterOp(op.inst), op.inst);
       if (memcheck)
         m_code.emplace_back(CheckDSI, js.downcountAmount);
       if (idle_loop)
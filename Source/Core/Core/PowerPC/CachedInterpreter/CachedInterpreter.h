@@ -38,6 +38,7 @@ private:
   void ExecuteOneBlock();
 
   bool HandleFunctionHooking(u32 address);
+  bool EmitPredecodedInstruction(UGeckoInstruction inst);
 
   BlockCache m_block_cache{*this};
   std::vector<Instruction> m_code;
@@ -333,6 +333,9 @@ void Jit64::Init()
   EnableBlockLink();
 
   jo.fastmem_arena = SConfig::GetInstance().bFastmem && Memory::InitFastmemArena();
+  // Without the fastmem arena, or with page table translation in play, the BAT based address
+  // check can't resolve most accesses, so look them up in the MMU's soft TLB instead.
+  jo.soft_tlb = !jo.fastmem_arena || SConfig::GetInstance().bMMU;
   jo.optimizeGatherPipe = true;
   jo.accurateSinglePrecision = true;
   UpdateMemoryOptions();
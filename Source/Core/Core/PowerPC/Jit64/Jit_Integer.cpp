@@ -139,6 +139,10 @@ void Jit64::FinalizeCarryOverflow(bool oe, bool inv)
 // LT/GT either.
 void Jit64::ComputeRC(preg_t preg, bool needs_test, bool needs_sext)
 {
+  // CR0 gets overwritten before anything reads it.
+  if (!js.op->crInUse[0])
+    return;
+
   RCOpArg arg = gpr.Use(preg, RCMode::Read);
   RegCache::Realize(arg);
 
@@ -510,6 +514,11 @@ void Jit64::cmpXX(UGeckoInstruction inst)
   int a = inst.RA;
   int b = inst.RB;
   u32 crf = inst.CRFD;
+
+  // The result gets overwritten before anything reads it.
+  if (!js.op->crInUse[crf])
+    return;
+
   bool merge_branch = CheckMergedBranch(crf);
 
   bool signedCompare;
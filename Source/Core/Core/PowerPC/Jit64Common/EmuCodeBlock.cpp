@@ -3,6 +3,8 @@
 
 #include "Core/PowerPC/Jit64Common/EmuCodeBlock.h"
 
+#include <array>
+#include <cstddef>
 #include <functional>
 #include <limits>
 
@@ -130,6 +132,54 @@ FixupBranch EmuCodeBlock::CheckIfSafeAddress(const OpArg& reg_value, X64Reg reg_
   return J_CC(CC_Z, m_far_code.Enabled());
 }
 
+FixupBranch EmuCodeBlock::SoftTLBLookup(X64Reg reg_addr, X64Reg host, X64Reg tmp, int access_size,
+                                        bool write)
+{
+  static_assert(sizeof(PowerPC::SoftTLBEntry) == 16);
+
+  // tmp = offset of the entry for this page
+  MOV(32, R(tmp), R(reg_addr));
+  SHR(32, R(tmp), Imm8(PowerPC::SOFT_TLB_INDEX_SHIFT - 4));
+  AND(32, R(tmp), Imm32((PowerPC::SOFT_TLB_SIZE - 1) << 4));
+  MOV(64, R(host), ImmPtr(PowerPC::soft_tlb.data()));
+  ADD(64, R(host), R(tmp));
+
+  // Misaligned accesses keep some of the low bits set, so they never match a tag. This also
+  // guarantees that an access which hits doesn't cross into the next page.
+  MOV(32, R(tmp), R(reg_addr));
+  AND(32, R(tmp), Imm32(~static_cast<u32>(PowerPC::HW_PAGE_SIZE - 1) | ((access_size >> 3) - 1)));
+  CMP(32, R(tmp),
+      MDisp(host, write ? offsetof(PowerPC::SoftTLBEntry, write_tag) :
+                          offsetof(PowerPC::SoftTLBEntry, read_tag)));
+  FixupBranch miss = J_CC(CC_NE, m_far_code.Enabled());
+
+  MOV(64, R(host), MDisp(host, offsetof(PowerPC::SoftTLBEntry, host_base)));
+  return miss;
+}
+
+// Picks two registers for SoftTLBLookup that don't alias any of the excluded registers. The ones
+// that are in use have to be saved around the lookup and access.
+static std::array<X64Reg, 2> GetSoftTLBScratchRegisters(BitSet32 excluded,
+                                                        BitSet32 registers_in_use)
+{
+  static constexpr std::array<X64Reg, 5> candidates{RSCRATCH, RSCRATCH2, RSCRATCH_EXTRA, RSI,
+                                                    RDI};
+  std::array<X64Reg, 2> result{INVALID_REG, INVALID_REG};
+  size_t count = 0;
+  for (bool allow_in_use : {false, true})
+  {
+    for (X64Reg reg : candidates)
+    {
+      if (count == result.size())
+        return result;
+      if (excluded[reg] || registers_in_use[reg] != allow_in_use)
+        continue;
+      result[count++] = reg;
+    }
+  }
+  return result;
+}
+
 void EmuCodeBlock::UnsafeLoadRegToReg(X64Reg reg_addr, X64Reg reg_value, int accessSize, s32 offset,
                                       bool signExtend)
 {
@@ -300,10 +350,83 @@ private:
   bool m_sign_extend;
 };
 
+// Visitor that generates code to write a value to a MMIO register.
+template <typename T>
+class MMIOWriteCodeGenerator : public MMIO::WriteHandlingMethodVisitor<T>
+{
+public:
+  MMIOWriteCodeGenerator(Gen::X64CodeBlock* code, BitSet32 registers_in_use,
+                         const Gen::OpArg& value, u32 address)
+      : m_code(code), m_registers_in_use(registers_in_use), m_value(value), m_address(address)
+  {
+  }
+
+  void VisitNop() override {}
+  void VisitDirect(T* addr, u32 mask) override { StoreMaskToAddr(8 * sizeof(T), addr, mask); }
+  void VisitComplex(const std::function<void(u32, T)>* lambda) override
+  {
+    CallLambda(8 * sizeof(T), lambda);
+  }
+
+private:
+  void StoreMaskToAddr(int sbits, T* ptr, u32 mask)
+  {
+    // The value may live in RSCRATCH (e.g. for floating point stores), in
+    // which case it is fine to clobber it while masking.
+    const X64Reg ptr_reg = m_value.IsSimpleReg(RSCRATCH) ? RSCRATCH2 : RSCRATCH;
+    const X64Reg value_reg = ptr_reg == RSCRATCH ? RSCRATCH2 : RSCRATCH;
+
+    m_code->MOV(64, R(ptr_reg), ImmPtr(ptr));
+    if (m_value.IsImm())
+    {
+      const u32 value = m_value.AsImm32().Imm32() & mask;
+      m_code->MOV(sbits, MatR(ptr_reg), FixImmediate(sbits, Imm32(value)));
+      return;
+    }
+
+    const u32 all_ones = static_cast<u32>((1ULL << sbits) - 1);
+    if ((all_ones & mask) == all_ones)
+    {
+      if (m_value.IsSimpleReg())
+      {
+        m_code->MOV(sbits, MatR(ptr_reg), m_value);
+        return;
+      }
+      m_code->MOV(sbits, R(value_reg), m_value);
+    }
+    else
+    {
+      if (!m_value.IsSimpleReg(value_reg))
+        m_code->MOV(32, R(value_reg), m_value);
+      m_code->AND(32, R(value_reg), Imm32(mask));
+    }
+    m_code->MOV(sbits, MatR(ptr_reg), R(value_reg));
+  }
+
+  void CallLambda(int sbits, const std::function<void(u32, T)>* lambda)
+  {
+    m_code->ABI_PushRegistersAndAdjustStack(m_registers_in_use, 0);
+    m_code->ABI_CallLambdaCA(sbits, lambda, m_address, m_value);
+    m_code->ABI_PopRegistersAndAdjustStack(m_registers_in_use, 0);
+  }
+
+  Gen::X64CodeBlock* m_code;
+  BitSet32 m_registers_in_use;
+  Gen::OpArg m_value;
+  u32 m_address;
+};
+
 void EmuCodeBlock::MMIOLoadToReg(MMIO::Mapping* mmio, Gen::X64Reg reg_value,
                                  BitSet32 registers_in_use, u32 address, int access_size,
                                  bool sign_extend)
 {
+  // Keep the access counters accurate for accesses that never reach MMIO::Mapping::Read.
+  if (u64* counter = mmio->GetReadCounter(address))
+  {
+    MOV(64, R(RSCRATCH), ImmPtr(counter));
+    ADD(64, MatR(RSCRATCH), Imm8(1));
+  }
+
   switch (access_size)
   {
   case 8:
@@ -327,6 +450,39 @@ void EmuCodeBlock::MMIOLoadToReg(MMIO::Mapping* mmio, Gen::X64Reg reg_value,
   }
 }
 
+void EmuCodeBlock::MMIOWriteRegToAddr(MMIO::Mapping* mmio, const Gen::OpArg& arg,
+                                      BitSet32 registers_in_use, u32 address, int access_size)
+{
+  if (u64* counter = mmio->GetWriteCounter(address))
+  {
+    const X64Reg counter_reg = arg.IsSimpleReg(RSCRATCH) ? RSCRATCH2 : RSCRATCH;
+    MOV(64, R(counter_reg), ImmPtr(counter));
+    ADD(64, MatR(counter_reg), Imm8(1));
+  }
+
+  switch (access_size)
+  {
+  case 8:
+  {
+    MMIOWriteCodeGenerator<u8> gen(this, registers_in_use, arg, address);
+    mmio->GetHandlerForWrite<u8>(address).Visit(gen);
+    break;
+  }
+  case 16:
+  {
+    MMIOWriteCodeGenerator<u16> gen(this, registers_in_use, arg, address);
+    mmio->GetHandlerForWrite<u16>(address).Visit(gen);
+    break;
+  }
+  case 32:
+  {
+    MMIOWriteCodeGenerator<u32> gen(this, registers_in_use, arg, address);
+    mmio->GetHandlerForWrite<u32>(address).Visit(gen);
+    break;
+  }
+  }
+}
+
 void EmuCodeBlock::SafeLoadToReg(X64Reg reg_value, const Gen::OpArg& opAddress, int accessSize,
                                  s32 offset, BitSet32 registersInUse, bool signExtend, int flags)
 {
@@ -383,7 +539,8 @@ void EmuCodeBlock::SafeLoadToReg(X64Reg reg_value, const Gen::OpArg& opAddress,
 
   FixupBranch exit;
   const bool dr_set = (flags & SAFE_LOADSTORE_DR_ON) || MSR.DR;
-  const bool fast_check_address = !slowmem && dr_set && m_jit.jo.fastmem_arena;
+  const bool soft_tlb = !slowmem && dr_set && m_jit.jo.soft_tlb;
+  const bool fast_check_address = !slowmem && dr_set && m_jit.jo.fastmem_arena && !soft_tlb;
   if (fast_check_address)
   {
     FixupBranch slow = CheckIfSafeAddress(R(reg_value), reg_addr, registersInUse);
@@ -394,6 +551,36 @@ void EmuCodeBlock::SafeLoadToReg(X64Reg reg_value, const Gen::OpArg& opAddress,
       exit = J(true);
     SetJumpTarget(slow);
   }
+  else if (soft_tlb)
+  {
+    BitSet32 excluded{};
+    excluded[reg_addr] = true;
+    const auto [host, tmp] = GetSoftTLBScratchRegisters(excluded, registersInUse);
+    const bool save_host = registersInUse[host];
+    const bool save_tmp = registersInUse[tmp];
+
+    if (save_host)
+      PUSH(host);
+    if (save_tmp)
+      PUSH(tmp);
+    FixupBranch slow = SoftTLBLookup(reg_addr, host, tmp, accessSize, false);
+    LoadAndSwap(accessSize, reg_value, MComplex(host, reg_addr, SCALE_1, 0), signExtend);
+    if (save_tmp)
+      POP(tmp);
+    if (save_host)
+      POP(host);
+
+    if (m_far_code.Enabled())
+      SwitchToFarCode();
+    else
+      exit = J(true);
+    SetJumpTarget(slow);
+
+    if (save_tmp)
+      POP(tmp);
+    if (save_host)
+      POP(host);
+  }
 
   // Helps external systems know which instruction triggered the read.
   // Invalid for calls from Jit64AsmCommon routines
@@ -432,7 +619,7 @@ void EmuCodeBlock::SafeLoadToReg(X64Reg reg_value, const Gen::OpArg& opAddress,
     MOVZX(64, accessSize, reg_value, R(ABI_RETURN));
   }
 
-  if (fast_check_address)
+  if (fast_check_address || soft_tlb)
   {
     if (m_far_code.Enabled())
     {
@@ -551,7 +738,8 @@ void EmuCodeBlock::SafeWriteRegToReg(OpArg reg_value, X64Reg reg_addr, int acces
 
   FixupBranch exit;
   const bool dr_set = (flags & SAFE_LOADSTORE_DR_ON) || MSR.DR;
-  const bool fast_check_address = !slowmem && dr_set && m_jit.jo.fastmem_arena;
+  const bool soft_tlb = !slowmem && dr_set && m_jit.jo.soft_tlb;
+  const bool fast_check_address = !slowmem && dr_set && m_jit.jo.fastmem_arena && !soft_tlb;
   if (fast_check_address)
   {
     FixupBranch slow = CheckIfSafeAddress(reg_value, reg_addr, registersInUse);
@@ -562,6 +750,44 @@ void EmuCodeBlock::SafeWriteRegToReg(OpArg reg_value, X64Reg reg_addr, int acces
       exit = J(true);
     SetJumpTarget(slow);
   }
+  else if (soft_tlb)
+  {
+    BitSet32 excluded{};
+    excluded[reg_addr] = true;
+    if (reg_value.IsSimpleReg())
+      excluded[reg_value.GetSimpleReg()] = true;
+    const auto [host, tmp] = GetSoftTLBScratchRegisters(excluded, registersInUse);
+    const bool save_host = registersInUse[host];
+    const bool save_tmp = registersInUse[tmp];
+
+    if (save_host)
+      PUSH(host);
+    if (save_tmp)
+      PUSH(tmp);
+    FixupBranch slow = SoftTLBLookup(reg_addr, host, tmp, accessSize, true);
+    const OpArg dest = MComplex(host, reg_addr, SCALE_1, 0);
+    if (reg_value.IsImm())
+      MOV(accessSize, dest, swap ? SwapImmediate(accessSize, reg_value) : reg_value);
+    else if (swap)
+      SwapAndStore(accessSize, dest, reg_value.GetSimpleReg());
+    else
+      MOV(accessSize, dest, reg_value);
+    if (save_tmp)
+      POP(tmp);
+    if (save_host)
+      POP(host);
+
+    if (m_far_code.Enabled())
+      SwitchToFarCode();
+    else
+      exit = J(true);
+    SetJumpTarget(slow);
+
+    if (save_tmp)
+      POP(tmp);
+    if (save_host)
+      POP(host);
+  }
 
   // PC is used by memory watchpoints (if enabled) or to print accurate PC locations in debug logs
   // Invalid for calls from Jit64AsmCommon routines
@@ -604,7 +830,7 @@ void EmuCodeBlock::SafeWriteRegToReg(OpArg reg_value, X64Reg reg_addr, int acces
 
   MemoryExceptionCheck();
 
-  if (fast_check_address)
+  if (fast_check_address || soft_tlb)
   {
     if (m_far_code.Enabled())
     {
@@ -658,6 +884,14 @@ bool EmuCodeBlock::WriteToConstAddress(int accessSize, OpArg arg, u32 address,
     WriteToConstRamAddress(accessSize, arg, address);
     return false;
   }
+  else if (const u32 mmio_address = PowerPC::IsOptimizableMMIOAccess(address, accessSize);
+           accessSize != 64 && mmio_address)
+  {
+    // Complex handlers may want to know which instruction triggered the write.
+    MOV(32, PPCSTATE(pc), Imm32(m_jit.js.compilerPC));
+    MMIOWriteRegToAddr(Memory::mmio_mapping.get(), arg, registersInUse, mmio_address, accessSize);
+    return false;
+  }
   else
   {
     // Helps external systems know which instruction triggered the write
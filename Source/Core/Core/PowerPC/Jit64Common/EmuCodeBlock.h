@@ -55,6 +55,11 @@ public:
 
   Gen::FixupBranch CheckIfSafeAddress(const Gen::OpArg& reg_value, Gen::X64Reg reg_addr,
                                       BitSet32 registers_in_use);
+
+  // Looks up reg_addr in PowerPC::soft_tlb. On a hit, host + reg_addr is the host address of the
+  // access. Jumps to the returned FixupBranch on a miss, and always clobbers host and tmp.
+  Gen::FixupBranch SoftTLBLookup(Gen::X64Reg reg_addr, Gen::X64Reg host, Gen::X64Reg tmp,
+                                 int access_size, bool write);
   void UnsafeLoadRegToReg(Gen::X64Reg reg_addr, Gen::X64Reg reg_value, int accessSize,
                           s32 offset = 0, bool signExtend = false);
   void UnsafeLoadRegToRegNoSwap(Gen::X64Reg reg_addr, Gen::X64Reg reg_value, int accessSize,
@@ -72,6 +77,8 @@ public:
   // call for known addresses in MMIO range (MMIO::IsMMIOAddress).
   void MMIOLoadToReg(MMIO::Mapping* mmio, Gen::X64Reg reg_value, BitSet32 registers_in_use,
                      u32 address, int access_size, bool sign_extend);
+  void MMIOWriteRegToAddr(MMIO::Mapping* mmio, const Gen::OpArg& arg, BitSet32 registers_in_use,
+                          u32 address, int access_size);
 
   enum SafeLoadStoreFlags
   {
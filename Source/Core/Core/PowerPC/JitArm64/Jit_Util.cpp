@@ -240,9 +240,23 @@ ARM64Reg ByteswapBeforeStore(ARM64XEmitter* emit, ARM64Reg tmp_reg, ARM64Reg src
   return dst_reg;
 }
 
+// Keeps the MMIO access counters accurate for accesses that never reach MMIO::Mapping.
+static void IncrementAccessCounter(ARM64XEmitter* emit, u64* counter, ARM64Reg ptr_reg,
+                                   ARM64Reg value_reg)
+{
+  emit->MOVP2R(ptr_reg, counter);
+  emit->LDR(IndexType::Unsigned, value_reg, ptr_reg, 0);
+  emit->ADD(value_reg, value_reg, 1);
+  emit->STR(IndexType::Unsigned, value_reg, ptr_reg, 0);
+}
+
 void MMIOLoadToReg(MMIO::Mapping* mmio, Arm64Gen::ARM64XEmitter* emit, BitSet32 gprs_in_use,
                    BitSet32 fprs_in_use, ARM64Reg dst_reg, u32 address, u32 flags)
 {
+  // The destination register gets overwritten by the load anyway.
+  if (u64* counter = mmio->GetReadCounter(address))
+    IncrementAccessCounter(emit, counter, ARM64Reg::X0, EncodeRegTo64(dst_reg));
+
   if (flags & BackPatchInfo::FLAG_SIZE_8)
   {
     MMIOReadCodeGenerator<u8> gen(emit, gprs_in_use, fprs_in_use, dst_reg, address,
@@ -268,6 +282,9 @@ void MMIOLoadToReg(MMIO::Mapping* mmio, Arm64Gen::ARM64XEmitter* emit, BitSet32
 void MMIOWriteRegToAddr(MMIO::Mapping* mmio, Arm64Gen::ARM64XEmitter* emit, BitSet32 gprs_in_use,
                         BitSet32 fprs_in_use, ARM64Reg src_reg, u32 address, u32 flags)
 {
+  if (u64* counter = mmio->GetWriteCounter(address))
+    IncrementAccessCounter(emit, counter, ARM64Reg::X0, ARM64Reg::X1);
+
   src_reg = ByteswapBeforeStore(emit, ARM64Reg::W1, src_reg, flags, false);
 
   if (flags & BackPatchInfo::FLAG_SIZE_8)
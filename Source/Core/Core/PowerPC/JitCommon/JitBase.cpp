@@ -43,7 +43,9 @@ bool JitBase::CanMergeNextInstructions(int count) const
 
 void JitBase::UpdateMemoryOptions()
 {
+  // Memory watched by memchecks is protected in the fastmem arena, so accesses to it fault and
+  // get backpatched to the slow path, which evaluates the memchecks.
   bool any_watchpoints = PowerPC::memchecks.HasAny();
-  jo.fastmem = SConfig::GetInstance().bFastmem && jo.fastmem_arena && (MSR.DR || !any_watchpoints);
+  jo.fastmem = SConfig::GetInstance().bFastmem && jo.fastmem_arena;
   jo.memcheck = SConfig::GetInstance().bMMU || any_watchpoints;
 }
@@ -62,6 +62,7 @@ protected:
     bool accurateSinglePrecision;
     bool fastmem;
     bool fastmem_arena;
+    bool soft_tlb;
     bool memcheck;
     bool profile_blocks;
   };
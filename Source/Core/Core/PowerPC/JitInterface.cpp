@@ -8,6 +8,7 @@
 #include <cstdio>
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -23,6 +24,8 @@
 #include "Common/MsgHandler.h"
 
 #include "Core/Core.h"
+#include "Core/HW/MMIO.h"
+#include "Core/HW/Memmap.h"
 #include "Core/PowerPC/CPUCoreBase.h"
 #include "Core/PowerPC/CachedInterpreter/CachedInterpreter.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
@@ -86,10 +89,17 @@ CPUCoreBase* GetCore()
 
 void SetProfilingState(ProfilingState state)
 {
-  if (!g_jit)
-    return;
+  // The JIT'd code reads both the profiling option and the MMIO access counters, so only change
+  // them while the CPU thread is paused, and recompile everything with the new option.
+  Core::RunAsCPUThread([state] {
+    if (!g_jit)
+      return;
 
-  g_jit->jo.profile_blocks = state == ProfilingState::Enabled;
+    g_jit->ClearCache();
+    g_jit->jo.profile_blocks = state == ProfilingState::Enabled;
+    if (Memory::mmio_mapping)
+      Memory::mmio_mapping->SetAccessCountingEnabled(g_jit->jo.profile_blocks);
+  });
 }
 
 void WriteProfileResults(const std::string& filename)
@@ -117,6 +127,18 @@ void WriteProfileResults(const std::string& filename)
                                   static_cast<double>(prof_stats.countsPerSec),
                               stat.block_size));
   }
+
+  std::vector<MMIO::Mapping::AccessCount> mmio_counts;
+  Core::RunAsCPUThread([&mmio_counts] {
+    if (Memory::mmio_mapping)
+      mmio_counts = Memory::mmio_mapping->GetAccessCounts();
+  });
+  if (mmio_counts.empty())
+    return;
+
+  f.WriteString("\nmmioAddr\treads\twrites\n");
+  for (const auto& count : mmio_counts)
+    f.WriteString(fmt::format("{:08x}\t{}\t{}\n", count.address, count.reads, count.writes));
 }
 
 void GetProfileResults(Profiler::ProfileStats* prof_stats)
@@ -188,6 +210,20 @@ int GetHostCode(u32* address, const u8** code, u32* code_size)
 
 bool HandleFault(uintptr_t access_address, SContext* ctx)
 {
+  // Pages waiting for EFB copies are unprotected once the copies are written, after which the
+  // access can simply be retried.
+  if (Memory::HandleFault(access_address))
+    return true;
+
+  // Page table translated pages are mapped on their first access, after which it can be retried.
+  const uintptr_t logical_offset =
+      access_address - reinterpret_cast<uintptr_t>(Memory::logical_base);
+  if (Memory::logical_base && logical_offset < 0x100000000 &&
+      PowerPC::MapPageTableEntryOnFault(static_cast<u32>(logical_offset)))
+  {
+    return true;
+  }
+
   // Prevent nullptr dereference on a crash with no JIT present
   if (!g_jit)
   {
@@ -6,6 +6,7 @@
 #include <cassert>
 #include <cstddef>
 #include <cstring>
+#include <optional>
 #include <string>
 
 #include "Common/Assert.h"
@@ -170,9 +171,66 @@ static void EFB_Write(u32 data, u32 addr)
 
 BatTable ibat_table;
 BatTable dbat_table;
+SoftTLB soft_tlb;
 
 static void GenerateDSIException(u32 effective_address, bool write);
 
+static u8* GetHostPagePointer(u32 physical_address)
+{
+  // Must match the memory regions that ReadFromHardware and WriteToHardware access directly.
+  if (Memory::m_pRAM && (physical_address & 0xF8000000) == 0x00000000)
+    return &Memory::m_pRAM[physical_address & Memory::GetRamMask()];
+  if (Memory::m_pEXRAM && (physical_address >> 28) == 0x1 &&
+      (physical_address & 0x0FFFFFFF) < Memory::GetExRamSizeReal())
+  {
+    return &Memory::m_pEXRAM[physical_address & 0x0FFFFFFF];
+  }
+  if (Memory::m_pL1Cache && (physical_address >> 28) == 0xE &&
+      (physical_address < (0xE0000000 + Memory::GetL1CacheSize())))
+  {
+    return &Memory::m_pL1Cache[physical_address & 0x0FFFFFFF];
+  }
+  if (Memory::m_pFakeVMEM && ((physical_address & 0xFE000000) == 0x7E000000))
+    return &Memory::m_pFakeVMEM[physical_address & Memory::GetFakeVMemMask()];
+  return nullptr;
+}
+
+template <XCheckTLBFlag flag>
+static void UpdateSoftTLB(u32 em_address, const TranslateAddressResult& translated_addr)
+{
+  static_assert(flag == XCheckTLBFlag::Read || flag == XCheckTLBFlag::Write);
+
+  const u32 em_page = em_address & ~(HW_PAGE_SIZE - 1);
+  SoftTLBEntry& entry = soft_tlb[(em_address >> SOFT_TLB_INDEX_SHIFT) & (SOFT_TLB_SIZE - 1)];
+  u32& tag = flag == XCheckTLBFlag::Write ? entry.write_tag : entry.read_tag;
+  if (tag == em_page)
+    return;
+
+  // Write-through and cache-inhibited memory has quirks that only the slow path emulates.
+  if (translated_addr.wi)
+    return;
+
+  u8* host_page = GetHostPagePointer(translated_addr.address & ~(HW_PAGE_SIZE - 1));
+  if (!host_page || PowerPC::memchecks.OverlapsMemcheck(em_page, HW_PAGE_SIZE))
+    return;
+
+  u8* host_base = reinterpret_cast<u8*>(reinterpret_cast<uintptr_t>(host_page) - em_page);
+  if (entry.host_base != host_base ||
+      (entry.read_tag != em_page && entry.read_tag != SOFT_TLB_INVALID_TAG) ||
+      (entry.write_tag != em_page && entry.write_tag != SOFT_TLB_INVALID_TAG))
+  {
+    entry.read_tag = SOFT_TLB_INVALID_TAG;
+    entry.write_tag = SOFT_TLB_INVALID_TAG;
+    entry.host_base = host_base;
+  }
+  tag = em_page;
+}
+
+static void ClearSoftTLB()
+{
+  soft_tlb.fill({SOFT_TLB_INVALID_TAG, SOFT_TLB_INVALID_TAG, nullptr});
+}
+
 template <XCheckTLBFlag flag, typename T, bool never_translate = false>
 static T ReadFromHardware(u32 em_address)
 {
@@ -209,6 +267,8 @@ static T ReadFromHardware(u32 em_address)
       }
       return var;
     }
+    if constexpr (flag == XCheckTLBFlag::Read)
+      UpdateSoftTLB<flag>(em_address, translated_addr);
     em_address = translated_addr.address;
   }
 
@@ -219,6 +279,8 @@ static T ReadFromHardware(u32 em_address)
     // Handle RAM; the masking intentionally discards bits (essentially creating
     // mirrors of memory).
     // TODO: Only the first GetRamSizeReal() is supposed to be backed by actual memory.
+    if constexpr (flag == XCheckTLBFlag::Read)
+      Memory::WaitForGPUWrites(em_address & Memory::GetRamMask(), sizeof(T));
     T value;
     std::memcpy(&value, &Memory::m_pRAM[em_address & Memory::GetRamMask()], sizeof(T));
     return bswap(value);
@@ -227,6 +289,8 @@ static T ReadFromHardware(u32 em_address)
   if (Memory::m_pEXRAM && (em_address >> 28) == 0x1 &&
       (em_address & 0x0FFFFFFF) < Memory::GetExRamSizeReal())
   {
+    if constexpr (flag == XCheckTLBFlag::Read)
+      Memory::WaitForGPUWrites(em_address, sizeof(T));
     T value;
     std::memcpy(&value, &Memory::m_pEXRAM[em_address & 0x0FFFFFFF], sizeof(T));
     return bswap(value);
@@ -293,6 +357,8 @@ static void WriteToHardware(u32 em_address, const u32 data, const u32 size)
         GenerateDSIException(em_address, true);
       return;
     }
+    if constexpr (flag == XCheckTLBFlag::Write)
+      UpdateSoftTLB<flag>(em_address, translated_addr);
     em_address = translated_addr.address;
     wi = translated_addr.wi;
   }
@@ -392,6 +458,8 @@ static void WriteToHardware(u32 em_address, const u32 data, const u32 size)
   {
     // Handle RAM; the masking intentionally discards bits (essentially creating
     // mirrors of memory).
+    if constexpr (flag == XCheckTLBFlag::Write)
+      Memory::WaitForGPUWrites(em_address & Memory::GetRamMask(), size);
     std::memcpy(&Memory::m_pRAM[em_address & Memory::GetRamMask()], &swapped_data, size);
     return;
   }
@@ -399,6 +467,8 @@ static void WriteToHardware(u32 em_address, const u32 data, const u32 size)
   if (Memory::m_pEXRAM && (em_address >> 28) == 0x1 &&
       (em_address & 0x0FFFFFFF) < Memory::GetExRamSizeReal())
   {
+    if constexpr (flag == XCheckTLBFlag::Write)
+      Memory::WaitForGPUWrites(em_address, size);
     std::memcpy(&Memory::m_pEXRAM[em_address & 0x0FFFFFFF], &swapped_data, size);
     return;
   }
@@ -861,16 +931,13 @@ TryReadResult<std::string> HostTryReadString(u32 address, size_t size, Requested
 
 bool IsOptimizableRAMAddress(const u32 address)
 {
-  if (PowerPC::memchecks.HasAny())
-    return false;
-
   if (!MSR.DR)
     return false;
 
   // TODO: This API needs to take an access size
   //
   // We store whether an access can be optimized to an unchecked access
-  // in dbat_table.
+  // in dbat_table. Blocks that overlap a memcheck never have BAT_PHYSICAL_BIT set.
   u32 bat_result = dbat_table[address >> BAT_INDEX_SHIFT];
   return (bat_result & BAT_PHYSICAL_BIT) != 0;
 }
@@ -982,6 +1049,8 @@ void DMA_LCToMemory(const u32 mem_address, const u32 cache_address, const u32 nu
   if (dst == nullptr)
     return;
 
+  Memory::WaitForGPUWrites(mem_address, 32 * num_blocks);
+
   memcpy(dst, src, 32 * num_blocks);
 }
 
@@ -1017,6 +1086,7 @@ void DMA_MemoryToLC(const u32 cache_address, const u32 mem_address, const u32 nu
   if (src == nullptr)
     return;
 
+  Memory::WaitForGPUWrites(mem_address, 32 * num_blocks);
   memcpy(dst, src, 32 * num_blocks);
 }
 
@@ -1225,6 +1295,44 @@ static void GenerateISIException(u32 effective_address)
   WARN_LOG_FMT(POWERPC, "ISI exception at {:#010x}", PC);
 }
 
+static bool IsFastmemPhysicalAddress(u32 physical_address)
+{
+  if (Memory::m_pFakeVMEM && (physical_address & 0xFE000000) == 0x7E000000)
+    return true;
+  if (physical_address < Memory::GetRamSizeReal())
+    return true;
+  if (Memory::m_pEXRAM && physical_address >> 28 == 0x1 &&
+      (physical_address & 0x0FFFFFFF) < Memory::GetExRamSizeReal())
+  {
+    return true;
+  }
+  return physical_address >> 28 == 0xE && physical_address < 0xE0000000 + Memory::GetL1CacheSize();
+}
+
+// Maps a page translated through the page table into the logical fastmem region, if fastmem
+// accesses to it would behave exactly like the slow path does. Returns whether a new mapping was
+// created.
+static bool MapPageTableEntry(u32 logical_address, UPTE2 PTE2)
+{
+  // BATs take priority over the page table.
+  if (dbat_table[logical_address >> BAT_INDEX_SHIFT] & BAT_MAPPED_BIT)
+    return false;
+
+  // Fastmem can't update the referenced and changed bits, so only pages which already have them
+  // set can be mapped. The slow path sets them on the first write to the page.
+  if (!PTE2.R || !PTE2.C)
+    return false;
+
+  // Same restrictions as for BATs: no uncached memory, no memchecks.
+  const u32 physical_address = PTE2.RPN << HW_PAGE_INDEX_SHIFT;
+  if ((PTE2.WIMG & 0b1100) != 0 || !IsFastmemPhysicalAddress(physical_address))
+    return false;
+  if (PowerPC::memchecks.OverlapsMemcheck(logical_address, HW_PAGE_SIZE))
+    return false;
+
+  return Memory::AddPageTableMapping(logical_address, physical_address);
+}
+
 void SDRUpdated()
 {
   u32 htabmask = SDR1_HTABMASK(PowerPC::ppcState.spr[SPR_SDR]);
@@ -1241,6 +1349,18 @@ void SDRUpdated()
 
   PowerPC::ppcState.pagetable_base = htaborg << 16;
   PowerPC::ppcState.pagetable_hashmask = ((htabmask << 10) | 0x3ff);
+
+  ClearSoftTLB();
+  Memory::ClearPageTableMappings();
+}
+
+void SRUpdated(u32 index)
+{
+  // The fastmem mappings are keyed by effective address, so the old VSID's pages have to go. The
+  // pages of the new VSID get mapped once they are accessed.
+  ClearSoftTLB();
+  if (Memory::CanMapPageTableEntries())
+    Memory::RemovePageTableMappingsInSegment(index);
 }
 
 enum class TLBLookupResult
@@ -1332,6 +1452,52 @@ void InvalidateTLBEntry(u32 address)
   TLBEntry& tlbe_i = ppcState.tlb[1][entry_index];
   tlbe_i.tag[0] = TLBEntry::INVALID_TAG;
   tlbe_i.tag[1] = TLBEntry::INVALID_TAG;
+
+  SoftTLBEntry& soft_tlbe = soft_tlb[(address >> SOFT_TLB_INDEX_SHIFT) & (SOFT_TLB_SIZE - 1)];
+  soft_tlbe.read_tag = SOFT_TLB_INVALID_TAG;
+  soft_tlbe.write_tag = SOFT_TLB_INVALID_TAG;
+
+  // The PTE for this page may have changed. The page is mapped again the next time it is accessed.
+  // tlbie only specifies the page index, not the segment.
+  if (Memory::CanMapPageTableEntries())
+  {
+    for (u32 segment = 0; segment < 16; ++segment)
+      Memory::RemovePageTableMapping((segment << 28) | (address & 0x0ffff000));
+  }
+}
+
+// Walks the page table for an effective address in an ordinary segment. Returns the physical
+// address of the first word of the matching PTE, if there is one.
+static std::optional<u32> FindPageTableEntry(u32 address)
+{
+  u32 sr = PowerPC::ppcState.sr[EA_SR(address)];
+  u32 page_index = EA_PageIndex(address);  // 16 bit
+  u32 VSID = SR_VSID(sr);                  // 24 bit
+  u32 api = EA_API(address);               //  6 bit (part of page_index)
+
+  // hash function no 1 "xor" .360
+  u32 hash = (VSID ^ page_index);
+  u32 pte1 = (VSID << 7) | api | PTE1_V;
+
+  for (int hash_func = 0; hash_func < 2; hash_func++)
+  {
+    // hash function no 2 "not" .360
+    if (hash_func == 1)
+    {
+      hash = ~hash;
+      pte1 |= PTE1_H;
+    }
+
+    u32 pteg_addr =
+        ((hash & PowerPC::ppcState.pagetable_hashmask) << 6) | PowerPC::ppcState.pagetable_base;
+
+    for (int i = 0; i < 8; i++, pteg_addr += 8)
+    {
+      if (Memory::Read_U32(pteg_addr) == pte1)
+        return pteg_addr;
+    }
+  }
+  return std::nullopt;
 }
 
 // Page Address Translation
@@ -1361,71 +1527,77 @@ static TranslateAddressResult TranslatePageAddress(const u32 address, const XChe
     return TranslateAddressResult{TranslateAddressResultEnum::PAGE_FAULT, 0};
   }
 
-  u32 offset = EA_Offset(address);         // 12 bit
-  u32 page_index = EA_PageIndex(address);  // 16 bit
-  u32 VSID = SR_VSID(sr);                  // 24 bit
-  u32 api = EA_API(address);               //  6 bit (part of page_index)
+  const std::optional<u32> pteg_addr = FindPageTableEntry(address);
+  if (!pteg_addr)
+    return TranslateAddressResult{TranslateAddressResultEnum::PAGE_FAULT, 0};
 
-  // hash function no 1 "xor" .360
-  u32 hash = (VSID ^ page_index);
-  u32 pte1 = (VSID << 7) | api | PTE1_V;
+  UPTE2 PTE2;
+  PTE2.Hex = Memory::Read_U32(*pteg_addr + 4);
 
-  for (int hash_func = 0; hash_func < 2; hash_func++)
+  // set the access bits
+  switch (flag)
   {
-    // hash function no 2 "not" .360
-    if (hash_func == 1)
-    {
-      hash = ~hash;
-      pte1 |= PTE1_H;
-    }
-
-    u32 pteg_addr =
-        ((hash & PowerPC::ppcState.pagetable_hashmask) << 6) | PowerPC::ppcState.pagetable_base;
+  case XCheckTLBFlag::NoException:
+  case XCheckTLBFlag::OpcodeNoException:
+    break;
+  case XCheckTLBFlag::Read:
+    PTE2.R = 1;
+    break;
+  case XCheckTLBFlag::Write:
+    PTE2.R = 1;
+    PTE2.C = 1;
+    break;
+  case XCheckTLBFlag::Opcode:
+    PTE2.R = 1;
+    break;
+  }
 
-    for (int i = 0; i < 8; i++, pteg_addr += 8)
-    {
-      const u32 pteg = Memory::Read_U32(pteg_addr);
+  if (!IsNoExceptionFlag(flag))
+  {
+    Memory::Write_U32(PTE2.Hex, *pteg_addr + 4);
+    MapPageTableEntry(address & ~(HW_PAGE_SIZE - 1), PTE2);
+  }
 
-      if (pte1 == pteg)
-      {
-        UPTE2 PTE2;
-        PTE2.Hex = Memory::Read_U32(pteg_addr + 4);
+  // We already updated the TLB entry if this was caused by a C bit.
+  if (res != TLBLookupResult::UpdateC)
+    UpdateTLBEntry(flag, PTE2, address);
 
-        // set the access bits
-        switch (flag)
-        {
-        case XCheckTLBFlag::NoException:
-        case XCheckTLBFlag::OpcodeNoException:
-          break;
-        case XCheckTLBFlag::Read:
-          PTE2.R = 1;
-          break;
-        case XCheckTLBFlag::Write:
-          PTE2.R = 1;
-          PTE2.C = 1;
-          break;
-        case XCheckTLBFlag::Opcode:
-          PTE2.R = 1;
-          break;
-        }
+  *wi = (PTE2.WIMG & 0b1100) != 0;
 
-        if (!IsNoExceptionFlag(flag))
-        {
-          Memory::Write_U32(PTE2.Hex, pteg_addr + 4);
-        }
+  return TranslateAddressResult{TranslateAddressResultEnum::PAGE_TABLE_TRANSLATED,
+                                (PTE2.RPN << 12) | EA_Offset(address)};
+}
 
-        // We already updated the TLB entry if this was caused by a C bit.
-        if (res != TLBLookupResult::UpdateC)
-          UpdateTLBEntry(flag, PTE2, address);
+bool MapPageTableEntryOnFault(u32 address)
+{
+  if (!MSR.DR || !Memory::CanMapPageTableEntries())
+    return false;
 
-        *wi = (PTE2.WIMG & 0b1100) != 0;
+  const u32 sr = PowerPC::ppcState.sr[EA_SR(address)];
+  if (sr & 0x80000000)
+    return false;
 
-        return TranslateAddressResult{TranslateAddressResultEnum::PAGE_TABLE_TRANSLATED,
-                                      (PTE2.RPN << 12) | offset};
-      }
-    }
+  // Like the slow path, prefer the translation the TLB already has.
+  const u32 tag = address >> HW_PAGE_INDEX_SHIFT;
+  const TLBEntry& tlbe = ppcState.tlb[0][tag & HW_PAGE_INDEX_MASK];
+  UPTE2 PTE2;
+  if (tlbe.tag[0] == tag)
+  {
+    PTE2.Hex = tlbe.pte[0];
+  }
+  else if (tlbe.tag[1] == tag)
+  {
+    PTE2.Hex = tlbe.pte[1];
+  }
+  else
+  {
+    const std::optional<u32> pteg_addr = FindPageTableEntry(address);
+    if (!pteg_addr)
+      return false;
+    PTE2.Hex = Memory::Read_U32(*pteg_addr + 4);
   }
-  return TranslateAddressResult{TranslateAddressResultEnum::PAGE_FAULT, 0};
+
+  return MapPageTableEntry(address & ~(HW_PAGE_SIZE - 1), PTE2);
 }
 
 static void UpdateBATs(BatTable& bat_table, u32 base_spr)
@@ -1479,6 +1651,8 @@ static void UpdateBATs(BatTable& bat_table, u32 base_spr)
         // BAT_MAPPED_BIT is whether the translation is valid
         // BAT_PHYSICAL_BIT is whether we can use the fastmem arena
         // BAT_WI_BIT is whether either W or I (of WIMG) is set
+        // BAT_MEMCHECK_BIT is whether the block is mapped into the fastmem arena with only the
+        // host pages covered by memchecks protected, instead of using the fastmem arena freely
         u32 valid_bit = BAT_MAPPED_BIT;
 
         const bool wi = (batl.WIMG & 0b1100) != 0;
@@ -1487,32 +1661,17 @@ static void UpdateBATs(BatTable& bat_table, u32 base_spr)
 
         // Enable fastmem mappings for cached memory. There are quirks related to uncached memory
         // that fastmem doesn't emulate properly (though no normal games are known to rely on them).
-        if (!wi)
+        if (!wi && IsFastmemPhysicalAddress(physical_address))
+          valid_bit |= BAT_PHYSICAL_BIT;
+
+        // Code that assumes the whole block is fastmem accessible (dcbz, IsOptimizableRAMAddress)
+        // can't handle memchecks, so only allow accesses that can be backpatched on a fault.
+        if ((valid_bit & BAT_PHYSICAL_BIT) != 0 &&
+            PowerPC::memchecks.OverlapsMemcheck(virtual_address, BAT_PAGE_SIZE))
         {
-          if (Memory::m_pFakeVMEM && (physical_address & 0xFE000000) == 0x7E000000)
-          {
-            valid_bit |= BAT_PHYSICAL_BIT;
-          }
-          else if (physical_address < Memory::GetRamSizeReal())
-          {
-            valid_bit |= BAT_PHYSICAL_BIT;
-          }
-          else if (Memory::m_pEXRAM && physical_address >> 28 == 0x1 &&
-                   (physical_address & 0x0FFFFFFF) < Memory::GetExRamSizeReal())
-          {
-            valid_bit |= BAT_PHYSICAL_BIT;
-          }
-          else if (physical_address >> 28 == 0xE &&
-                   physical_address < 0xE0000000 + Memory::GetL1CacheSize())
-          {
-            valid_bit |= BAT_PHYSICAL_BIT;
-          }
+          valid_bit ^= BAT_PHYSICAL_BIT | BAT_MEMCHECK_BIT;
         }
 
-        // Fastmem doesn't support memchecks, so disable it for all overlapping virtual pages.
-        if (PowerPC::memchecks.OverlapsMemcheck(virtual_address, BAT_PAGE_SIZE))
-          valid_bit &= ~BAT_PHYSICAL_BIT;
-
         // (BEPI | j) == (BEPI & ~BL) | (j & BL).
         bat_table[virtual_address >> BAT_INDEX_SHIFT] = physical_address | valid_bit;
       }
@@ -1531,7 +1690,7 @@ static void UpdateFakeMMUBat(BatTable& bat_table, u32 start_addr)
     u32 flags = BAT_MAPPED_BIT | BAT_PHYSICAL_BIT;
 
     if (PowerPC::memchecks.OverlapsMemcheck(e_address << BAT_INDEX_SHIFT, BAT_PAGE_SIZE))
-      flags &= ~BAT_PHYSICAL_BIT;
+      flags ^= BAT_PHYSICAL_BIT | BAT_MEMCHECK_BIT;
 
     bat_table[e_address] = p_address | flags;
   }
@@ -1540,6 +1699,7 @@ static void UpdateFakeMMUBat(BatTable& bat_table, u32 start_addr)
 void DBATUpdated()
 {
   dbat_table = {};
+  ClearSoftTLB();
   UpdateBATs(dbat_table, SPR_DBAT0U);
   bool extended_bats = SConfig::GetInstance().bWii && HID4.SBE;
   if (extended_bats)
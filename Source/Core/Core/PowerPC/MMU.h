@@ -176,7 +176,12 @@ void ClearCacheLine(u32 address);  // Zeroes 32 bytes; address should be 32-byte
 
 // TLB functions
 void SDRUpdated();
+void SRUpdated(u32 index);
 void InvalidateTLBEntry(u32 address);
+// Page table translated pages are only mapped into the logical fastmem region once they are
+// accessed. Returns whether the page containing the address was mapped just now, in which case a
+// faulting access to it can be retried.
+bool MapPageTableEntryOnFault(u32 address);
 void DBATUpdated();
 void IBATUpdated();
 
@@ -208,10 +213,28 @@ constexpr u32 BAT_PAGE_SIZE = 1 << BAT_INDEX_SHIFT;
 constexpr u32 BAT_MAPPED_BIT = 0x1;
 constexpr u32 BAT_PHYSICAL_BIT = 0x2;
 constexpr u32 BAT_WI_BIT = 0x4;
-constexpr u32 BAT_RESULT_MASK = UINT32_C(~0x7);
+constexpr u32 BAT_MEMCHECK_BIT = 0x8;
+constexpr u32 BAT_RESULT_MASK = UINT32_C(~0xf);
 using BatTable = std::array<u32, 1 << (32 - BAT_INDEX_SHIFT)>;  // 128 KB
 extern BatTable ibat_table;
 extern BatTable dbat_table;
+
+// A small direct-mapped cache of data translations that end in host memory, which the JIT can
+// look up inline instead of calling the MMU functions. Entries are filled by the slow path and
+// only exist for pages where a direct access behaves exactly like the slow path would (cached,
+// no memchecks, R/C bits already up to date). host_base is the host pointer of the page minus
+// the effective address of the page, so the host address is host_base + effective address.
+struct SoftTLBEntry
+{
+  u32 read_tag;
+  u32 write_tag;
+  u8* host_base;
+};
+constexpr u32 SOFT_TLB_INDEX_SHIFT = 12;
+constexpr u32 SOFT_TLB_SIZE = 1024;
+constexpr u32 SOFT_TLB_INVALID_TAG = 0xffffffff;
+using SoftTLB = std::array<SoftTLBEntry, SOFT_TLB_SIZE>;  // 16 KB
+extern SoftTLB soft_tlb;
 inline bool TranslateBatAddess(const BatTable& bat_table, u32* address, bool* wi)
 {
   u32 bat_result = bat_table[*address >> BAT_INDEX_SHIFT];
@@ -521,9 +521,6 @@ void PPCAnalyzer::ReorderInstructions(u32 instructions, CodeOp* code)
 void PPCAnalyzer::SetInstructionStats(CodeBlock* block, CodeOp* code, const GekkoOPInfo* opinfo,
                                       u32 index)
 {
-  code->wantsCR0 = false;
-  code->wantsCR1 = false;
-
   if (opinfo->flags & FL_USE_FPU)
     block->m_fpa->any = true;
 
@@ -546,6 +543,43 @@ void PPCAnalyzer::SetInstructionStats(CodeBlock* block, CodeOp* code, const Gekk
   else
     code->outputCR1 = (opinfo->flags & FL_SET_CR1) != 0;
 
+  code->crIn = BitSet8{};
+  code->crOut = BitSet8{};
+  if (code->outputCR0)
+    code->crOut[0] = true;
+  if (code->outputCR1)
+    code->crOut[1] = true;
+  if (code->inst.OPCD == 31 && code->inst.SUBOP10 == 144)  // mtcrf
+  {
+    for (u32 i = 0; i < 8; i++)
+      code->crOut[i] = (code->inst.CRM & (0x80 >> i)) != 0;
+  }
+  else if (opinfo->flags & FL_SET_CRn)
+  {
+    code->crOut[code->inst.CRFD] = true;
+  }
+
+  if (code->inst.OPCD == 31 && code->inst.SUBOP10 == 19)  // mfcr
+  {
+    code->crIn = BitSet8::AllTrue(8);
+  }
+  else if (code->inst.OPCD == 19 && code->inst.SUBOP10 == 0)  // mcrf
+  {
+    code->crIn[code->inst.CRFS] = true;
+  }
+  else if (opinfo->type == OpType::CR)  // crand, cror, ...
+  {
+    // Only one bit of the destination field is written, so the rest of it is passed through.
+    code->crIn[code->inst.CRBA >> 2] = true;
+    code->crIn[code->inst.CRBB >> 2] = true;
+    code->crIn[code->inst.CRBD >> 2] = true;
+    code->crOut[code->inst.CRBD >> 2] = true;
+  }
+  else if (opinfo->type == OpType::Branch && code->inst.OPCD != 18 && !(code->inst.BO & 0x10))
+  {
+    code->crIn[code->inst.BI >> 2] = true;
+  }
+
   code->wantsFPRF = (opinfo->flags & FL_READ_FPRF) != 0;
   code->outputFPRF = (opinfo->flags & FL_SET_FPRF) != 0;
   code->canEndBlock = (opinfo->flags & FL_ENDBLOCK) != 0;
@@ -680,52 +714,73 @@ void PPCAnalyzer::SetInstructionStats(CodeBlock* block, CodeOp* code, const Gekk
 bool PPCAnalyzer::IsBusyWaitLoop(CodeBlock* block, CodeOp* code, size_t instructions)
 {
   // Very basic algorithm to detect busy wait loops:
-  //   * It loops to itself and does not contain any other branches.
-  //   * It does not write to memory.
-  //   * It only reads from registers it wrote to earlier in the loop, or it
-  //     does not write to these registers.
+  //   * It loops to itself and does not contain any other branches that loop.
+  //   * It does not write to memory or to any other state outside of the registers, CR fields and
+  //     carry flag. Memory barriers are fine, since they have no effect on the emulated state.
+  //   * It only reads from registers (including CR fields and the carry flag) it wrote to earlier
+  //     in the loop, or it does not write to these registers.
   //
-  // Would benefit a lot from basic inlining support - a lot of the most
-  // used busy loops are DSP register interactions, which are bl/cmp/bne
-  // (with the bl target a pure function that follows the above rules). We
-  // don't detect these at the moment.
+  // Such a loop computes the same result every iteration until memory or MMIO registers change,
+  // which can only happen through a CoreTiming event, so it is safe to skip ahead to that event.
+  // Calls to pure functions are also handled when branch following inlines them into the block,
+  // which is how a lot of the most used busy loops (DSP/VI/SI register polling) look.
   std::bitset<32> write_disallowed_regs;
   std::bitset<32> written_regs;
+  BitSet8 write_disallowed_cr;
+  BitSet8 written_cr;
+  bool write_disallowed_ca = false;
+  bool written_ca = false;
+
   for (size_t i = 0; i <= instructions; ++i)
   {
-    if (code[i].opinfo->type == OpType::Branch)
+    const CodeOp& op = code[i];
+
+    if (op.opinfo->type == OpType::Branch)
     {
-      if (code[i].branchUsesCtr)
+      if (op.branchUsesCtr)
+        return false;
+    }
+    else if (op.opinfo->type == OpType::System)
+    {
+      if (op.inst.OPCD != 31 || (op.inst.SUBOP10 != 598 && op.inst.SUBOP10 != 854))  // sync, eieio
         return false;
-      if (code[i].branchTo == block->m_address && i == instructions)
-        return true;
     }
-    else if (code[i].opinfo->type != OpType::Integer && code[i].opinfo->type != OpType::Load)
+    else if (op.opinfo->type != OpType::Integer && op.opinfo->type != OpType::Load &&
+             op.opinfo->type != OpType::CR)
     {
       // In the future, some subsets of other instruction types might get
       // supported. Right now, only try loops that have this very
       // restricted instruction set.
       return false;
     }
-    else
+
+    for (int reg : op.regsIn)
     {
-      for (int reg : code[i].regsIn)
-      {
-        if (reg == -1)
-          continue;
-        if (written_regs[reg])
-          continue;
+      if (!written_regs[reg])
         write_disallowed_regs[reg] = true;
-      }
-      for (int reg : code[i].regsOut)
-      {
-        if (reg == -1)
-          continue;
-        if (write_disallowed_regs[reg])
-          return false;
-        written_regs[reg] = true;
-      }
     }
+    write_disallowed_cr |= op.crIn & ~written_cr;
+    if (op.wantsCA && !written_ca)
+      write_disallowed_ca = true;
+
+    for (int reg : op.regsOut)
+    {
+      if (write_disallowed_regs[reg])
+        return false;
+      written_regs[reg] = true;
+    }
+    if (op.crOut & write_disallowed_cr)
+      return false;
+    written_cr |= op.crOut;
+    if (op.outputCA)
+    {
+      if (write_disallowed_ca)
+        return false;
+      written_ca = true;
+    }
+
+    if (op.opinfo->type == OpType::Branch && op.branchTo == block->m_address && i == instructions)
+      return true;
   }
   return false;
 }
@@ -918,28 +973,26 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, std:
 
   // Scan for flag dependencies; assume the next block (or any branch that can leave the block)
   // wants flags, to be safe.
-  bool wantsCR0 = true, wantsCR1 = true, wantsFPRF = true, wantsCA = true;
+  bool wantsFPRF = true, wantsCA = true;
+  BitSet8 crInUse = BitSet8::AllTrue(8);
   BitSet32 fprInUse, gprInUse, gprDiscardable, fprDiscardable, fprInXmm;
   for (int i = block->m_num_instructions - 1; i >= 0; i--)
   {
     CodeOp& op = code[i];
 
-    const bool opWantsCR0 = op.wantsCR0;
-    const bool opWantsCR1 = op.wantsCR1;
     const bool opWantsFPRF = op.wantsFPRF;
     const bool opWantsCA = op.wantsCA;
-    op.wantsCR0 = wantsCR0 || op.canEndBlock;
-    op.wantsCR1 = wantsCR1 || op.canEndBlock;
     op.wantsFPRF = wantsFPRF || op.canEndBlock;
     op.wantsCA = wantsCA || op.canEndBlock;
-    wantsCR0 |= opWantsCR0 || op.canEndBlock;
-    wantsCR1 |= opWantsCR1 || op.canEndBlock;
     wantsFPRF |= opWantsFPRF || op.canEndBlock;
     wantsCA |= opWantsCA || op.canEndBlock;
-    wantsCR0 &= !op.outputCR0 || opWantsCR0;
-    wantsCR1 &= !op.outputCR1 || opWantsCR1;
     wantsFPRF &= !op.outputFPRF || opWantsFPRF;
     wantsCA &= !op.outputCA || opWantsCA;
+    // An exception leaves the block too, and the handler sees the whole CR.
+    if (op.canEndBlock || op.canCauseException)
+      crInUse = BitSet8::AllTrue(8);
+    op.crInUse = crInUse;
+    crInUse = (crInUse & ~op.crOut) | op.crIn;
     op.gprInUse = gprInUse;
     op.fprInUse = fprInUse;
     op.gprDiscardable = gprDiscardable;
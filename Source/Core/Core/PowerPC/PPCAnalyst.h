@@ -34,8 +34,6 @@ struct CodeOp  // 16B
   bool isBranchTarget;
   bool branchUsesCtr;
   bool branchIsIdleLoop;
-  bool wantsCR0;
-  bool wantsCR1;
   bool wantsFPRF;
   bool wantsCA;
   bool wantsCAInFlags;
@@ -47,6 +45,11 @@ struct CodeOp  // 16B
   bool canCauseException;
   bool skipLRStack;
   bool skip;  // followed BL-s for example
+  // which CR fields are read and (completely) overwritten by this instruction
+  BitSet8 crIn;
+  BitSet8 crOut;
+  // which CR fields are still needed after this instruction in this block
+  BitSet8 crInUse;
   // which registers are still needed after this instruction in this block
   BitSet32 fprInUse;
   BitSet32 gprInUse;
@@ -98,6 +98,7 @@ void InstructionCache::Reset()
   lookup_table.fill(0xFF);
   lookup_table_ex.fill(0xFF);
   lookup_table_vmem.fill(0xFF);
+  last_line = INVALID_LINE;
   JitInterface::ClearSafe();
 }
 
@@ -128,6 +129,8 @@ void InstructionCache::Invalidate(u32 addr)
     }
   }
   valid[set] = 0;
+  if (((last_line >> 5) & 0x7f) == set)
+    last_line = INVALID_LINE;
   JitInterface::InvalidateICacheLine(addr);
 }
 
@@ -137,9 +140,12 @@ u32 InstructionCache::ReadInstruction(u32 addr)
     return Memory::Read_U32(addr);
   u32 set = (addr >> 5) & 0x7f;
   u32 tag = addr >> 12;
+  const u32 line = addr & ~0x1f;
 
   u32 t;
-  if (addr & ICACHE_VMEM_BIT)
+  if (line == last_line)
+    t = last_way;
+  else if (addr & ICACHE_VMEM_BIT)
   {
     t = lookup_table_vmem[(addr >> 5) & 0xfffff];
   }
@@ -182,8 +188,13 @@ u32 InstructionCache::ReadInstruction(u32 addr)
     tags[set][t] = tag;
     valid[set] |= (1 << t);
   }
-  // update plru
-  plru[set] = (plru[set] & ~s_plru_mask[t]) | s_plru_value[t];
+  if (line != last_line)
+  {
+    // update plru
+    plru[set] = (plru[set] & ~s_plru_mask[t]) | s_plru_value[t];
+    last_line = line;
+    last_way = t;
+  }
   const u32 res = Common::swap32(data[set][t][(addr >> 2) & 7]);
   const u32 inmem = Memory::Read_U32(addr);
   if (res != inmem)
@@ -205,5 +216,6 @@ void InstructionCache::DoState(PointerWrap& p)
   p.DoArray(lookup_table);
   p.DoArray(lookup_table_ex);
   p.DoArray(lookup_table_vmem);
+  last_line = INVALID_LINE;
 }
 }  // namespace PowerPC
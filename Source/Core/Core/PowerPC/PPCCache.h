@@ -30,6 +30,14 @@ struct InstructionCache
   std::array<u8, 1 << 21> lookup_table_ex;
   std::array<u8, 1 << 20> lookup_table_vmem;
 
+  // The most recently fetched cache line and the way holding it. Consecutive
+  // fetches almost always hit the same line, and for those the lookup tables
+  // and the PLRU update (which is idempotent for a repeated way) can be skipped.
+  // Not part of the savestate; it is rebuilt on the next fetch.
+  u32 last_line = INVALID_LINE;
+  u32 last_way = 0;
+  static constexpr u32 INVALID_LINE = 0xFFFFFFFF;
+
   InstructionCache();
   u32 ReadInstruction(u32 addr);
   void Invalidate(u32 addr);
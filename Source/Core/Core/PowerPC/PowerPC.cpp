@@ -628,6 +628,7 @@ void PowerPCState::SetSR(u32 index, u32 value)
 {
   DEBUG_LOG_FMT(POWERPC, "{:08x}: MMU: Segment register {} set to {:08x}", pc, index, value);
   sr[index] = value;
+  SRUpdated(index);
 }
 
 // FPSCR update functions
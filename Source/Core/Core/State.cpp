@@ -73,7 +73,7 @@ static Common::Event g_compressAndDumpStateSyncEvent;
 static std::thread g_save_thread;
 
 // Don't forget to increase this after doing changes on the savestate system
-constexpr u32 STATE_VERSION = 135;  // Last changed in PR 9976
+constexpr u32 STATE_VERSION = 136;  // Last changed for DVDThread::ReadRequest::mapped_data
 
 // Maps savestate versions to Dolphin versions.
 // Versions after 42 don't need to be added to this list,
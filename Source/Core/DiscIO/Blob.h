@@ -70,6 +70,11 @@ public:
     return Common::FromBigEndian(temp);
   }
 
+  // Returns a pointer that the given range can be read from directly if the blob is backed by a
+  // memory mapped file, or nullptr otherwise. Unlike Read, this is thread-safe. The pointer stays
+  // valid for as long as the BlobReader exists.
+  virtual const u8* GetMappedData(u64 offset, u64 size) const { return nullptr; }
+
   virtual bool SupportsReadWiiDecrypted(u64 offset, u64 size, u64 partition_data_offset) const
   {
     return false;
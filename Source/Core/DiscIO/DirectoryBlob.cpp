@@ -6,6 +6,8 @@
 #include <algorithm>
 #include <array>
 #include <cstring>
+#include <ctime>
+#include <functional>
 #include <locale>
 #include <map>
 #include <memory>
@@ -15,8 +17,11 @@
 #include <variant>
 #include <vector>
 
+#include <fmt/format.h>
+
 #include "Common/Align.h"
 #include "Common/Assert.h"
+#include "Common/ChunkFile.h"
 #include "Common/CommonPaths.h"
 #include "Common/CommonTypes.h"
 #include "Common/FileUtil.h"
@@ -43,6 +48,9 @@ static void Write32(u32 data, u32 offset, std::vector<u8>* buffer);
 static u32 ComputeNameSize(const File::FSTEntry& parent_entry);
 static std::string ASCIIToUppercase(std::string str);
 static void ConvertUTF8NamesToSHIFTJIS(File::FSTEntry* parent_entry);
+static void SortFSTEntries(File::FSTEntry* parent_entry);
+
+static File::FSTEntry ScanFilesDirectory(const std::string& directory, std::string* cache_path);
 
 enum class PartitionType : u32
 {
@@ -61,6 +69,36 @@ constexpr u8 ENTRY_SIZE = 0x0c;
 constexpr u8 FILE_ENTRY = 0;
 constexpr u8 DIRECTORY_ENTRY = 1;
 
+// Increment this if the format of the directory scan cache or the way scans get processed changes
+constexpr u32 SCAN_CACHE_REVISION = 2;
+
+File::IOFile* OpenFileCache::Open(const std::string& path)
+{
+  ++m_use_counter;
+
+  Entry* least_recently_used = &m_entries[0];
+  for (Entry& entry : m_entries)
+  {
+    if (entry.file.IsOpen() && entry.path == path)
+    {
+      entry.last_used = m_use_counter;
+      return &entry.file;
+    }
+
+    if (entry.last_used < least_recently_used->last_used)
+      least_recently_used = &entry;
+  }
+
+  File::IOFile file(path, "rb");
+  if (!file)
+    return nullptr;
+
+  least_recently_used->path = path;
+  least_recently_used->file = std::move(file);
+  least_recently_used->last_used = m_use_counter;
+  return &least_recently_used->file;
+}
+
 DiscContent::DiscContent(u64 offset, u64 size, const std::string& path)
     : m_offset(offset), m_size(size), m_content_source(path)
 {
@@ -95,7 +133,7 @@ u64 DiscContent::GetSize() const
   return m_size;
 }
 
-bool DiscContent::Read(u64* offset, u64* length, u8** buffer) const
+bool DiscContent::Read(u64* offset, u64* length, u8** buffer, OpenFileCache* file_cache) const
 {
   if (m_size == 0)
     return true;
@@ -109,9 +147,15 @@ bool DiscContent::Read(u64* offset, u64* length, u8** buffer) const
 
     if (std::holds_alternative<std::string>(m_content_source))
     {
-      File::IOFile file(std::get<std::string>(m_content_source), "rb");
-      if (!file.Seek(offset_in_content, SEEK_SET) || !file.ReadBytes(*buffer, bytes_to_read))
+      File::IOFile* file = file_cache->Open(std::get<std::string>(m_content_source));
+      if (!file)
         return false;
+
+      if (!file->Seek(offset_in_content, SEEK_SET) || !file->ReadBytes(*buffer, bytes_to_read))
+      {
+        file->Clear();
+        return false;
+      }
     }
     else if (std::holds_alternative<const u8*>(m_content_source))
     {
@@ -179,8 +223,12 @@ bool DiscContentContainer::Read(u64 offset, u64 length, u8* buffer) const
     // Zero fill to start of DiscContent data
     PadToAddress(it->GetOffset(), &offset, &length, &buffer);
 
-    if (!it->Read(&offset, &length, &buffer))
+    if (!it->Read(&offset, &length, &buffer, &m_file_cache))
+    {
+      if (!m_scan_cache_path.empty())
+        File::Delete(m_scan_cache_path);
       return false;
+    }
 
     ++it;
     DEBUG_ASSERT(it == m_contents.end() || it->GetOffset() >= offset);
@@ -728,9 +776,9 @@ void DirectoryBlobPartition::BuildFST(u64 fst_address)
 {
   m_fst_data.clear();
 
-  File::FSTEntry rootEntry = File::ScanDirectoryTree(m_root_directory + "files/", true);
-
-  ConvertUTF8NamesToSHIFTJIS(&rootEntry);
+  std::string scan_cache_path;
+  const File::FSTEntry rootEntry = ScanFilesDirectory(m_root_directory + "files/", &scan_cache_path);
+  m_contents.SetScanCachePath(std::move(scan_cache_path));
 
   u32 name_table_size = Common::AlignUp(ComputeNameSize(rootEntry), 1ull << m_address_shift);
   u64 total_entries = rootEntry.size + 1;  // The root entry itself isn't counted in rootEntry.size
@@ -792,18 +840,8 @@ void DirectoryBlobPartition::WriteDirectory(const File::FSTEntry& parent_entry,
                                             u32* name_offset, u64* data_offset,
                                             u32 parent_entry_index, u64 name_table_offset)
 {
-  std::vector<File::FSTEntry> sorted_entries = parent_entry.children;
-
-  // Sort for determinism
-  std::sort(sorted_entries.begin(), sorted_entries.end(),
-            [](const File::FSTEntry& one, const File::FSTEntry& two) {
-              const std::string one_upper = ASCIIToUppercase(one.virtualName);
-              const std::string two_upper = ASCIIToUppercase(two.virtualName);
-              return one_upper == two_upper ? one.virtualName < two.virtualName :
-                                              one_upper < two_upper;
-            });
-
-  for (const File::FSTEntry& entry : sorted_entries)
+  // The entries have already been sorted by SortFSTEntries
+  for (const File::FSTEntry& entry : parent_entry.children)
   {
     if (entry.isDirectory)
     {
@@ -889,4 +927,184 @@ static std::string ASCIIToUppercase(std::string str)
   return str;
 }
 
+static void SortFSTEntries(File::FSTEntry* parent_entry)
+{
+  std::vector<File::FSTEntry>& entries = parent_entry->children;
+
+  // Sort for determinism. The uppercase names are computed up front rather than in the comparator,
+  // since directories in modded games can contain thousands of files.
+  std::vector<std::pair<std::string, size_t>> keys;
+  keys.reserve(entries.size());
+  for (size_t i = 0; i < entries.size(); ++i)
+    keys.emplace_back(ASCIIToUppercase(entries[i].virtualName), i);
+
+  std::sort(keys.begin(), keys.end(), [&entries](const auto& one, const auto& two) {
+    return one.first == two.first ?
+               entries[one.second].virtualName < entries[two.second].virtualName :
+               one.first < two.first;
+  });
+
+  std::vector<File::FSTEntry> sorted_entries;
+  sorted_entries.reserve(entries.size());
+  for (const auto& key : keys)
+    sorted_entries.push_back(std::move(entries[key.second]));
+  entries = std::move(sorted_entries);
+
+  for (File::FSTEntry& entry : entries)
+  {
+    if (entry.isDirectory)
+      SortFSTEntries(&entry);
+  }
+}
+
+namespace
+{
+struct DirectoryScanCache
+{
+  std::string directory;
+  // Modification times of every file and directory in the tree, including the root, in the order
+  // they are visited in depth first
+  std::vector<s64> modification_times;
+  File::FSTEntry root;
+};
+}  // namespace
+
+static void DoFSTEntry(PointerWrap& p, File::FSTEntry& entry)
+{
+  p.Do(entry.isDirectory);
+  p.Do(entry.size);
+  p.Do(entry.physicalName);
+  p.Do(entry.virtualName);
+  p.DoEachElement(entry.children, DoFSTEntry);
+}
+
+static void DoScanCache(PointerWrap& p, DirectoryScanCache& cache, u64 size)
+{
+  struct
+  {
+    u32 revision;
+    u64 expected_size;
+  } header = {SCAN_CACHE_REVISION, size};
+  p.Do(header);
+  if (p.GetMode() == PointerWrap::MODE_READ &&
+      (header.revision != SCAN_CACHE_REVISION || header.expected_size != size))
+  {
+    p.SetMode(PointerWrap::MODE_MEASURE);
+    return;
+  }
+
+  p.Do(cache.directory);
+  p.Do(cache.modification_times);
+  DoFSTEntry(p, cache.root);
+}
+
+static bool ReadScanCache(const std::string& path, DirectoryScanCache* cache)
+{
+  File::IOFile file(path, "rb");
+  std::vector<u8> buffer(file.GetSize());
+  if (buffer.empty() || !file.ReadBytes(buffer.data(), buffer.size()))
+    return false;
+
+  u8* ptr = buffer.data();
+  PointerWrap p(&ptr, PointerWrap::MODE_READ);
+  DoScanCache(p, *cache, buffer.size());
+  return p.GetMode() == PointerWrap::MODE_READ;
+}
+
+static void WriteScanCache(const std::string& path, DirectoryScanCache& cache)
+{
+  u8* ptr = nullptr;
+  PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
+  DoScanCache(p, cache, 0);
+  const size_t buffer_size = reinterpret_cast<size_t>(ptr);
+
+  std::vector<u8> buffer(buffer_size);
+  ptr = buffer.data();
+  p.SetMode(PointerWrap::MODE_WRITE);
+  DoScanCache(p, cache, buffer_size);
+
+  File::IOFile file;
+  if (!File::CreateFullPath(path) || !file.Open(path, "wb") ||
+      !file.WriteBytes(buffer.data(), buffer.size()))
+  {
+    ERROR_LOG_FMT(DISCIO, "Failed to write directory scan cache {}", path);
+  }
+}
+
+static void GetModificationTimes(const File::FSTEntry& entry, std::vector<s64>* times)
+{
+  times->push_back(File::FileInfo(entry.physicalName).GetModificationTime());
+
+  for (const File::FSTEntry& child : entry.children)
+    GetModificationTimes(child, times);
+}
+
+static bool IsEntryUnmodified(const File::FSTEntry& entry, const std::vector<s64>& times,
+                              size_t* index)
+{
+  if (*index >= times.size())
+    return false;
+
+  const File::FileInfo info(entry.physicalName);
+  if (info.GetModificationTime() != times[(*index)++])
+    return false;
+  if (!entry.isDirectory)
+    return info.GetSize() == entry.size;
+
+  return std::all_of(entry.children.begin(), entry.children.end(),
+                     [&](const File::FSTEntry& child) {
+                       return IsEntryUnmodified(child, times, index);
+                     });
+}
+
+static bool IsTreeUnmodified(const DirectoryScanCache& cache)
+{
+  size_t index = 0;
+  return IsEntryUnmodified(cache.root, cache.modification_times, &index) &&
+         index == cache.modification_times.size();
+}
+
+// Scanning the files directory of a large extracted game and converting every name to Shift-JIS
+// takes a while, so the sorted and converted result is cached on disk. Adding, removing or
+// renaming a file updates the modification time of its directory, and overwriting a file updates
+// its own, so the cache is considered valid as long as every file and directory in the tree still
+// has the modification time and size it had when the cache was written. Checking this only takes
+// a stat per entry, which is much cheaper than listing the directories again.
+static File::FSTEntry ScanFilesDirectory(const std::string& directory, std::string* cache_path)
+{
+  *cache_path = fmt::format("{}DirectoryBlobs/{:016x}.cache", File::GetUserPath(D_CACHE_IDX),
+                            std::hash<std::string>{}(directory));
+
+  DirectoryScanCache cache;
+  if (ReadScanCache(*cache_path, &cache) && cache.directory == directory &&
+      IsTreeUnmodified(cache))
+  {
+    INFO_LOG_FMT(DISCIO, "Using cached scan of {}", directory);
+    return std::move(cache.root);
+  }
+
+  cache.directory = directory;
+  cache.root = File::ScanDirectoryTree(directory, true);
+  ConvertUTF8NamesToSHIFTJIS(&cache.root);
+  SortFSTEntries(&cache.root);
+
+  cache.modification_times.clear();
+  GetModificationTimes(cache.root, &cache.modification_times);
+
+  // Timestamps only have a resolution of one second, so an entry that was modified very recently
+  // might get modified again without its timestamp changing. Also skip caching if the
+  // modification times aren't available, since the cache couldn't be validated.
+  const s64 now = static_cast<s64>(std::time(nullptr));
+  const bool can_cache =
+      std::all_of(cache.modification_times.begin(), cache.modification_times.end(),
+                  [now](s64 time) { return time != 0 && now - time > 1; });
+
+  if (can_cache)
+    WriteScanCache(*cache_path, cache);
+  else
+    cache_path->clear();
+
+  return std::move(cache.root);
+}
+
 }  // namespace DiscIO
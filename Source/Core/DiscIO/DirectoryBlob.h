@@ -15,13 +15,13 @@
 
 #include "Common/CommonTypes.h"
 #include "Common/FileUtil.h"
+#include "Common/IOFile.h"
 #include "DiscIO/Blob.h"
 #include "DiscIO/WiiEncryptionCache.h"
 
 namespace File
 {
 struct FSTEntry;
-class IOFile;
 }  // namespace File
 
 namespace DiscIO
@@ -33,6 +33,27 @@ class DirectoryBlobReader;
 // Returns true if the path is inside a DirectoryBlob and doesn't represent the DirectoryBlob itself
 bool ShouldHideFromGameList(const std::string& volume_path);
 
+// Keeps a bounded number of host files open, so that reading from an extracted disc doesn't
+// require opening and closing a file for every read. Like BlobReader, this isn't thread-safe.
+class OpenFileCache
+{
+public:
+  // Returns nullptr if the file couldn't be opened
+  File::IOFile* Open(const std::string& path);
+
+private:
+  struct Entry
+  {
+    std::string path;
+    File::IOFile file;
+    u64 last_used = 0;
+  };
+
+  static constexpr size_t MAX_OPEN_FILES = 16;
+  std::array<Entry, MAX_OPEN_FILES> m_entries;
+  u64 m_use_counter = 0;
+};
+
 class DiscContent
 {
 public:
@@ -52,7 +73,7 @@ public:
   u64 GetOffset() const;
   u64 GetEndOffset() const;
   u64 GetSize() const;
-  bool Read(u64* offset, u64* length, u8** buffer) const;
+  bool Read(u64* offset, u64* length, u8** buffer, OpenFileCache* file_cache) const;
 
   bool operator==(const DiscContent& other) const { return GetEndOffset() == other.GetEndOffset(); }
   bool operator!=(const DiscContent& other) const { return !(*this == other); }
@@ -83,8 +104,14 @@ public:
 
   bool Read(u64 offset, u64 length, u8* buffer) const;
 
+  // If reading a file fails, the cached directory scan that the contents were built from might be
+  // out of date, so the cache gets deleted to make the next boot scan the directory again
+  void SetScanCachePath(std::string path) { m_scan_cache_path = std::move(path); }
+
 private:
   std::set<DiscContent> m_contents;
+  mutable OpenFileCache m_file_cache;
+  std::string m_scan_cache_path;
 };
 
 class DirectoryBlobPartition
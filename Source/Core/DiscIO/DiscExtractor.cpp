@@ -55,6 +55,10 @@ bool ExportData(const Volume& volume, const Partition& partition, u64 offset, u6
   if (!f)
     return false;
 
+  // If the volume is backed by a memory mapped file, write straight from the mapping
+  if (const u8* mapped_data = volume.GetMappedData(offset, size, partition))
+    return f.WriteBytes(mapped_data, static_cast<size_t>(size));
+
   while (size)
   {
     // Limit read size to 128 MB
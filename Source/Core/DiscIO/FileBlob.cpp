@@ -2,21 +2,154 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <algorithm>
+#include <cstring>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 #include "Common/Assert.h"
 #include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
 #include "DiscIO/FileBlob.h"
 
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <stdio.h>  // fileno
+#include <sys/mman.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/vfs.h>
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__)
+#include <sys/mount.h>
+#include <sys/param.h>
+#endif
+
 namespace DiscIO
 {
 PlainFileReader::PlainFileReader(File::IOFile file) : m_file(std::move(file))
 {
   m_size = m_file.GetSize();
+  MapFile();
+}
+
+PlainFileReader::~PlainFileReader()
+{
+  UnmapFile();
+}
+
+#ifdef _WIN32
+static bool IsOnFixedDrive(HANDLE file_handle)
+{
+  wchar_t path[MAX_PATH];
+  const DWORD length = GetFinalPathNameByHandleW(file_handle, path, MAX_PATH,
+                                                 VOLUME_NAME_DOS | FILE_NAME_NORMALIZED);
+  if (length == 0 || length >= MAX_PATH)
+    return false;
+
+  // Paths look like \\?\C:\... for drive letters and \\?\UNC\... for network shares.
+  const std::wstring_view path_view(path, length);
+  if (path_view.size() < 7 || path_view.substr(0, 4) != L"\\\\?\\" || path_view[5] != L':')
+    return false;
+
+  const std::wstring root{path_view.substr(4, 3)};
+  return GetDriveTypeW(root.c_str()) == DRIVE_FIXED;
+}
+#else
+static bool IsOnLocalFileSystem(int fd)
+{
+#if defined(__linux__)
+  struct statfs info;
+  if (fstatfs(fd, &info) != 0)
+    return false;
+
+  switch (static_cast<u32>(info.f_type))
+  {
+  case 0x00006969:  // NFS
+  case 0x0000517b:  // SMB
+  case 0xff534d42:  // CIFS
+  case 0xfe534d42:  // SMB2
+  case 0x01021997:  // 9P
+  case 0x00c36400:  // Ceph
+  case 0x65735546:  // FUSE, which covers sshfs and most removable media on Android
+  case 0x00009660:  // ISO 9660
+  case 0x15013346:  // UDF
+    return false;
+  default:
+    return true;
+  }
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__)
+  struct statfs info;
+  return fstatfs(fd, &info) == 0 && (info.f_flags & MNT_LOCAL) != 0;
+#else
+  return false;
+#endif
+}
+#endif
+
+void PlainFileReader::MapFile()
+{
+  // Mapping a disc image needs more address space than a 32-bit host can spare
+  if (sizeof(void*) < sizeof(u64) || m_size <= 0)
+    return;
+
+  // An I/O error while touching a mapping can't be reported like a failed read: it crashes
+  // (SIGBUS, or an in-page error on Windows). Only map images on local fixed storage, where that
+  // is as unlikely as any other hardware failure, and read everything else with buffered reads.
+#ifdef _WIN32
+  const HANDLE file_handle =
+      reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(m_file.GetHandle())));
+  if (file_handle == INVALID_HANDLE_VALUE || !IsOnFixedDrive(file_handle))
+    return;
+
+  const HANDLE mapping_handle =
+      CreateFileMapping(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping_handle)
+    return;
+
+  void* view = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+  if (!view)
+  {
+    CloseHandle(mapping_handle);
+    return;
+  }
+
+  m_mapping_handle = mapping_handle;
+  m_mapped_data = static_cast<u8*>(view);
+  m_mapped_fd = _fileno(m_file.GetHandle());
+#else
+  if (!IsOnLocalFileSystem(fileno(m_file.GetHandle())))
+    return;
+
+  void* view = mmap(nullptr, static_cast<size_t>(m_size), PROT_READ, MAP_SHARED,
+                    fileno(m_file.GetHandle()), 0);
+  if (view == MAP_FAILED)
+    return;
+
+  m_mapped_data = static_cast<u8*>(view);
+  m_mapped_fd = fileno(m_file.GetHandle());
+#endif
+}
+
+void PlainFileReader::UnmapFile()
+{
+  if (!m_mapped_data)
+    return;
+
+#ifdef _WIN32
+  UnmapViewOfFile(m_mapped_data);
+  CloseHandle(static_cast<HANDLE>(m_mapping_handle));
+  m_mapping_handle = nullptr;
+#else
+  munmap(m_mapped_data, static_cast<size_t>(m_size));
+#endif
+
+  m_mapped_data = nullptr;
 }
 
 std::unique_ptr<PlainFileReader> PlainFileReader::Create(File::IOFile file)
@@ -27,8 +160,37 @@ std::unique_ptr<PlainFileReader> PlainFileReader::Create(File::IOFile file)
   return nullptr;
 }
 
+const u8* PlainFileReader::GetMappedData(u64 offset, u64 nbytes) const
+{
+  if (!m_mapped_data || offset > static_cast<u64>(m_size) ||
+      nbytes > static_cast<u64>(m_size) - offset)
+  {
+    return nullptr;
+  }
+
+  // Touching the part of a mapping that lies past the end of the file crashes, so make sure the
+  // file hasn't been truncated since it was mapped.
+  if (File::GetSize(m_mapped_fd) < offset + nbytes)
+  {
+    ERROR_LOG_FMT(DISCIO, "The disc image has shrunk since it was opened");
+    return nullptr;
+  }
+
+  return m_mapped_data + offset;
+}
+
 bool PlainFileReader::Read(u64 offset, u64 nbytes, u8* out_ptr)
 {
+  if (m_mapped_data)
+  {
+    const u8* data = GetMappedData(offset, nbytes);
+    if (!data)
+      return false;
+
+    std::memcpy(out_ptr, data, nbytes);
+    return true;
+  }
+
   if (m_file.Seek(offset, SEEK_SET) && m_file.ReadBytes(out_ptr, nbytes))
   {
     return true;
@@ -17,6 +17,7 @@ class PlainFileReader : public BlobReader
 {
 public:
   static std::unique_ptr<PlainFileReader> Create(File::IOFile file);
+  ~PlainFileReader() override;
 
   BlobType GetBlobType() const override { return BlobType::PLAIN; }
 
@@ -29,12 +30,25 @@ public:
   std::string GetCompressionMethod() const override { return {}; }
 
   bool Read(u64 offset, u64 nbytes, u8* out_ptr) override;
+  const u8* GetMappedData(u64 offset, u64 nbytes) const override;
 
 private:
   PlainFileReader(File::IOFile file);
 
+  // Maps the whole file into the address space so that reads can be served from the host's
+  // page cache without a syscall. If this fails, reads fall back to going through m_file.
+  void MapFile();
+  void UnmapFile();
+
   File::IOFile m_file;
   s64 m_size;
+
+  u8* m_mapped_data = nullptr;
+  // Descriptor of m_file, to check that the file hasn't shrunk while it is mapped.
+  int m_mapped_fd = -1;
+#ifdef _WIN32
+  void* m_mapping_handle = nullptr;
+#endif
 };
 
 }  // namespace DiscIO
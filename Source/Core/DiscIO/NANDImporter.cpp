@@ -5,10 +5,14 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstring>
+#include <memory>
+#include <thread>
 
 #include <fmt/format.h>
 
+#include "Common/Align.h"
 #include "Common/Crypto/AES.h"
 #include "Common/FileUtil.h"
 #include "Common/IOFile.h"
@@ -21,6 +25,13 @@ namespace DiscIO
 {
 constexpr size_t NAND_SIZE = 0x20000000;
 constexpr size_t NAND_KEYS_SIZE = 0x400;
+constexpr size_t NAND_AES_KEY_OFFSET = 0x158;
+constexpr size_t NAND_FAT_BLOCK_SIZE = 0x4000;
+constexpr size_t NAND_FAT_BLOCK_COUNT = NAND_SIZE / NAND_FAT_BLOCK_SIZE;
+
+// Writing the extracted files is mostly spent in AES and in the host filesystem, both of which
+// scale reasonably well with more threads.
+constexpr unsigned int MAX_EXTRACT_THREADS = 8;
 
 NANDImporter::NANDImporter() = default;
 NANDImporter::~NANDImporter() = default;
@@ -41,6 +52,7 @@ void NANDImporter::ImportNANDBin(const std::string& path_to_bin,
 
   FindSuperblock();
   ProcessEntry(0, nand_root);
+  ExtractFiles();
   ExportKeys(nand_root);
   ExtractCertificates(nand_root);
 }
@@ -64,15 +76,26 @@ bool NANDImporter::ReadNANDBin(const std::string& path_to_bin,
 
   m_nand.resize(NAND_SIZE);
 
-  for (size_t i = 0; i < NAND_TOTAL_BLOCKS; i++)
+  // Read many pages at once and strip out the ECC data afterwards. Reading each 2 KiB page
+  // individually is dominated by the overhead of the read and seek calls.
+  constexpr size_t PAGES_PER_CHUNK = 0x400;
+  std::vector<u8> chunk((NAND_BLOCK_SIZE + NAND_ECC_BLOCK_SIZE) * PAGES_PER_CHUNK);
+
+  for (size_t i = 0; i < NAND_TOTAL_BLOCKS; i += PAGES_PER_CHUNK)
   {
-    // Instead of updating on every cycle, we only update every 1000 cycles for a balance between
-    // not updating fast enough vs updating too fast
-    if (i % 1000 == 0)
-      m_update_callback();
+    m_update_callback();
 
-    file.ReadBytes(&m_nand[i * NAND_BLOCK_SIZE], NAND_BLOCK_SIZE);
-    file.Seek(NAND_ECC_BLOCK_SIZE, SEEK_CUR);  // We don't care about the ECC blocks
+    if (!file.ReadBytes(chunk.data(), chunk.size()))
+    {
+      PanicAlertFmtT("Failed to read the NAND backup.");
+      return false;
+    }
+
+    for (size_t j = 0; j < PAGES_PER_CHUNK; j++)
+    {
+      std::memcpy(&m_nand[(i + j) * NAND_BLOCK_SIZE],
+                  &chunk[j * (NAND_BLOCK_SIZE + NAND_ECC_BLOCK_SIZE)], NAND_BLOCK_SIZE);
+    }
   }
 
   m_nand_keys.resize(NAND_KEYS_SIZE);
@@ -171,30 +194,81 @@ void NANDImporter::ProcessDirectory(const NANDFSTEntry& entry, const std::string
 
 void NANDImporter::ProcessFile(const NANDFSTEntry& entry, const std::string& parent_path)
 {
-  constexpr size_t NAND_AES_KEY_OFFSET = 0x158;
-  constexpr size_t NAND_FAT_BLOCK_SIZE = 0x4000;
-
-  m_update_callback();
   INFO_LOG_FMT(DISCIO, "File: {}", FormatDebugString(entry));
 
-  const std::string path = GetPath(entry, parent_path);
-  File::IOFile file(path, "wb");
-  std::array<u8, 16> key{};
-  std::copy(&m_nand_keys[NAND_AES_KEY_OFFSET], &m_nand_keys[NAND_AES_KEY_OFFSET + key.size()],
-            key.begin());
-  u16 sub = Common::swap16(entry.sub);
-  u32 remaining_bytes = Common::swap32(entry.size);
-
-  while (remaining_bytes > 0)
+  // Only collect the file here; the contents are written by ExtractFiles once every directory
+  // has been created.
+  m_files_to_extract.push_back(
+      {GetPath(entry, parent_path), Common::swap16(entry.sub), Common::swap32(entry.size)});
+}
+
+void NANDImporter::ExtractFiles()
+{
+  const std::unique_ptr<Common::AES::Context> context =
+      Common::AES::CreateContext(&m_nand_keys[NAND_AES_KEY_OFFSET], Common::AES::Mode::Decrypt);
+
+  const unsigned int thread_count = static_cast<unsigned int>(
+      std::min<size_t>(m_files_to_extract.size(),
+                       std::clamp(std::thread::hardware_concurrency(), 1u, MAX_EXTRACT_THREADS)));
+
+  std::atomic<size_t> next_file_index = 0;
+  const auto extract_files = [&](bool is_calling_thread) {
+    while (true)
+    {
+      const size_t index = next_file_index++;
+      if (index >= m_files_to_extract.size())
+        break;
+
+      ExtractFile(m_files_to_extract[index], *context);
+
+      // The callback may touch the GUI, so it is only ever called from the importing thread.
+      if (is_calling_thread)
+        m_update_callback();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  if (thread_count > 1)
   {
+    threads.reserve(thread_count - 1);
+    for (unsigned int i = 1; i < thread_count; ++i)
+      threads.emplace_back(extract_files, false);
+  }
+
+  extract_files(true);
+
+  for (std::thread& thread : threads)
+    thread.join();
+
+  m_files_to_extract.clear();
+}
+
+void NANDImporter::ExtractFile(const FileToExtract& file,
+                               const Common::AES::Context& context) const
+{
+  // Decrypt the whole file into one buffer so that it can be written with a single call.
+  std::vector<u8> data(Common::AlignUp(file.size, NAND_FAT_BLOCK_SIZE));
+  u16 sub = file.first_cluster;
+
+  for (size_t offset = 0; offset < data.size(); offset += NAND_FAT_BLOCK_SIZE)
+  {
+    if (sub >= NAND_FAT_BLOCK_COUNT)
+    {
+      ERROR_LOG_FMT(DISCIO, "Invalid cluster {:#06x} in the FAT chain of {}", sub,
+                    file.path.data() + m_nand_root_length);
+      data.resize(offset);
+      break;
+    }
+
     std::array<u8, 16> iv{};
-    std::vector<u8> block = Common::AES::Decrypt(
-        key.data(), iv.data(), &m_nand[NAND_FAT_BLOCK_SIZE * sub], NAND_FAT_BLOCK_SIZE);
-    u32 size = remaining_bytes < NAND_FAT_BLOCK_SIZE ? remaining_bytes : NAND_FAT_BLOCK_SIZE;
-    file.WriteBytes(block.data(), size);
-    remaining_bytes -= size;
+    context.CryptCBC(iv.data(), &m_nand[NAND_FAT_BLOCK_SIZE * sub], &data[offset],
+                     NAND_FAT_BLOCK_SIZE);
     sub = Common::swap16(&m_nand[m_nand_fat_offset + 2 * sub]);
   }
+
+  File::IOFile out(file.path, "wb");
+  if (!out.WriteBytes(data.data(), std::min<size_t>(data.size(), file.size)))
+    ERROR_LOG_FMT(DISCIO, "Unable to write to file {}", file.path);
 }
 
 bool NANDImporter::ExtractCertificates(const std::string& nand_root)
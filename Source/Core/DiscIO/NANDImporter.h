@@ -9,6 +9,11 @@
 
 #include "Common/CommonTypes.h"
 
+namespace Common::AES
+{
+class Context;
+}
+
 namespace DiscIO
 {
 class NANDImporter final
@@ -41,6 +46,13 @@ private:
   };
 #pragma pack(pop)
 
+  struct FileToExtract
+  {
+    std::string path;
+    u16 first_cluster;
+    u32 size;
+  };
+
   bool ReadNANDBin(const std::string& path_to_bin, std::function<std::string()> get_otp_dump_path);
   void FindSuperblock();
   std::string GetPath(const NANDFSTEntry& entry, const std::string& parent_path);
@@ -48,12 +60,15 @@ private:
   void ProcessEntry(u16 entry_number, const std::string& parent_path);
   void ProcessFile(const NANDFSTEntry& entry, const std::string& parent_path);
   void ProcessDirectory(const NANDFSTEntry& entry, const std::string& parent_path);
+  void ExtractFiles();
+  void ExtractFile(const FileToExtract& file, const Common::AES::Context& context) const;
   void ExportKeys(const std::string& nand_root);
 
   std::vector<u8> m_nand;
   std::vector<u8> m_nand_keys;
   size_t m_nand_fat_offset = 0;
   size_t m_nand_fst_offset = 0;
+  std::vector<FileToExtract> m_files_to_extract;
   std::function<void()> m_update_callback;
   size_t m_nand_root_length = 0;
 };
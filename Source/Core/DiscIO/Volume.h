@@ -48,6 +48,12 @@ public:
   Volume() {}
   virtual ~Volume() {}
   virtual bool Read(u64 offset, u64 length, u8* buffer, const Partition& partition) const = 0;
+  // Returns a pointer that the given range can be read from without copying, or nullptr if the
+  // data isn't available in that form (for instance because it's compressed or encrypted).
+  virtual const u8* GetMappedData(u64 offset, u64 length, const Partition& partition) const
+  {
+    return nullptr;
+  }
   template <typename T>
   std::optional<T> ReadSwapped(u64 offset, const Partition& partition) const
   {
@@ -216,6 +216,21 @@ bool VolumeWii::Read(u64 offset, u64 length, u8* buffer, const Partition& partit
   return true;
 }
 
+const u8* VolumeWii::GetMappedData(u64 offset, u64 length, const Partition& partition) const
+{
+  if (partition == PARTITION_NONE)
+    return m_reader->GetMappedData(offset, length);
+
+  if (m_encrypted)
+    return nullptr;
+
+  auto it = m_partitions.find(partition);
+  if (it == m_partitions.end())
+    return nullptr;
+
+  return m_reader->GetMappedData(partition.offset + *it->second.data_offset + offset, length);
+}
+
 bool VolumeWii::IsEncryptedAndHashed() const
 {
   return m_encrypted;
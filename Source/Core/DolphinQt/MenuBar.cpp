@@ -142,6 +142,11 @@ void MenuBar::OnEmulationStateChanged(Core::State state)
   m_jit_clear_cache->setEnabled(running);
   m_jit_log_coverage->setEnabled(!running);
   m_jit_search_instruction->setEnabled(running);
+  m_jit_profile_blocks->setEnabled(running);
+  m_jit_write_profile->setEnabled(running);
+  // A new JIT starts without profiling.
+  if (!running)
+    m_jit_profile_blocks->setChecked(false);
 
   for (QAction* action :
        {m_jit_off, m_jit_loadstore_off, m_jit_loadstore_lbzx_off, m_jit_loadstore_lxz_off,
@@ -851,6 +856,17 @@ void MenuBar::AddJITMenu()
 
   m_jit->addSeparator();
 
+  m_jit_profile_blocks = m_jit->addAction(tr("Enable JIT Block Profiling"));
+  m_jit_profile_blocks->setCheckable(true);
+  connect(m_jit_profile_blocks, &QAction::triggered, [](bool enabled) {
+    JitInterface::SetProfilingState(enabled ? JitInterface::ProfilingState::Enabled :
+                                              JitInterface::ProfilingState::Disabled);
+  });
+  m_jit_write_profile =
+      m_jit->addAction(tr("Write JIT Block Profile"), this, &MenuBar::WriteProfile);
+
+  m_jit->addSeparator();
+
   m_jit_off = m_jit->addAction(tr("JIT Off (JIT Core)"));
   m_jit_off->setCheckable(true);
   m_jit_off->setChecked(SConfig::GetInstance().bJITOff);
@@ -1682,6 +1698,14 @@ void MenuBar::ClearCache()
   Core::RunAsCPUThread(JitInterface::ClearCache);
 }
 
+void MenuBar::WriteProfile()
+{
+  // Besides the blocks, this includes how often each MMIO register was accessed.
+  const std::string filename = File::GetUserPath(D_DUMP_IDX) + "Debug/profiler.txt";
+  File::CreateFullPath(filename);
+  JitInterface::WriteProfileResults(filename);
+}
+
 void MenuBar::LogInstructions()
 {
   PPCTables::LogCompiledInstructions();
@@ -176,6 +176,7 @@ private:
   void CombineSignatureFiles();
   void PatchHLEFunctions();
   void ClearCache();
+  void WriteProfile();
   void LogInstructions();
   void SearchInstruction();
 
@@ -261,6 +262,8 @@ private:
   QAction* m_jit_clear_cache;
   QAction* m_jit_log_coverage;
   QAction* m_jit_search_instruction;
+  QAction* m_jit_profile_blocks;
+  QAction* m_jit_write_profile;
   QAction* m_jit_off;
   QAction* m_jit_loadstore_off;
   QAction* m_jit_loadstore_lbzx_off;
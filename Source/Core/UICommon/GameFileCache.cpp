@@ -5,12 +5,15 @@
 
 #include <algorithm>
 #include <atomic>
+#include <condition_variable>
 #include <cstddef>
 #include <functional>
 #include <list>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -27,7 +30,19 @@
 
 namespace UICommon
 {
-static constexpr u32 CACHE_REVISION = 20;  // Last changed in PR 9461
+static constexpr u32 CACHE_REVISION = 21;  // Last changed for per-entry cache records
+
+enum class CacheRecordType : u8
+{
+  Entry = 0,
+  Removal = 1,
+};
+
+// Once the cache file contains this many more records than there are entries, it gets rewritten
+static constexpr size_t CACHE_COMPACTION_SLACK = 64;
+
+// Opening games is mostly spent waiting for the storage, so new games are opened on several threads
+static constexpr unsigned int MAX_SCAN_THREADS = 8;
 
 std::vector<std::string> FindAllGamePaths(const std::vector<std::string>& directories_to_scan,
                                           bool recursive_scan)
@@ -57,9 +72,27 @@ size_t GameFileCache::GetSize() const
 void GameFileCache::Clear(DeleteOnDisk delete_on_disk)
 {
   if (delete_on_disk != DeleteOnDisk::No)
+  {
     File::Delete(m_path);
+    m_records_in_file = 0;
+  }
 
   m_cached_files.clear();
+  m_changed_paths.clear();
+  m_removed_paths.clear();
+  m_rewrite_needed = true;
+}
+
+void GameFileCache::MarkChanged(const std::string& path)
+{
+  m_removed_paths.erase(path);
+  m_changed_paths.insert(path);
+}
+
+void GameFileCache::MarkRemoved(const std::string& path)
+{
+  m_changed_paths.erase(path);
+  m_removed_paths.insert(path);
 }
 
 std::shared_ptr<const GameFile> GameFileCache::AddOrGet(const std::string& path,
@@ -78,7 +111,10 @@ std::shared_ptr<const GameFile> GameFileCache::AddOrGet(const std::string& path,
   }
   std::shared_ptr<GameFile>& result = found ? *it : m_cached_files.back();
   if (UpdateAdditionalMetadata(&result) || !found)
+  {
     *cache_changed = true;
+    MarkChanged(path);
+  }
 
   return result;
 }
@@ -122,6 +158,7 @@ bool GameFileCache::Update(
         if (game_removed_from_cache)
           game_removed_from_cache((*it)->GetFilePath());
 
+        MarkRemoved((*it)->GetFilePath());
         cache_changed = true;
         --end;
         *it = std::move(*end);
@@ -132,22 +169,77 @@ bool GameFileCache::Update(
 
   // Now that the previous loop has run, game_paths only contains paths that
   // aren't in m_cached_files, so we simply add all of them to m_cached_files.
-  for (const std::string& path : game_paths)
+  // The games are opened by a pool of worker threads, while this thread hands
+  // the results to game_added_to_cache as they come in.
+  const std::vector<std::string> new_paths(game_paths.begin(), game_paths.end());
+  if (new_paths.empty())
+    return cache_changed;
+
+  const unsigned int thread_count = static_cast<unsigned int>(std::min<size_t>(
+      new_paths.size(), std::clamp(std::thread::hardware_concurrency(), 1u, MAX_SCAN_THREADS)));
+
+  std::atomic<size_t> next_path_index = 0;
+  std::mutex results_mutex;
+  std::condition_variable results_changed;
+  std::vector<std::shared_ptr<GameFile>> results;
+  unsigned int finished_threads = 0;
+
+  const auto scan_paths = [&] {
+    while (!processing_halted)
+    {
+      const size_t index = next_path_index++;
+      if (index >= new_paths.size())
+        break;
+
+      auto file = std::make_shared<GameFile>(new_paths[index]);
+      if (!file->IsValid())
+        continue;
+
+      {
+        std::lock_guard lk(results_mutex);
+        results.push_back(std::move(file));
+      }
+      results_changed.notify_one();
+    }
+
+    {
+      std::lock_guard lk(results_mutex);
+      ++finished_threads;
+    }
+    results_changed.notify_one();
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(thread_count);
+  for (unsigned int i = 0; i < thread_count; ++i)
+    threads.emplace_back(scan_paths);
+
+  std::vector<std::shared_ptr<GameFile>> new_files;
+  bool all_threads_finished = false;
+  while (!all_threads_finished)
   {
-    if (processing_halted)
-      break;
+    {
+      std::unique_lock lk(results_mutex);
+      results_changed.wait(lk, [&] { return !results.empty() || finished_threads == thread_count; });
+      all_threads_finished = finished_threads == thread_count;
+      new_files.swap(results);
+    }
 
-    auto file = std::make_shared<GameFile>(path);
-    if (file->IsValid())
+    for (std::shared_ptr<GameFile>& file : new_files)
     {
       if (game_added_to_cache)
         game_added_to_cache(file);
 
+      MarkChanged(file->GetFilePath());
       cache_changed = true;
       m_cached_files.push_back(std::move(file));
     }
+    new_files.clear();
   }
 
+  for (std::thread& thread : threads)
+    thread.join();
+
   return cache_changed;
 }
 
@@ -164,6 +256,8 @@ bool GameFileCache::UpdateAdditionalMetadata(
 
     const bool updated = UpdateAdditionalMetadata(&file);
     cache_changed |= updated;
+    if (updated)
+      MarkChanged(file->GetFilePath());
     if (game_updated && updated)
       game_updated(file);
   }
@@ -210,79 +304,193 @@ bool GameFileCache::UpdateAdditionalMetadata(std::shared_ptr<GameFile>* game_fil
 
 bool GameFileCache::Load()
 {
-  return SyncCacheFile(false);
+  m_changed_paths.clear();
+  m_removed_paths.clear();
+
+  m_rewrite_needed = false;
+  const bool success = ReadCacheFile();
+  if (!success)
+    m_rewrite_needed = true;
+  return success;
 }
 
 bool GameFileCache::Save()
 {
-  return SyncCacheFile(true);
+  const bool compact =
+      m_rewrite_needed || m_records_in_file > m_cached_files.size() * 2 + CACHE_COMPACTION_SLACK;
+  if (!compact && m_changed_paths.empty() && m_removed_paths.empty())
+    return true;
+
+  const bool success = WriteCacheFile(!compact);
+  if (success)
+  {
+    m_changed_paths.clear();
+    m_removed_paths.clear();
+    m_rewrite_needed = false;
+  }
+  else
+  {
+    // If some file operation failed, try to delete the probably-corrupted cache
+    File::Delete(m_path);
+    m_records_in_file = 0;
+    m_rewrite_needed = true;
+  }
+
+  return success;
 }
 
-bool GameFileCache::SyncCacheFile(bool save)
+bool GameFileCache::ReadCacheFile()
 {
-  const char* open_mode = save ? "wb" : "rb";
-  File::IOFile f(m_path, open_mode);
+  m_records_in_file = 0;
+
+  File::IOFile f(m_path, "rb");
   if (!f)
     return false;
-  bool success = false;
-  if (save)
-  {
-    // Measure the size of the buffer.
-    u8* ptr = nullptr;
-    PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
-    DoState(&p);
-    const size_t buffer_size = reinterpret_cast<size_t>(ptr);
 
-    // Then actually do the write.
-    std::vector<u8> buffer(buffer_size);
-    ptr = &buffer[0];
-    p.SetMode(PointerWrap::MODE_WRITE);
-    DoState(&p, buffer_size);
-    if (f.WriteBytes(buffer.data(), buffer.size()))
-      success = true;
+  std::vector<u8> buffer(f.GetSize());
+  if (buffer.size() < sizeof(u32) || !f.ReadBytes(buffer.data(), buffer.size()))
+    return false;
+  f.Close();
+
+  u8* ptr = buffer.data();
+  const u8* const end = buffer.data() + buffer.size();
+  PointerWrap p(&ptr, PointerWrap::MODE_READ);
+
+  u32 revision = 0;
+  p.Do(revision);
+  if (revision != CACHE_REVISION)
+  {
+    File::Delete(m_path);
+    return false;
   }
-  else
+
+  // Later records for a path replace earlier ones, so keep track of where each path is
+  std::unordered_map<std::string, size_t> indices;
+  std::vector<std::shared_ptr<GameFile>> files;
+  const u8* last_record_end = ptr;
+
+  while (end - ptr >= static_cast<ptrdiff_t>(sizeof(u32) + sizeof(CacheRecordType)))
   {
-    std::vector<u8> buffer(f.GetSize());
-    if (!buffer.empty() && f.ReadBytes(buffer.data(), buffer.size()))
+    u32 record_size = 0;
+    CacheRecordType type = CacheRecordType::Entry;
+    p.Do(record_size);
+    p.Do(type);
+
+    // A record that doesn't fit was most likely cut off while being appended, so ignore it
+    if (record_size > static_cast<size_t>(end - ptr))
+      break;
+    const u8* const record_end = ptr + record_size;
+
+    std::string path;
+    std::shared_ptr<GameFile> file;
+    if (type == CacheRecordType::Entry)
+    {
+      file = std::make_shared<GameFile>();
+      file->DoState(p);
+      path = file->GetFilePath();
+    }
+    else
+    {
+      p.Do(path);
+    }
+
+    if (p.GetMode() != PointerWrap::MODE_READ || ptr != record_end)
+      break;
+
+    ++m_records_in_file;
+    last_record_end = record_end;
+
+    const auto it = indices.find(path);
+    if (file && it != indices.end())
     {
-      u8* ptr = buffer.data();
-      PointerWrap p(&ptr, PointerWrap::MODE_READ);
-      DoState(&p, buffer.size());
-      if (p.GetMode() == PointerWrap::MODE_READ)
-        success = true;
+      files[it->second] = std::move(file);
+    }
+    else if (file)
+    {
+      indices.emplace(path, files.size());
+      files.push_back(std::move(file));
+    }
+    else if (it != indices.end())
+    {
+      files[it->second].reset();
+      indices.erase(it);
     }
   }
-  if (!success)
+
+  // Records appended after a broken one could never be read, so rewrite the file on the next save
+  if (last_record_end != end)
+    m_rewrite_needed = true;
+
+  m_cached_files.clear();
+  for (std::shared_ptr<GameFile>& file : files)
   {
-    // If some file operation failed, try to delete the probably-corrupted cache
-    f.Close();
-    File::Delete(m_path);
+    if (file)
+      m_cached_files.push_back(std::move(file));
   }
-  return success;
+
+  return true;
 }
 
-void GameFileCache::DoState(PointerWrap* p, u64 size)
+bool GameFileCache::WriteCacheFile(bool append)
 {
-  struct
-  {
-    u32 revision;
-    u64 expected_size;
-  } header = {CACHE_REVISION, size};
-  p->Do(header);
-  if (p->GetMode() == PointerWrap::MODE_READ)
+  std::vector<u8> buffer;
+
+  const auto write_record = [&buffer](CacheRecordType type, const auto& do_state) {
+    u8* ptr = nullptr;
+    PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
+    do_state(p);
+    const u32 record_size = static_cast<u32>(reinterpret_cast<size_t>(ptr));
+
+    const size_t offset = buffer.size();
+    buffer.resize(offset + sizeof(record_size) + sizeof(type) + record_size);
+    ptr = buffer.data() + offset;
+    p.SetMode(PointerWrap::MODE_WRITE);
+    p.Do(record_size);
+    p.Do(type);
+    do_state(p);
+  };
+
+  const auto write_entry = [&write_record](GameFile& file) {
+    write_record(CacheRecordType::Entry, [&file](PointerWrap& p) { file.DoState(p); });
+  };
+
+  size_t records_written = 0;
+  if (append && File::Exists(m_path))
   {
-    if (header.revision != CACHE_REVISION || header.expected_size != size)
+    for (std::string path : m_removed_paths)
+      write_record(CacheRecordType::Removal, [&path](PointerWrap& p) { p.Do(path); });
+    records_written += m_removed_paths.size();
+
+    for (const std::shared_ptr<GameFile>& file : m_cached_files)
     {
-      p->SetMode(PointerWrap::MODE_MEASURE);
-      return;
+      if (m_changed_paths.count(file->GetFilePath()))
+      {
+        write_entry(*file);
+        ++records_written;
+      }
     }
   }
-  p->DoEachElement(m_cached_files, [](PointerWrap& state, std::shared_ptr<GameFile>& elem) {
-    if (state.GetMode() == PointerWrap::MODE_READ)
-      elem = std::make_shared<GameFile>();
-    elem->DoState(state);
-  });
+  else
+  {
+    append = false;
+
+    buffer.resize(sizeof(CACHE_REVISION));
+    u8* ptr = buffer.data();
+    PointerWrap p(&ptr, PointerWrap::MODE_WRITE);
+    u32 revision = CACHE_REVISION;
+    p.Do(revision);
+
+    for (const std::shared_ptr<GameFile>& file : m_cached_files)
+      write_entry(*file);
+    records_written = m_cached_files.size();
+  }
+
+  File::IOFile f(m_path, append ? "ab" : "wb");
+  if (!f || !f.WriteBytes(buffer.data(), buffer.size()))
+    return false;
+
+  m_records_in_file = (append ? m_records_in_file : 0) + records_written;
+  return true;
 }
 
 }  // namespace UICommon
@@ -8,12 +8,11 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "Common/CommonTypes.h"
 
-class PointerWrap;
-
 namespace UICommon
 {
 class GameFile;
@@ -50,16 +49,28 @@ public:
       const std::atomic_bool& processing_halted = false);
 
   bool Load();
+  // Only writes the entries that have changed since the last Load or Save, unless the cache file
+  // has accumulated enough outdated entries that it's worth rewriting it from scratch.
   bool Save();
 
 private:
   bool UpdateAdditionalMetadata(std::shared_ptr<GameFile>* game_file);
 
-  bool SyncCacheFile(bool save);
-  void DoState(PointerWrap* p, u64 size = 0);
+  void MarkChanged(const std::string& path);
+  void MarkRemoved(const std::string& path);
+
+  bool ReadCacheFile();
+  bool WriteCacheFile(bool append);
 
   std::string m_path;
   std::vector<std::shared_ptr<GameFile>> m_cached_files;
+
+  // The cache file is a sequence of records that each add, replace or remove one entry.
+  // These track what needs to be appended to it on the next Save.
+  std::unordered_set<std::string> m_changed_paths;
+  std::unordered_set<std::string> m_removed_paths;
+  size_t m_records_in_file = 0;
+  bool m_rewrite_needed = true;
 };
 
 }  // namespace UICommon
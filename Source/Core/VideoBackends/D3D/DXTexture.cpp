@@ -315,6 +315,29 @@ void DXStagingTexture::Flush()
   m_needs_flush = false;
 }
 
+bool DXStagingTexture::IsCopyComplete()
+{
+  if (!m_needs_flush || m_map_pointer)
+    return true;
+
+  // Upload textures can always be written to.
+  if (m_type == StagingTextureType::Upload)
+    return true;
+
+  // There are no fences here, but the driver can tell whether mapping would have to wait. If it
+  // doesn't, keep the mapping for the read that follows.
+  const D3D11_MAP map_type =
+      m_type == StagingTextureType::Readback ? D3D11_MAP_READ : D3D11_MAP_READ_WRITE;
+  D3D11_MAPPED_SUBRESOURCE sr;
+  const HRESULT hr = D3D::context->Map(m_tex.Get(), 0, map_type, D3D11_MAP_FLAG_DO_NOT_WAIT, &sr);
+  if (FAILED(hr))
+    return false;
+
+  m_map_pointer = reinterpret_cast<char*>(sr.pData);
+  m_map_stride = sr.RowPitch;
+  return true;
+}
+
 DXFramebuffer::DXFramebuffer(AbstractTexture* color_attachment, AbstractTexture* depth_attachment,
                              AbstractTextureFormat color_format, AbstractTextureFormat depth_format,
                              u32 width, u32 height, u32 layers, u32 samples,
@@ -623,6 +623,15 @@ void DXStagingTexture::Flush()
     g_dx_context->WaitForFence(m_completed_fence);
 }
 
+bool DXStagingTexture::IsCopyComplete()
+{
+  if (!m_needs_flush)
+    return true;
+
+  return m_completed_fence != g_dx_context->GetCurrentFenceValue() &&
+         m_completed_fence <= g_dx_context->GetCompletedFenceValue();
+}
+
 std::unique_ptr<DXStagingTexture> DXStagingTexture::Create(StagingTextureType type,
                                                            const TextureConfig& config)
 {
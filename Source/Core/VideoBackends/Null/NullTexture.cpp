@@ -64,6 +64,12 @@ void NullStagingTexture::Flush()
   m_needs_flush = false;
 }
 
+bool NullStagingTexture::IsCopyComplete()
+{
+  // There is no GPU, so copies are done once they are flushed.
+  return !m_needs_flush;
+}
+
 NullFramebuffer::NullFramebuffer(AbstractTexture* color_attachment,
                                  AbstractTexture* depth_attachment,
                                  AbstractTextureFormat color_format,
@@ -45,6 +45,7 @@ public:
   bool Map() override;
   void Unmap() override;
   void Flush() override;
+  bool IsCopyComplete() override;
 
 private:
   std::vector<u8> m_texture_buf;
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "VideoCommon/AbstractStagingTexture.h"
 #include "VideoCommon/TextureCacheBase.h"
 
 namespace Null
@@ -16,6 +17,8 @@ protected:
                float y_scale, float gamma, bool clamp_top, bool clamp_bottom,
                const EFBCopyFilterCoefficients& filter_coefficients) override
   {
+    // Nothing is encoded, but the copy is still only complete once the texture is read back.
+    dst->CopyFromTexture(nullptr, src_rect, 0, 0, src_rect);
   }
 
   void CopyEFBToCacheEntry(TCacheEntry* entry, bool is_depth_copy,
@@ -491,6 +491,20 @@ void OGLStagingTexture::Flush()
   m_needs_flush = false;
 }
 
+bool OGLStagingTexture::IsCopyComplete()
+{
+  if (!m_needs_flush)
+    return true;
+
+  // Without buffer storage, the transfer only happens when the buffer is mapped.
+  if (m_fence == 0)
+    return false;
+
+  GLint status = GL_UNSIGNALED;
+  glGetSynciv(m_fence, GL_SYNC_STATUS, 1, nullptr, &status);
+  return status == GL_SIGNALED;
+}
+
 bool OGLStagingTexture::Map()
 {
   if (m_map_pointer)
@@ -60,6 +60,7 @@ public:
   bool Map() override;
   void Unmap() override;
   void Flush() override;
+  bool IsCopyComplete() override;
 
   static std::unique_ptr<OGLStagingTexture> Create(StagingTextureType type,
                                                    const TextureConfig& config);
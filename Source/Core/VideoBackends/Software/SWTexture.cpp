@@ -143,6 +143,12 @@ void SWStagingTexture::Flush()
   m_needs_flush = false;
 }
 
+bool SWStagingTexture::IsCopyComplete()
+{
+  // Copies are performed immediately.
+  return true;
+}
+
 SWFramebuffer::SWFramebuffer(AbstractTexture* color_attachment, AbstractTexture* depth_attachment,
                              AbstractTextureFormat color_format, AbstractTextureFormat depth_format,
                              u32 width, u32 height, u32 layers, u32 samples)
@@ -52,6 +52,7 @@ public:
   bool Map() override;
   void Unmap() override;
   void Flush() override;
+  bool IsCopyComplete() override;
 
   void SetMapStride(size_t stride) { m_map_stride = stride; }
 
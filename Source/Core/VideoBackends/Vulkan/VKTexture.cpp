@@ -859,6 +859,15 @@ void VKStagingTexture::Flush()
   m_needs_flush = false;
 }
 
+bool VKStagingTexture::IsCopyComplete()
+{
+  if (!m_needs_flush)
+    return true;
+
+  return g_command_buffer_mgr->GetCurrentFenceCounter() != m_flush_fence_counter &&
+         g_command_buffer_mgr->GetCompletedFenceCounter() >= m_flush_fence_counter;
+}
+
 VKFramebuffer::VKFramebuffer(VKTexture* color_attachment, VKTexture* depth_attachment, u32 width,
                              u32 height, u32 layers, u32 samples, VkFramebuffer fb,
                              VkRenderPass load_render_pass, VkRenderPass discard_render_pass,
@@ -67,6 +67,11 @@ public:
   // call to CopyFromTexture()/CopyToTexture() and the Flush() call.
   virtual void Flush() = 0;
 
+  // Returns true if the GPU has completed the last copy to or from this texture, in which case
+  // Flush() will not have to wait. Does not submit any work, so copies that are still recorded in
+  // the current command buffer are never complete.
+  virtual bool IsCopyComplete() = 0;
+
   // Reads the specified rectangle from the staging texture to out_ptr, with the specified stride
   // (length in bytes of each row). CopyFromTexture must be called first. The contents of any
   // texels outside of the rectangle used for CopyFromTexture is undefined.
@@ -7,6 +7,7 @@
 #include "VideoCommon/Fifo.h"
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/Statistics.h"
+#include "VideoCommon/TextureCacheBase.h"
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VideoBackendBase.h"
 #include "VideoCommon/VideoCommon.h"
@@ -164,6 +165,10 @@ void AsyncRequests::HandleEvent(const AsyncRequests::Event& e)
   case Event::DO_SAVE_STATE:
     VideoCommon_DoState(*e.do_save_state.p);
     break;
+
+  case Event::FLUSH_EFB_COPIES:
+    g_texture_cache->FlushEFBCopiesInRange(e.flush_efb_copies.address, e.flush_efb_copies.size);
+    break;
   }
 }
 
@@ -29,6 +29,7 @@ public:
       BBOX_READ,
       PERF_QUERY,
       DO_SAVE_STATE,
+      FLUSH_EFB_COPIES,
     } type;
     u64 time;
 
@@ -70,6 +71,12 @@ public:
       {
         PointerWrap* p;
       } do_save_state;
+
+      struct
+      {
+        u32 address;
+        u32 size;
+      } flush_efb_copies;
     };
   };
 
@@ -175,7 +175,7 @@ static void BPWritten(const BPCmd& bp)
     switch (bp.newvalue & 0xFF)
     {
     case 0x02:
-      g_texture_cache->FlushEFBCopies();
+      g_texture_cache->PublishEFBCopies();
       g_framebuffer_manager->InvalidatePeekCache(false);
       if (!Fifo::UseDeterministicGPUThread())
         PixelEngine::SetFinish();  // may generate interrupt
@@ -188,14 +188,14 @@ static void BPWritten(const BPCmd& bp)
     }
     return;
   case BPMEM_PE_TOKEN_ID:  // Pixel Engine Token ID
-    g_texture_cache->FlushEFBCopies();
+    g_texture_cache->PublishEFBCopies();
     g_framebuffer_manager->InvalidatePeekCache(false);
     if (!Fifo::UseDeterministicGPUThread())
       PixelEngine::SetToken(static_cast<u16>(bp.newvalue & 0xFFFF), false);
     DEBUG_LOG_FMT(VIDEO, "SetPEToken {:#06X}", bp.newvalue & 0xFFFF);
     return;
   case BPMEM_PE_TOKEN_INT_ID:  // Pixel Engine Interrupt Token ID
-    g_texture_cache->FlushEFBCopies();
+    g_texture_cache->PublishEFBCopies();
     g_framebuffer_manager->InvalidatePeekCache(false);
     if (!Fifo::UseDeterministicGPUThread())
       PixelEngine::SetToken(static_cast<u16>(bp.newvalue & 0xFFFF), true);
@@ -535,6 +535,7 @@ static void BPWritten(const BPCmd& bp)
       }
       else  // RGBA8 tiles (and CI14, but that might just be stupid libogc!)
       {
+        Memory::WaitForGPUWrites(src_addr, tmem_cfg.preload_tile_info.count * TMEM_LINE_SIZE * 2);
         u8* src_ptr = Memory::GetPointer(src_addr);
 
         // AR and GB tiles are stored in separate TMEM banks => can't use a single memcpy for
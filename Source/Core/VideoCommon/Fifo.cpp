@@ -24,6 +24,7 @@
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/DataReader.h"
 #include "VideoCommon/OpcodeDecoding.h"
+#include "VideoCommon/TextureCacheBase.h"
 #include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VideoBackendBase.h"
@@ -393,6 +394,11 @@ void RunGpuLoop()
       },
       100);
 
+  // Nothing is going to service the CPU thread's requests to wait for EFB copies anymore, so write
+  // them all now, which also unprotects the memory they cover.
+  if (g_texture_cache)
+    g_texture_cache->FlushEFBCopies();
+
   AsyncRequests::GetInstance()->SetEnable(false);
   AsyncRequests::GetInstance()->SetPassthrough(true);
 }
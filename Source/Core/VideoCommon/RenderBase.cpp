@@ -1353,8 +1353,8 @@ void Renderer::Swap(u32 xfb_addr, u32 fb_width, u32 fb_stride, u32 fb_height, u6
       {
         // Flush any outstanding EFB copies to RAM, in case the game is running at an uncapped frame
         // rate and not waiting for vblank. Otherwise, we'd end up with a huge list of pending
-        // copies.
-        g_texture_cache->FlushEFBCopies();
+        // copies. Asynchronous copies get until the next frame to complete.
+        g_texture_cache->RetireEFBCopies();
       }
 
       if (!is_duplicate_frame)
@@ -8,6 +8,7 @@
 #include <cstring>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 #if defined(_M_X86) || defined(_M_X86_64)
@@ -98,10 +99,22 @@ TextureCacheBase::TextureCacheBase()
   InvalidateAllBindPoints();
 }
 
+static u32 GetPendingEFBCopyRange(const TextureCacheBase::TCacheEntry* entry)
+{
+  return entry->pending_efb_copy_height * entry->memory_stride;
+}
+
 TextureCacheBase::~TextureCacheBase()
 {
   // Clear pending EFB copies first, so we don't try to flush them.
+  for (size_t i = 0; i < m_published_efb_copies; i++)
+  {
+    const TCacheEntry* entry = m_pending_efb_copies[i];
+    Memory::RemovePendingGPUWrite(entry->addr, GetPendingEFBCopyRange(entry));
+  }
   m_pending_efb_copies.clear();
+  m_published_efb_copies = 0;
+  m_published_efb_copies_before_frame = 0;
 
   HiresTexture::Shutdown();
   Invalidate();
@@ -131,7 +144,8 @@ void TextureCacheBase::Invalidate()
     delete tex.second;
   }
   textures_by_address.clear();
-  textures_by_hash.clear();
+  textures_by_page.Clear();
+  textures_by_hash.Clear();
 
   texture_pool.clear();
 }
@@ -324,7 +338,7 @@ TextureCacheBase::ApplyPaletteToEntry(TCacheEntry* entry, const u8* palette, TLU
     g_renderer->EndUtilityDrawing();
   }
 
-  textures_by_address.emplace(decoded_entry->addr, decoded_entry);
+  InsertTexture(decoded_entry);
 
   return decoded_entry;
 }
@@ -371,7 +385,7 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::ReinterpretEntry(const TCacheEn
   g_renderer->EndUtilityDrawing();
   reinterpreted_entry->texture->FinishedRendering();
 
-  textures_by_address.emplace(reinterpreted_entry->addr, reinterpreted_entry);
+  InsertTexture(reinterpreted_entry);
 
   return reinterpreted_entry;
 }
@@ -585,14 +599,13 @@ void TextureCacheBase::DoSaveState(PointerWrap& p)
         textures_by_address_list.emplace_back(it.first, id);
       }
     }
-    for (const auto& it : textures_by_hash)
-    {
-      if (ShouldSaveEntry(it.second))
+    textures_by_hash.ForEach([&](u64 hash, TCacheEntry* entry) {
+      if (ShouldSaveEntry(entry))
       {
-        const u32 id = AddCacheEntryToMap(it.second);
-        textures_by_hash_list.emplace_back(it.first, id);
+        const u32 id = AddCacheEntryToMap(entry);
+        textures_by_hash_list.emplace_back(hash, id);
       }
-    }
+    });
   }
 
   // Save the texture cache entries out in the order the were referenced.
@@ -682,7 +695,6 @@ void TextureCacheBase::DoLoadState(PointerWrap& p)
     // to update the point in the state state. We'll just throw it away if it's invalid.
     auto tex = DeserializeTexture(p);
     TCacheEntry* entry = new TCacheEntry(std::move(tex->texture), std::move(tex->framebuffer));
-    entry->textures_by_hash_iter = textures_by_hash.end();
     entry->DoState(p);
     if (entry->texture && commit_state)
       id_map.emplace(i, entry);
@@ -715,7 +727,7 @@ void TextureCacheBase::DoLoadState(PointerWrap& p)
 
     TCacheEntry* entry = GetEntry(id);
     if (entry)
-      textures_by_address.emplace(addr, entry);
+      InsertTexture(entry);
   }
 
   // Fill in hash map.
@@ -729,7 +741,10 @@ void TextureCacheBase::DoLoadState(PointerWrap& p)
 
     TCacheEntry* entry = GetEntry(id);
     if (entry)
-      entry->textures_by_hash_iter = textures_by_hash.emplace(hash, entry);
+    {
+      textures_by_hash.Add(hash, entry);
+      entry->textures_by_hash_key = hash;
+    }
   }
 }
 
@@ -782,10 +797,10 @@ TextureCacheBase::DoPartialTextureUpdates(TCacheEntry* entry_to_update, const u8
 
   u32 numBlocksX = (entry_to_update->native_width + block_width - 1) / block_width;
 
-  auto iter = FindOverlappingTextures(entry_to_update->addr, entry_to_update->size_in_bytes);
-  while (iter.first != iter.second)
+  for (TCacheEntry* overlapping_entry :
+       FindOverlappingTextures(entry_to_update->addr, entry_to_update->size_in_bytes))
   {
-    TCacheEntry* entry = iter.first->second;
+    TCacheEntry* entry = overlapping_entry;
     if (entry != entry_to_update && entry->IsCopy() && !entry->tmem_only &&
         entry->references.count(entry_to_update) == 0 &&
         entry->OverlapsMemoryRange(entry_to_update->addr, entry_to_update->size_in_bytes) &&
@@ -798,7 +813,6 @@ TextureCacheBase::DoPartialTextureUpdates(TCacheEntry* entry_to_update, const u8
         {
           if (!CanReinterpretTextureOnGPU(entry_to_update->format.texfmt, entry->format.texfmt))
           {
-            ++iter.first;
             continue;
           }
 
@@ -822,7 +836,6 @@ TextureCacheBase::DoPartialTextureUpdates(TCacheEntry* entry_to_update, const u8
           }
           else
           {
-            ++iter.first;
             continue;
           }
         }
@@ -884,7 +897,6 @@ TextureCacheBase::DoPartialTextureUpdates(TCacheEntry* entry_to_update, const u8
             static_cast<u32>(dst_x + copy_width) > entry_to_update->GetWidth() ||
             static_cast<u32>(dst_y + copy_height) > entry_to_update->GetHeight())
         {
-          ++iter.first;
           continue;
         }
 
@@ -910,7 +922,7 @@ TextureCacheBase::DoPartialTextureUpdates(TCacheEntry* entry_to_update, const u8
         {
           // Remove the temporary converted texture, it won't be used anywhere else
           // TODO: It would be nice to convert and copy in one step, but this code path isn't common
-          iter.first = InvalidateTexture(iter.first);
+          InvalidateTexture(GetTexCacheIter(overlapping_entry));
           continue;
         }
         else
@@ -924,11 +936,9 @@ TextureCacheBase::DoPartialTextureUpdates(TCacheEntry* entry_to_update, const u8
       else
       {
         // If the hash does not match, this EFB copy will not be used for anything, so remove it
-        iter.first = InvalidateTexture(iter.first);
-        continue;
+        InvalidateTexture(GetTexCacheIter(overlapping_entry));
       }
     }
-    ++iter.first;
   }
 
   return entry_to_update;
@@ -1255,6 +1265,10 @@ TextureCacheBase::GetTexture(const int textureCacheSafetyColorSampleSize, Textur
         texture_info.GetRawAddress(), texture_info.GetFullLevelSize(), MemoryUpdate::TEXTURE_MAP);
   }
 
+  // The texture may be the target of an EFB copy that hasn't been written to RAM yet.
+  if (!texture_info.IsFromTmem())
+    FlushEFBCopiesInRange(texture_info.GetRawAddress(), texture_info.GetFullLevelSize());
+
   // TODO: This doesn't hash GB tiles for preloaded RGBA8 textures (instead, it's hashing more data
   // from the low tmem bank than it should)
   base_hash = Common::GetHash64(texture_info.GetData(), texture_info.GetTextureSize(),
@@ -1463,22 +1477,19 @@ TextureCacheBase::GetTexture(const int textureCacheSafetyColorSampleSize, Textur
       std::max(texture_info.GetTextureSize(), palette_size) <=
           (u32)textureCacheSafetyColorSampleSize * 8)
   {
-    auto hash_range = textures_by_hash.equal_range(full_hash);
-    TexHashCache::iterator hash_iter = hash_range.first;
-    while (hash_iter != hash_range.second)
+    // All parameters, except the address, need to match here
+    TCacheEntry* entry = textures_by_hash.Find(full_hash, [&](const TCacheEntry* candidate) {
+      return candidate->format == full_format &&
+             candidate->native_levels >= texture_info.GetLevelCount() &&
+             candidate->native_width == texture_info.GetRawWidth() &&
+             candidate->native_height == texture_info.GetRawHeight();
+    });
+    if (entry)
     {
-      TCacheEntry* entry = hash_iter->second;
-      // All parameters, except the address, need to match here
-      if (entry->format == full_format && entry->native_levels >= texture_info.GetLevelCount() &&
-          entry->native_width == texture_info.GetRawWidth() &&
-          entry->native_height == texture_info.GetRawHeight())
-      {
-        entry = DoPartialTextureUpdates(hash_iter->second, texture_info.GetTlutAddress(),
-                                        texture_info.GetTlutFormat());
-        entry->texture->FinishedRendering();
-        return entry;
-      }
-      ++hash_iter;
+      entry = DoPartialTextureUpdates(entry, texture_info.GetTlutAddress(),
+                                      texture_info.GetTlutFormat());
+      entry->texture->FinishedRendering();
+      return entry;
     }
   }
 
@@ -1587,16 +1598,17 @@ TextureCacheBase::GetTexture(const int textureCacheSafetyColorSampleSize, Textur
     }
   }
 
-  iter = textures_by_address.emplace(texture_info.GetRawAddress(), entry);
+  entry->SetGeneralParameters(texture_info.GetRawAddress(), texture_info.GetTextureSize(),
+                              full_format, false);
+  InsertTexture(entry);
   if (textureCacheSafetyColorSampleSize == 0 ||
       std::max(texture_info.GetTextureSize(), palette_size) <=
           (u32)textureCacheSafetyColorSampleSize * 8)
   {
-    entry->textures_by_hash_iter = textures_by_hash.emplace(full_hash, entry);
+    textures_by_hash.Add(full_hash, entry);
+    entry->textures_by_hash_key = full_hash;
   }
 
-  entry->SetGeneralParameters(texture_info.GetRawAddress(), texture_info.GetTextureSize(),
-                              full_format, false);
   entry->SetDimensions(texture_info.GetRawWidth(), texture_info.GetRawHeight(),
                        texture_info.GetLevelCount());
   entry->SetHashes(base_hash, full_hash);
@@ -1666,7 +1678,7 @@ TextureCacheBase::GetTexture(const int textureCacheSafetyColorSampleSize, Textur
   INCSTAT(g_stats.num_textures_uploaded);
   SETSTAT(g_stats.num_textures_alive, static_cast<int>(textures_by_address.size()));
 
-  entry = DoPartialTextureUpdates(iter->second, texture_info.GetTlutAddress(),
+  entry = DoPartialTextureUpdates(entry, texture_info.GetTlutAddress(),
                                   texture_info.GetTlutFormat());
 
   // This should only be needed if the texture was updated, or used GPU decoding.
@@ -1688,6 +1700,7 @@ TextureCacheBase::TCacheEntry*
 TextureCacheBase::GetXFBTexture(u32 address, u32 width, u32 height, u32 stride,
                                 MathUtil::Rectangle<int>* display_rect)
 {
+  FlushEFBCopiesInRange(address, height * stride);
   const u8* src_data = Memory::GetPointer(address);
   if (!src_data)
   {
@@ -1741,7 +1754,7 @@ TextureCacheBase::GetXFBTexture(u32 address, u32 width, u32 height, u32 stride,
   entry->texture->FinishedRendering();
 
   // Insert into the texture cache so we can re-use it next frame, if needed.
-  textures_by_address.emplace(entry->addr, entry);
+  InsertTexture(entry);
   SETSTAT(g_stats.num_textures_alive, static_cast<int>(textures_by_address.size()));
   INCSTAT(g_stats.num_textures_uploaded);
 
@@ -1803,15 +1816,14 @@ void TextureCacheBase::StitchXFBCopy(TCacheEntry* stitched_entry)
   std::vector<TCacheEntry*> candidates;
   bool create_upscaled_copy = false;
 
-  auto iter = FindOverlappingTextures(stitched_entry->addr, stitched_entry->size_in_bytes);
-  while (iter.first != iter.second)
+  for (TCacheEntry* entry :
+       FindOverlappingTextures(stitched_entry->addr, stitched_entry->size_in_bytes))
   {
     // Currently, this checks the stride of the VRAM copy against the VI request. Therefore, for
     // interlaced modes, VRAM copies won't be considered candidates. This is okay for now, because
     // our force progressive hack means that an XFB copy should always have a matching stride. If
     // the hack is disabled, XFB2RAM should also be enabled. Should we wish to implement interlaced
     // stitching in the future, this would require a shader which grabs every second line.
-    TCacheEntry* entry = iter.first->second;
     if (entry != stitched_entry && entry->IsCopy() && !entry->tmem_only &&
         entry->OverlapsMemoryRange(stitched_entry->addr, stitched_entry->size_in_bytes) &&
         entry->memory_stride == stitched_entry->memory_stride)
@@ -1827,11 +1839,9 @@ void TextureCacheBase::StitchXFBCopy(TCacheEntry* stitched_entry)
       else
       {
         // If the hash does not match, this EFB copy will not be used for anything, so remove it
-        iter.first = InvalidateTexture(iter.first);
-        continue;
+        InvalidateTexture(GetTexCacheIter(entry));
       }
     }
-    ++iter.first;
   }
 
   if (candidates.empty())
@@ -2100,6 +2110,9 @@ void TextureCacheBase::CopyRenderTargetToTexture(
   const u32 bytes_per_row = num_blocks_x * bytes_per_block;
   const u32 covered_range = num_blocks_y * dstStride;
 
+  // Published copies to the same memory must not overwrite this copy when they are flushed.
+  FlushEFBCopiesInRange(dstAddr, covered_range);
+
   if (dstStride < bytes_per_row)
   {
     // This kind of efb copy results in a scrambled image.
@@ -2223,11 +2236,8 @@ void TextureCacheBase::CopyRenderTargetToTexture(
   // as our efb copy are marked to check them for partial texture updates.
   // TODO: The logic to detect overlapping strided efb copies is not 100% accurate.
   bool strided_efb_copy = dstStride != bytes_per_row;
-  auto iter = FindOverlappingTextures(dstAddr, covered_range);
-  while (iter.first != iter.second)
+  for (TCacheEntry* overlapping_entry : FindOverlappingTextures(dstAddr, covered_range))
   {
-    TCacheEntry* overlapping_entry = iter.first->second;
-
     if (overlapping_entry->addr == dstAddr && overlapping_entry->is_xfb_copy)
     {
       for (auto& reference : overlapping_entry->references)
@@ -2248,7 +2258,7 @@ void TextureCacheBase::CopyRenderTargetToTexture(
       {
         // Pending EFB copies which are completely covered by this new copy can simply be tossed,
         // instead of having to flush them later on, since this copy will write over everything.
-        iter.first = InvalidateTexture(iter.first, true);
+        InvalidateTexture(GetTexCacheIter(overlapping_entry), true);
         continue;
       }
 
@@ -2272,13 +2282,12 @@ void TextureCacheBase::CopyRenderTargetToTexture(
 
       // Do not load textures by hash, if they were at least partly overwritten by an efb copy.
       // In this case, comparing the hash is not enough to check, if two textures are identical.
-      if (overlapping_entry->textures_by_hash_iter != textures_by_hash.end())
+      if (overlapping_entry->textures_by_hash_key)
       {
-        textures_by_hash.erase(overlapping_entry->textures_by_hash_iter);
-        overlapping_entry->textures_by_hash_iter = textures_by_hash.end();
+        textures_by_hash.Remove(*overlapping_entry->textures_by_hash_key, overlapping_entry);
+        overlapping_entry->textures_by_hash_key.reset();
       }
     }
-    ++iter.first;
   }
 
   if (OpcodeDecoder::g_record_fifo_data)
@@ -2299,18 +2308,92 @@ void TextureCacheBase::CopyRenderTargetToTexture(
   {
     const u64 hash = entry->CalculateHash();
     entry->SetHashes(hash, hash);
-    textures_by_address.emplace(dstAddr, entry);
+    InsertTexture(entry);
   }
 }
 
 void TextureCacheBase::FlushEFBCopies()
 {
-  if (m_pending_efb_copies.empty())
+  FlushOldestEFBCopies(m_pending_efb_copies.size());
+}
+
+void TextureCacheBase::FlushOldestEFBCopies(size_t count)
+{
+  if (count == 0)
     return;
 
-  for (TCacheEntry* entry : m_pending_efb_copies)
+  for (size_t i = 0; i < count; i++)
+  {
+    // The entry may be freed by the flush.
+    TCacheEntry* entry = m_pending_efb_copies[i];
+    const u32 address = entry->addr;
+    const u32 size = GetPendingEFBCopyRange(entry);
     FlushEFBCopy(entry);
-  m_pending_efb_copies.clear();
+    if (i < m_published_efb_copies)
+      Memory::RemovePendingGPUWrite(address, size);
+  }
+
+  m_pending_efb_copies.erase(m_pending_efb_copies.begin(), m_pending_efb_copies.begin() + count);
+  m_published_efb_copies -= std::min(m_published_efb_copies, count);
+  m_published_efb_copies_before_frame -= std::min(m_published_efb_copies_before_frame, count);
+}
+
+void TextureCacheBase::FlushCompletedEFBCopies()
+{
+  // Copies complete in the order they were submitted in.
+  size_t count = 0;
+  while (count < m_pending_efb_copies.size() &&
+         m_pending_efb_copies[count]->pending_efb_copy->IsCopyComplete())
+  {
+    count++;
+  }
+  FlushOldestEFBCopies(count);
+}
+
+void TextureCacheBase::PublishEFBCopies()
+{
+  if (!g_ActiveConfig.bAsyncEFBCopies || !Memory::CanDeferGPUWrites())
+  {
+    FlushEFBCopies();
+    return;
+  }
+
+  FlushCompletedEFBCopies();
+  if (m_published_efb_copies == m_pending_efb_copies.size())
+    return;
+
+  for (size_t i = m_published_efb_copies; i < m_pending_efb_copies.size(); i++)
+  {
+    const TCacheEntry* entry = m_pending_efb_copies[i];
+    Memory::AddPendingGPUWrite(entry->addr, GetPendingEFBCopyRange(entry));
+  }
+  m_published_efb_copies = m_pending_efb_copies.size();
+
+  // Submit the copies, so that they can complete before the CPU gets to them.
+  g_renderer->Flush();
+}
+
+void TextureCacheBase::RetireEFBCopies()
+{
+  FlushOldestEFBCopies(m_published_efb_copies_before_frame);
+  PublishEFBCopies();
+  m_published_efb_copies_before_frame = m_published_efb_copies;
+}
+
+void TextureCacheBase::FlushEFBCopiesInRange(u32 address, u32 size)
+{
+  // Copies have to be written in order, in case they overlap each other.
+  size_t count = 0;
+  for (size_t i = 0; i < m_published_efb_copies; i++)
+  {
+    const TCacheEntry* entry = m_pending_efb_copies[i];
+    if (u64(entry->addr) < u64(address) + size &&
+        u64(entry->addr) + GetPendingEFBCopyRange(entry) > address)
+    {
+      count = i + 1;
+    }
+  }
+  FlushOldestEFBCopies(count);
 }
 
 void TextureCacheBase::WriteEFBCopyToRAM(u8* dst_ptr, u32 width, u32 height, u32 stride,
@@ -2347,10 +2430,8 @@ void TextureCacheBase::FlushEFBCopy(TCacheEntry* entry)
   if (entry->is_xfb_copy)
   {
     const u32 covered_range = entry->pending_efb_copy_height * entry->memory_stride;
-    auto range = FindOverlappingTextures(entry->addr, covered_range);
-    for (auto iter = range.first; iter != range.second; ++iter)
+    for (TCacheEntry* overlapping_entry : FindOverlappingTextures(entry->addr, covered_range))
     {
-      TCacheEntry* overlapping_entry = iter->second;
       if (overlapping_entry->may_have_overlapping_textures && overlapping_entry->is_xfb_copy &&
           overlapping_entry->OverlapsMemoryRange(entry->addr, covered_range))
       {
@@ -2434,7 +2515,6 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::AllocateCacheEntry(const Textur
 
   TCacheEntry* cacheEntry =
       new TCacheEntry(std::move(alloc->texture), std::move(alloc->framebuffer));
-  cacheEntry->textures_by_hash_iter = textures_by_hash.end();
   cacheEntry->id = last_entry_id++;
   return cacheEntry;
 }
@@ -2505,21 +2585,24 @@ TextureCacheBase::GetTexCacheIter(TextureCacheBase::TCacheEntry* entry)
   return textures_by_address.end();
 }
 
-std::pair<TextureCacheBase::TexAddrCache::iterator, TextureCacheBase::TexAddrCache::iterator>
-TextureCacheBase::FindOverlappingTextures(u32 addr, u32 size_in_bytes)
+TextureCacheBase::TexAddrCache::iterator TextureCacheBase::InsertTexture(TCacheEntry* entry)
 {
-  // We index by the starting address only, so there is no way to query all textures
-  // which end after the given addr. But the GC textures have a limited size, so we
-  // look for all textures which have a start address bigger than addr minus the maximal
-  // texture size. But this yields false-positives which must be checked later on.
+  textures_by_page.Add(entry);
+  return textures_by_address.emplace(entry->addr, entry);
+}
 
-  // 1024 x 1024 texel times 8 nibbles per texel
-  constexpr u32 max_texture_size = 1024 * 1024 * 4;
-  u32 lower_addr = addr > max_texture_size ? addr - max_texture_size : 0;
-  auto begin = textures_by_address.lower_bound(lower_addr);
-  auto end = textures_by_address.upper_bound(addr + size_in_bytes);
+std::vector<TextureCacheBase::TCacheEntry*>
+TextureCacheBase::FindOverlappingTextures(u32 addr, u32 size_in_bytes)
+{
+  std::vector<TCacheEntry*> entries;
+  textures_by_page.FindOverlapping(addr, size_in_bytes, &entries);
 
-  return std::make_pair(begin, end);
+  // Keep the order of textures_by_address, where textures at the same address are in the order
+  // they were created in.
+  std::sort(entries.begin(), entries.end(), [](const TCacheEntry* a, const TCacheEntry* b) {
+    return std::tie(a->addr, a->id) < std::tie(b->addr, b->id);
+  });
+  return entries;
 }
 
 TextureCacheBase::TexAddrCache::iterator
@@ -2530,10 +2613,10 @@ TextureCacheBase::InvalidateTexture(TexAddrCache::iterator iter, bool discard_pe
 
   TCacheEntry* entry = iter->second;
 
-  if (entry->textures_by_hash_iter != textures_by_hash.end())
+  if (entry->textures_by_hash_key)
   {
-    textures_by_hash.erase(entry->textures_by_hash_iter);
-    entry->textures_by_hash_iter = textures_by_hash.end();
+    textures_by_hash.Remove(*entry->textures_by_hash_key, entry);
+    entry->textures_by_hash_key.reset();
   }
 
   for (size_t i = 0; i < bound_textures.size(); ++i)
@@ -2557,14 +2640,18 @@ TextureCacheBase::InvalidateTexture(TexAddrCache::iterator iter, bool discard_pe
   // eventually flushed, they will overwrite each other, and the end result should be the same.
   if (entry->pending_efb_copy)
   {
-    if (discard_pending_efb_copy)
+    // Copies that have been published have to be written, as the CPU may already be waiting for
+    // them.
+    auto pending_it = std::find(m_pending_efb_copies.begin(), m_pending_efb_copies.end(), entry);
+    const bool published =
+        static_cast<size_t>(pending_it - m_pending_efb_copies.begin()) < m_published_efb_copies;
+    if (discard_pending_efb_copy && !published)
     {
       // If the RAM copy is being completely overwritten by a new EFB copy, we can discard the
       // existing pending copy, and not bother waiting for it in the future. This happens in
       // Xenoblade's sunset scene, where 35 copies are done per frame, and 25 of them are
       // copied to the same address, and can be skipped.
       ReleaseEFBCopyStagingTexture(std::move(entry->pending_efb_copy));
-      auto pending_it = std::find(m_pending_efb_copies.begin(), m_pending_efb_copies.end(), entry);
       if (pending_it != m_pending_efb_copies.end())
         m_pending_efb_copies.erase(pending_it);
     }
@@ -2574,6 +2661,8 @@ TextureCacheBase::InvalidateTexture(TexAddrCache::iterator iter, bool discard_pe
     }
   }
 
+  textures_by_page.Remove(entry);
+
   auto config = entry->texture->GetConfig();
   texture_pool.emplace(config,
                        TexPoolEntry(std::move(entry->texture), std::move(entry->framebuffer)));
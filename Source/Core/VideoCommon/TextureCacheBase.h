@@ -18,6 +18,7 @@
 #include "Common/MathUtil.h"
 #include "VideoCommon/AbstractTexture.h"
 #include "VideoCommon/BPMemory.h"
+#include "VideoCommon/TextureCacheIndex.h"
 #include "VideoCommon/TextureConfig.h"
 #include "VideoCommon/TextureDecoder.h"
 #include "VideoCommon/TextureInfo.h"
@@ -115,9 +116,8 @@ public:
     // used to delete textures which haven't been used for TEXTURE_KILL_THRESHOLD frames
     int frameCount = FRAMECOUNT_INVALID;
 
-    // Keep an iterator to the entry in textures_by_hash, so it does not need to be searched when
-    // removing the cache entry
-    std::multimap<u64, TCacheEntry*>::iterator textures_by_hash_iter;
+    // The hash the entry is stored under in textures_by_hash, if it is in there at all
+    std::optional<u64> textures_by_hash_key;
 
     // This is used to keep track of both:
     //   * efb copies used by this partially updated texture
@@ -233,6 +233,18 @@ public:
   // Flushes all pending EFB copies to emulated RAM.
   void FlushEFBCopies();
 
+  // Called when the CPU may observe the pending EFB copies. With asynchronous EFB copies, the
+  // copies the GPU has finished are written to RAM, and the others are flushed when the CPU
+  // accesses their memory. Otherwise, all pending copies are flushed.
+  void PublishEFBCopies();
+
+  // Called at the end of a frame. Like PublishEFBCopies(), but also flushes the copies that have
+  // been waiting since before the previous frame ended.
+  void RetireEFBCopies();
+
+  // Flushes the published EFB copies overlapping the range, along with the ones issued before them.
+  void FlushEFBCopiesInRange(u32 address, u32 size);
+
   // Texture Serialization
   void SerializeTexture(AbstractTexture* tex, const TextureConfig& config, PointerWrap& p);
   std::optional<TexPoolEntry> DeserializeTexture(PointerWrap& p);
@@ -273,7 +285,8 @@ protected:
 
 private:
   using TexAddrCache = std::multimap<u32, TCacheEntry*>;
-  using TexHashCache = std::multimap<u64, TCacheEntry*>;
+  using TexPageIndex = TextureAddressIndex<TCacheEntry>;
+  using TexHashCache = TextureHashIndex<TCacheEntry>;
   using TexPool = std::unordered_multimap<TextureConfig, TexPoolEntry>;
 
   bool CreateUtilityTextures();
@@ -298,10 +311,12 @@ private:
   TexPool::iterator FindMatchingTextureFromPool(const TextureConfig& config);
   TexAddrCache::iterator GetTexCacheIter(TCacheEntry* entry);
 
-  // Return all possible overlapping textures. As addr+size of the textures is not
-  // indexed, this may return false positives.
-  std::pair<TexAddrCache::iterator, TexAddrCache::iterator>
-  FindOverlappingTextures(u32 addr, u32 size_in_bytes);
+  // Adds a texture to the cache, under the address and size it was given already.
+  TexAddrCache::iterator InsertTexture(TCacheEntry* entry);
+
+  // Return all possible overlapping textures, ordered by address. Textures are indexed by the
+  // pages they cover, so this may return false positives.
+  std::vector<TCacheEntry*> FindOverlappingTextures(u32 addr, u32 size_in_bytes);
 
   // Removes and unlinks texture from texture cache and returns it to the pool
   TexAddrCache::iterator InvalidateTexture(TexAddrCache::iterator t_iter,
@@ -320,6 +335,11 @@ private:
                          std::unique_ptr<AbstractStagingTexture> staging_texture);
   void FlushEFBCopy(TCacheEntry* entry);
 
+  // Flushes the first count pending EFB copies, which are the oldest.
+  void FlushOldestEFBCopies(size_t count);
+  // Flushes the oldest pending EFB copies that the GPU has already completed.
+  void FlushCompletedEFBCopies();
+
   // Returns a staging texture of the maximum EFB copy size.
   std::unique_ptr<AbstractStagingTexture> GetEFBCopyStagingTexture();
 
@@ -331,6 +351,7 @@ private:
   void DoLoadState(PointerWrap& p);
 
   TexAddrCache textures_by_address;
+  TexPageIndex textures_by_page;
   TexHashCache textures_by_hash;
   TexPool texture_pool;
   u64 last_entry_id = 0;
@@ -366,6 +387,11 @@ private:
   // so that overlapping textures are written to guest RAM in the order they are issued.
   std::vector<TCacheEntry*> m_pending_efb_copies;
 
+  // The number of pending EFB copies at the front of the list that have been published to the CPU,
+  // and how many of them were already published when the previous frame ended.
+  size_t m_published_efb_copies = 0;
+  size_t m_published_efb_copies_before_frame = 0;
+
   // Staging texture used for readbacks.
   // We store this in the class so that the same staging texture can be used for multiple
   // readbacks, saving the overhead of allocating a new buffer every time.
@@ -0,0 +1,215 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+// Finds the entries covering the same pages of guest memory as a range. Every entry is linked into
+// a flat table of buckets, once for each page it covers, so a query only has to look at the
+// entries on the pages of the range. Pages which are further apart than the table covers share
+// buckets, and are told apart again when querying.
+// Entry needs addr and size_in_bytes members, which must not change while it is linked.
+template <typename Entry>
+class TextureAddressIndex
+{
+public:
+  static constexpr u32 PAGE_SHIFT = 14;
+  static constexpr u32 BUCKET_COUNT = 0x1000;
+
+  TextureAddressIndex() : m_buckets(BUCKET_COUNT) {}
+
+  void Add(Entry* entry)
+  {
+    ForEachPage(entry->addr, entry->size_in_bytes,
+                [&](u64 page) { GetBucket(page).push_back(entry); });
+  }
+
+  void Remove(Entry* entry)
+  {
+    ForEachPage(entry->addr, entry->size_in_bytes, [&](u64 page) {
+      std::vector<Entry*>& bucket = GetBucket(page);
+      const auto it = std::find(bucket.begin(), bucket.end(), entry);
+      if (it == bucket.end())
+        return;
+      *it = bucket.back();
+      bucket.pop_back();
+    });
+  }
+
+  void Clear()
+  {
+    for (std::vector<Entry*>& bucket : m_buckets)
+      bucket.clear();
+  }
+
+  // Appends every entry sharing a page with the range to out, once and in no particular order.
+  // This includes entries which don't actually overlap the range.
+  void FindOverlapping(u32 address, u32 size, std::vector<Entry*>* out) const
+  {
+    const u64 first_page = address >> PAGE_SHIFT;
+    ForEachPage(address, size, [&](u64 page) {
+      for (Entry* entry : m_buckets[page % BUCKET_COUNT])
+      {
+        // Only report an entry on the first page it shares with the range.
+        const u64 entry_first_page = entry->addr >> PAGE_SHIFT;
+        if (std::max(entry_first_page, first_page) == page &&
+            LastPage(entry->addr, entry->size_in_bytes) >= page)
+        {
+          out->push_back(entry);
+        }
+      }
+    });
+  }
+
+private:
+  // Empty ranges still belong to the page they start on.
+  static u64 LastPage(u32 address, u32 size)
+  {
+    return (u64(address) + std::max<u32>(size, 1) - 1) >> PAGE_SHIFT;
+  }
+
+  template <typename F>
+  static void ForEachPage(u32 address, u32 size, F f)
+  {
+    const u64 last_page = LastPage(address, size);
+    for (u64 page = address >> PAGE_SHIFT; page <= last_page; page++)
+      f(page);
+  }
+
+  std::vector<Entry*>& GetBucket(u64 page) { return m_buckets[page % BUCKET_COUNT]; }
+
+  std::vector<std::vector<Entry*>> m_buckets;
+};
+
+// A multimap from texture hashes to entries, stored in a single array with linear probing. The keys
+// are hashes already, so their low bits pick the slot directly.
+template <typename Entry>
+class TextureHashIndex
+{
+public:
+  void Add(u64 key, Entry* entry)
+  {
+    if ((m_used + 1) * 4 > m_slots.size() * 3)
+      Rehash(std::max<size_t>(MIN_CAPACITY, (m_size + 1) * 2));
+
+    // Tombstones aren't reused, so that entries with the same key stay in the order they were
+    // added in, like they would in a std::multimap.
+    size_t index = FirstIndex(key);
+    while (m_slots[index].state != SlotState::Empty)
+      index = NextIndex(index);
+    m_slots[index] = {key, entry, SlotState::Full};
+    m_size++;
+    m_used++;
+  }
+
+  void Remove(u64 key, Entry* entry)
+  {
+    if (m_slots.empty())
+      return;
+
+    for (size_t index = FirstIndex(key); m_slots[index].state != SlotState::Empty;
+         index = NextIndex(index))
+    {
+      Slot& slot = m_slots[index];
+      if (slot.state == SlotState::Full && slot.key == key && slot.entry == entry)
+      {
+        slot.state = SlotState::Removed;
+        m_size--;
+        return;
+      }
+    }
+  }
+
+  // Returns the first entry with the key that the predicate accepts, or nullptr.
+  template <typename F>
+  Entry* Find(u64 key, F predicate) const
+  {
+    if (m_slots.empty())
+      return nullptr;
+
+    for (size_t index = FirstIndex(key); m_slots[index].state != SlotState::Empty;
+         index = NextIndex(index))
+    {
+      const Slot& slot = m_slots[index];
+      if (slot.state == SlotState::Full && slot.key == key && predicate(slot.entry))
+        return slot.entry;
+    }
+    return nullptr;
+  }
+
+  // Calls f(key, entry) for every entry.
+  template <typename F>
+  void ForEach(F f) const
+  {
+    for (const Slot& slot : m_slots)
+    {
+      if (slot.state == SlotState::Full)
+        f(slot.key, slot.entry);
+    }
+  }
+
+  void Clear()
+  {
+    m_slots.clear();
+    m_size = 0;
+    m_used = 0;
+  }
+
+  size_t Size() const { return m_size; }
+
+private:
+  static constexpr size_t MIN_CAPACITY = 64;
+
+  enum class SlotState : u8
+  {
+    Empty,
+    Full,
+    Removed,
+  };
+
+  struct Slot
+  {
+    u64 key;
+    Entry* entry;
+    SlotState state;
+  };
+
+  size_t FirstIndex(u64 key) const { return static_cast<size_t>(key) & (m_slots.size() - 1); }
+  size_t NextIndex(size_t index) const { return (index + 1) & (m_slots.size() - 1); }
+
+  void Rehash(size_t min_capacity)
+  {
+    size_t capacity = MIN_CAPACITY;
+    while (capacity < min_capacity)
+      capacity *= 2;
+
+    // Probe sequences may wrap around the end of the array, so the old slots are visited starting
+    // from an empty one to keep entries with the same key in order.
+    const std::vector<Slot> old_slots =
+        std::exchange(m_slots, std::vector<Slot>(capacity, Slot{0, nullptr, SlotState::Empty}));
+    m_size = 0;
+    m_used = 0;
+
+    const auto first_empty =
+        std::find_if(old_slots.begin(), old_slots.end(),
+                     [](const Slot& slot) { return slot.state == SlotState::Empty; });
+    const size_t start = first_empty == old_slots.end() ? 0 : first_empty - old_slots.begin();
+    for (size_t i = 0; i < old_slots.size(); i++)
+    {
+      const Slot& slot = old_slots[(start + i) % old_slots.size()];
+      if (slot.state == SlotState::Full)
+        Add(slot.key, slot.entry);
+    }
+  }
+
+  std::vector<Slot> m_slots;
+  // The number of entries, and the number of slots that aren't empty, including tombstones.
+  size_t m_size = 0;
+  size_t m_used = 0;
+};
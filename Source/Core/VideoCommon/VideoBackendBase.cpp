@@ -194,6 +194,24 @@ u16 VideoBackendBase::Video_GetBoundingBox(int index)
   return result;
 }
 
+void VideoBackendBase::Video_WaitForEFBCopies(u32 address, u32 size)
+{
+  // Texture loads and other DMA on the GPU thread can't wait for themselves.
+  if (Core::IsGPUThread())
+  {
+    if (g_texture_cache)
+      g_texture_cache->FlushEFBCopiesInRange(address, size);
+    return;
+  }
+
+  AsyncRequests::Event e;
+  e.time = 0;
+  e.type = AsyncRequests::Event::FLUSH_EFB_COPIES;
+  e.flush_efb_copies.address = address;
+  e.flush_efb_copies.size = size;
+  AsyncRequests::GetInstance()->PushEvent(e, true);
+}
+
 static VideoBackendBase* GetDefaultVideoBackend()
 {
   const auto& backends = VideoBackendBase::GetAvailableBackends();
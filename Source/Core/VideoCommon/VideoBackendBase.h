@@ -57,6 +57,8 @@ public:
   u32 Video_AccessEFB(EFBAccessType type, u32 x, u32 y, u32 data);
   u32 Video_GetQueryResult(PerfQueryType type);
   u16 Video_GetBoundingBox(int index);
+  // Waits until the EFB copies overlapping the range have been written to RAM.
+  void Video_WaitForEFBCopies(u32 address, u32 size);
 
   static std::string GetDefaultBackendName();
   static const std::vector<std::unique_ptr<VideoBackendBase>>& GetAvailableBackends();
@@ -123,6 +123,7 @@ struct VideoConfig final
   bool bSkipXFBCopyToRam;
   bool bDisableCopyToVRAM;
   bool bDeferEFBCopies;
+  bool bAsyncEFBCopies;
   bool bImmediateXFB;
   bool bSkipPresentingDuplicateXFBs;
   bool bCopyEFBScaled;
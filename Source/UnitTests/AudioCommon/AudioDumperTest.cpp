@@ -0,0 +1,330 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "AudioCommon/AudioDumper.h"
+#include "AudioCommon/WaveFile.h"
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/Swap.h"
+
+#include "../UserDirectoryTest.h"
+
+namespace
+{
+constexpr u32 SAMPLE_RATE = 32000;
+
+// Big endian, right channel first, like the DSP outputs.
+std::vector<short> GenerateSamples(u32 count)
+{
+  std::vector<short> samples(count * 2);
+  for (u32 i = 0; i < count; ++i)
+  {
+    const short left = static_cast<short>(8000 * std::sin(i * 0.05));
+    const short right = static_cast<short>(6000 * std::sin(i * 0.03) + (i % 7));
+    samples[2 * i] = static_cast<short>(Common::swap16(static_cast<u16>(right)));
+    samples[2 * i + 1] = static_cast<short>(Common::swap16(static_cast<u16>(left)));
+  }
+  return samples;
+}
+
+std::vector<short> ConvertReference(const std::vector<short>& samples)
+{
+  std::vector<short> output(samples.size());
+  for (size_t i = 0; i < samples.size(); i += 2)
+  {
+    output[i] = static_cast<short>(Common::swap16(static_cast<u16>(samples[i + 1])));
+    output[i + 1] = static_cast<short>(Common::swap16(static_cast<u16>(samples[i])));
+  }
+  return output;
+}
+
+// Enough of a FLAC decoder to read what FlacFileWriter writes: fixed block size frames with
+// constant, verbatim and fixed subframes, and Rice coded residuals. Returns the native endian
+// samples with the left channel first, or nothing if the stream is malformed.
+class FlacDecoder
+{
+public:
+  explicit FlacDecoder(const std::string& data) : m_data(data) {}
+
+  std::vector<short> Decode()
+  {
+    std::vector<short> output;
+    if (Read(32) != 0x664C6143)  // "fLaC"
+      return {};
+
+    // Skip the metadata blocks.
+    bool last = false;
+    while (!last && !m_failed)
+    {
+      last = Read(1);
+      Read(7);
+      const u32 size = Read(24);
+      m_position += size * 8;
+    }
+
+    while (!m_failed && m_position < m_data.size() * 8)
+    {
+      if (!DecodeFrame(&output))
+        return {};
+    }
+    return m_failed ? std::vector<short>{} : output;
+  }
+
+private:
+  bool DecodeFrame(std::vector<short>* output)
+  {
+    if (Read(16) != 0xFFF8 || Read(4) != 0x7 || Read(4) != 0x0)
+      return false;
+    const u32 assignment = Read(4);
+    if (Read(3) != 0x4 || Read(1) != 0)
+      return false;
+
+    // Frame number, in FLAC's UTF-8 variant.
+    const u32 first = Read(8);
+    for (u32 mask = 0x40; first & 0x80 && first & mask; mask >>= 1)
+      Read(8);
+
+    const u32 block_size = Read(16) + 1;
+    Read(8);  // CRC-8
+
+    const bool side_first = assignment == 0x9;
+    const bool side_second = assignment == 0x8 || assignment == 0xA;
+    std::vector<s32> first_channel = DecodeSubframe(block_size, 16 + side_first);
+    std::vector<s32> second_channel = DecodeSubframe(block_size, 16 + side_second);
+
+    if (m_position % 8 != 0)
+      m_position += 8 - m_position % 8;
+    Read(16);  // CRC-16
+    if (m_failed)
+      return false;
+
+    for (u32 i = 0; i < block_size; ++i)
+    {
+      s32 left = first_channel[i], right = second_channel[i];
+      switch (assignment)
+      {
+      case 0x1:
+        break;
+      case 0x8:
+        right = left - right;
+        break;
+      case 0x9:
+        left = left + right;
+        break;
+      case 0xA:
+      {
+        const s32 mid = (first_channel[i] << 1) | (second_channel[i] & 1);
+        left = (mid + second_channel[i]) >> 1;
+        right = (mid - second_channel[i]) >> 1;
+        break;
+      }
+      default:
+        return false;
+      }
+      output->push_back(static_cast<short>(left));
+      output->push_back(static_cast<short>(right));
+    }
+    return true;
+  }
+
+  std::vector<s32> DecodeSubframe(u32 block_size, u32 bits_per_sample)
+  {
+    std::vector<s32> samples;
+    const u32 header = Read(8);
+    if (header == 0x00)
+    {
+      samples.assign(block_size, ReadSigned(bits_per_sample));
+    }
+    else if (header == 0x02)
+    {
+      for (u32 i = 0; i < block_size; ++i)
+        samples.push_back(ReadSigned(bits_per_sample));
+    }
+    else if ((header & 0xF1) == 0x10 && ((header >> 1) & 7) <= 4)
+    {
+      const u32 order = (header >> 1) & 7;
+      for (u32 i = 0; i < order; ++i)
+        samples.push_back(ReadSigned(bits_per_sample));
+
+      if (Read(2) != 0)
+        m_failed = true;
+      const u32 partition_order = Read(4);
+      const u32 partition_size = block_size >> partition_order;
+      for (u32 partition = 0; partition < (1u << partition_order) && !m_failed; ++partition)
+      {
+        const u32 parameter = Read(4);
+        if (parameter == 15)
+          m_failed = true;
+        const u32 count = partition == 0 ? partition_size - order : partition_size;
+        for (u32 i = 0; i < count && !m_failed; ++i)
+        {
+          u32 quotient = 0;
+          while (!m_failed && Read(1) == 0)
+            ++quotient;
+          const u32 folded = (quotient << parameter) | Read(parameter);
+          const s32 residual = static_cast<s32>(folded >> 1) ^ -static_cast<s32>(folded & 1);
+          samples.push_back(residual + Predict(samples, order));
+        }
+      }
+    }
+    else
+    {
+      m_failed = true;
+    }
+
+    if (samples.size() != block_size)
+      m_failed = true;
+    samples.resize(block_size);
+    return samples;
+  }
+
+  static s32 Predict(const std::vector<s32>& samples, u32 order)
+  {
+    const s32* x = samples.data() + samples.size();
+    switch (order)
+    {
+    case 0:
+      return 0;
+    case 1:
+      return x[-1];
+    case 2:
+      return 2 * x[-1] - x[-2];
+    case 3:
+      return 3 * x[-1] - 3 * x[-2] + x[-3];
+    default:
+      return 4 * x[-1] - 6 * x[-2] + 4 * x[-3] - x[-4];
+    }
+  }
+
+  u32 Read(u32 bits)
+  {
+    u32 value = 0;
+    for (u32 i = 0; i < bits; ++i, ++m_position)
+    {
+      if (m_position >= m_data.size() * 8)
+      {
+        m_failed = true;
+        return 0;
+      }
+      const u8 byte = static_cast<u8>(m_data[m_position / 8]);
+      value = (value << 1) | ((byte >> (7 - m_position % 8)) & 1);
+    }
+    return value;
+  }
+
+  s32 ReadSigned(u32 bits)
+  {
+    const u32 value = Read(bits);
+    return static_cast<s32>(value << (32 - bits)) >> (32 - bits);
+  }
+
+  const std::string& m_data;
+  size_t m_position = 0;
+  bool m_failed = false;
+};
+
+class AudioDumperTest : public UserDirectoryTest
+{
+protected:
+  // Pushes the samples in small chunks, like the mixer does.
+  void Dump(const std::string& filename, const std::vector<short>& samples)
+  {
+    AudioCommon::AudioDumper dumper;
+    ASSERT_TRUE(dumper.Start(filename, SAMPLE_RATE));
+    constexpr u32 CHUNK_SIZE = 160;
+    const u32 count = static_cast<u32>(samples.size() / 2);
+    for (u32 i = 0; i < count; i += CHUNK_SIZE)
+      dumper.AddStereoSamplesBE(&samples[i * 2], std::min(CHUNK_SIZE, count - i), SAMPLE_RATE);
+    dumper.Stop();
+  }
+};
+}  // namespace
+
+TEST(AudioDumper, ConvertStereoSamplesBE)
+{
+  // An odd count exercises both the vectorized and the scalar path.
+  const std::vector<short> samples = GenerateSamples(1001);
+  std::vector<short> output(samples.size());
+  AudioCommon::ConvertStereoSamplesBE(output.data(), samples.data(), 1001);
+  EXPECT_EQ(output, ConvertReference(samples));
+}
+
+TEST_F(AudioDumperTest, WritesWAV)
+{
+  const std::vector<short> samples = GenerateSamples(10000);
+  const std::string filename = m_user_directory + "/dump.wav";
+  Dump(filename, samples);
+
+  std::string contents;
+  ASSERT_TRUE(File::ReadFileToString(filename, contents));
+  ASSERT_EQ(contents.size(), 44 + samples.size() * sizeof(short));
+
+  std::vector<short> written(samples.size());
+  std::memcpy(written.data(), contents.data() + 44, samples.size() * sizeof(short));
+  EXPECT_EQ(written, ConvertReference(samples));
+}
+
+TEST_F(AudioDumperTest, WritesFLAC)
+{
+  const u32 count = 3 * FlacFileWriter::BLOCK_SIZE + 123;
+  const std::vector<short> samples = GenerateSamples(count);
+  const std::string filename = m_user_directory + "/dump.flac";
+  Dump(filename, samples);
+
+  std::string contents;
+  ASSERT_TRUE(File::ReadFileToString(filename, contents));
+  ASSERT_GT(contents.size(), 42u);
+  EXPECT_EQ(contents.substr(0, 4), "fLaC");
+
+  // STREAMINFO: 20-bit sample rate, 3-bit channels, 5-bit sample size, 36-bit sample count.
+  const auto* info = reinterpret_cast<const u8*>(contents.data()) + 8;
+  EXPECT_EQ((info[10] << 12) | (info[11] << 4) | (info[12] >> 4), static_cast<int>(SAMPLE_RATE));
+  EXPECT_EQ(((info[12] >> 1) & 7) + 1, 2);
+  EXPECT_EQ((((info[12] & 1) << 4) | (info[13] >> 4)) + 1, 16);
+  EXPECT_EQ((u32(info[14]) << 24) | (info[15] << 16) | (info[16] << 8) | info[17], count);
+
+  // Smooth signals must compress well.
+  EXPECT_LT(contents.size(), samples.size() * sizeof(short) / 2);
+}
+
+TEST_F(AudioDumperTest, FLACRoundTrip)
+{
+  // Blocks of a smooth signal, noise, silence, identical channels, channels which only differ in
+  // their sum or in one of them, and a partial block. Between them, they need every kind of
+  // subframe and stereo decorrelation.
+  constexpr u32 BLOCK_SIZE = FlacFileWriter::BLOCK_SIZE;
+  std::vector<short> samples = GenerateSamples(7 * BLOCK_SIZE + 1000);
+  const auto set_frame = [&samples](u32 i, s32 left, s32 right) {
+    samples[2 * i] = static_cast<short>(Common::swap16(static_cast<u16>(right)));
+    samples[2 * i + 1] = static_cast<short>(Common::swap16(static_cast<u16>(left)));
+  };
+  std::mt19937 rng(0);
+  for (u32 i = 0; i < BLOCK_SIZE; ++i)
+  {
+    const s32 smooth = static_cast<s32>(8000 * std::sin(i * 0.01));
+    const s32 noise = static_cast<s32>(rng() % 4001) - 2000;
+    const s32 small_noise = static_cast<s32>(rng() % 65) - 32;
+    set_frame(BLOCK_SIZE + i, static_cast<short>(rng()), static_cast<short>(rng()));
+    set_frame(2 * BLOCK_SIZE + i, 0, 0);
+    set_frame(3 * BLOCK_SIZE + i, smooth, smooth);
+    set_frame(4 * BLOCK_SIZE + i, smooth + noise, smooth - noise);
+    set_frame(5 * BLOCK_SIZE + i, smooth + small_noise, smooth);
+  }
+  set_frame(7 * BLOCK_SIZE, -0x8000, 0x7fff);
+
+  const std::string filename = m_user_directory + "/dump.flac";
+  Dump(filename, samples);
+
+  std::string contents;
+  ASSERT_TRUE(File::ReadFileToString(filename, contents));
+  EXPECT_EQ(FlacDecoder(contents).Decode(), ConvertReference(samples));
+}
@@ -0,0 +1,64 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+
+#include "AudioCommon/LatencyController.h"
+#include "Common/CommonTypes.h"
+
+namespace
+{
+constexpr u32 SAMPLE_RATE = 48000;
+constexpr u32 CALLBACK_FRAMES = 480;
+
+// Simulates one second of audio callbacks with the given amount of queued audio.
+void RunOneSecond(AudioCommon::LatencyController& controller, u32 queued_frames)
+{
+  for (u32 i = 0; i < SAMPLE_RATE / CALLBACK_FRAMES; ++i)
+    controller.OnCallback(CALLBACK_FRAMES, queued_frames);
+}
+}  // namespace
+
+TEST(LatencyController, GrowsFIFOWhenStarved)
+{
+  AudioCommon::LatencyController controller(SAMPLE_RATE, 512, 512, 512, 20);
+
+  RunOneSecond(controller, CALLBACK_FRAMES / 2);
+  EXPECT_GT(controller.GetFIFOTargetMs(), 20u);
+}
+
+TEST(LatencyController, ShrinksFIFOWhenStable)
+{
+  AudioCommon::LatencyController controller(SAMPLE_RATE, 512, 512, 512, 20);
+
+  // Plenty of audio is always queued, so the target should slowly go down.
+  for (int i = 0; i < 5; ++i)
+    RunOneSecond(controller, CALLBACK_FRAMES * 4);
+  EXPECT_LT(controller.GetFIFOTargetMs(), 20u);
+  EXPECT_GT(controller.GetFIFOTargetMs(), 0u);
+
+  // The backend buffer can't change when its bounds are equal.
+  EXPECT_EQ(512u, controller.GetBackendFrames());
+  EXPECT_EQ((512 + CALLBACK_FRAMES * 4) / (SAMPLE_RATE / 1000), controller.GetLatencyMs());
+}
+
+TEST(LatencyController, GrowsBackendOnUnderrun)
+{
+  AudioCommon::LatencyController controller(SAMPLE_RATE, 256, 4096, 512, 20);
+
+  controller.OnBackendUnderrun();
+  RunOneSecond(controller, CALLBACK_FRAMES * 4);
+  EXPECT_GT(controller.GetBackendFrames(), 512u);
+  EXPECT_LE(controller.GetBackendFrames(), 4096u);
+}
+
+TEST(LatencyController, GrowsFIFOOnUnderrunWithFixedBackend)
+{
+  AudioCommon::LatencyController controller(SAMPLE_RATE, 512, 512, 512, 20);
+
+  // The FIFO never runs dry, but the backend buffer can't grow to cover the underrun.
+  controller.OnBackendUnderrun();
+  RunOneSecond(controller, CALLBACK_FRAMES * 4);
+  EXPECT_EQ(512u, controller.GetBackendFrames());
+  EXPECT_GT(controller.GetFIFOTargetMs(), 20u);
+}
@@ -0,0 +1,152 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "AudioCommon/Mixer.h"
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/Swap.h"
+#include "Core/Config/MainSettings.h"
+#include "Core/ConfigManager.h"
+
+#include "../UserDirectoryTest.h"
+
+namespace
+{
+constexpr u32 INPUT_RATE = 32000;
+constexpr u32 OUTPUT_RATE = 48000;
+
+// Stereo samples in the big endian format used for DMA audio.
+std::vector<s16> ToBigEndian(const std::vector<s16>& samples)
+{
+  std::vector<s16> result(samples.size());
+  std::transform(samples.begin(), samples.end(), result.begin(),
+                 [](s16 sample) { return static_cast<s16>(Common::swap16(sample)); });
+  return result;
+}
+
+// What MixerFifo::Mix computed before it was changed to work on blocks, for a fresh FIFO at
+// full volume.
+std::vector<s16> ReferenceLinearResample(const std::vector<s16>& input, u32 num_frames, u32 ratio)
+{
+  std::vector<s16> output(num_frames * 2);
+  u32 index = 0;
+  u32 frac = 0;
+  for (u32 i = 0; i < num_frames && index + 2 < input.size(); ++i)
+  {
+    const s16 l1 = input[index];
+    const s16 l2 = input[index + 2];
+    const s16 r1 = input[index + 1];
+    const s16 r2 = input[index + 3];
+    output[2 * i + 1] = std::clamp(((l1 << 16) + (l2 - l1) * (u16)frac) >> 16, -32767, 32767);
+    output[2 * i] = std::clamp(((r1 << 16) + (r2 - r1) * (u16)frac) >> 16, -32767, 32767);
+
+    frac += ratio;
+    index += 2 * (u16)(frac >> 16);
+    frac &= 0xffff;
+  }
+  return output;
+}
+
+class MixerTest : public UserDirectoryTest
+{
+protected:
+  void SetUp() override
+  {
+    ASSERT_NO_FATAL_FAILURE(UserDirectoryTest::SetUp());
+    // Don't let the FIFO fill level affect the resampling ratio.
+    SConfig::GetInstance().m_EmulationSpeed = 0.0f;
+  }
+};
+}  // namespace
+
+TEST_F(MixerTest, LinearResamplingMatchesReference)
+{
+  constexpr u32 INPUT_FRAMES = 2048;
+  constexpr u32 OUTPUT_FRAMES = 1024;
+
+  std::mt19937 rng(1234);
+  std::uniform_int_distribution<int> dist(-32768, 32767);
+  std::vector<s16> input(INPUT_FRAMES * 2);
+  for (s16& sample : input)
+    sample = static_cast<s16>(dist(rng));
+
+  Mixer mixer(OUTPUT_RATE);
+  mixer.SetDMAInputSampleRate(INPUT_RATE);
+  mixer.PushSamples(ToBigEndian(input).data(), INPUT_FRAMES);
+
+  std::vector<s16> output(OUTPUT_FRAMES * 2);
+  mixer.Mix(output.data(), OUTPUT_FRAMES);
+
+  const u32 ratio = static_cast<u32>(65536.0f * INPUT_RATE / OUTPUT_RATE);
+  EXPECT_EQ(ReferenceLinearResample(input, OUTPUT_FRAMES, ratio), output);
+}
+
+TEST_F(MixerTest, SincResamplingPreservesConstantSignal)
+{
+  constexpr u32 INPUT_FRAMES = 2048;
+  constexpr u32 OUTPUT_FRAMES = 1024;
+
+  Config::SetCurrent(Config::MAIN_AUDIO_SINC_RESAMPLING, true);
+  Mixer mixer(OUTPUT_RATE);
+  mixer.SetDMAInputSampleRate(INPUT_RATE);
+
+  std::vector<s16> input(INPUT_FRAMES * 2);
+  for (u32 i = 0; i < INPUT_FRAMES; ++i)
+  {
+    input[2 * i] = 1000;
+    input[2 * i + 1] = -2000;
+  }
+  mixer.PushSamples(ToBigEndian(input).data(), INPUT_FRAMES);
+
+  std::vector<s16> output(OUTPUT_FRAMES * 2);
+  mixer.Mix(output.data(), OUTPUT_FRAMES);
+
+  // The first few frames are filtered together with the silence preceding the input.
+  for (u32 i = 8; i < OUTPUT_FRAMES; ++i)
+  {
+    EXPECT_EQ(-2000, output[2 * i]);
+    EXPECT_EQ(1000, output[2 * i + 1]);
+  }
+}
+
+// A microbenchmark rather than a test: it only prints the cost of resampling a 10 ms callback, so
+// it is disabled by default. Run it with --gtest_also_run_disabled_tests.
+TEST_F(MixerTest, DISABLED_ResamplingPerformance)
+{
+  constexpr u32 INPUT_FRAMES = INPUT_RATE / 100;
+  constexpr u32 OUTPUT_FRAMES = OUTPUT_RATE / 100;
+  constexpr u32 ITERATIONS = 2000;
+
+  std::vector<s16> input(INPUT_FRAMES * 2);
+  for (u32 i = 0; i < input.size(); ++i)
+    input[i] = static_cast<s16>(Common::swap16(static_cast<u16>(i * 97)));
+
+  for (const bool sinc : {false, true})
+  {
+    Config::SetCurrent(Config::MAIN_AUDIO_SINC_RESAMPLING, sinc);
+    Mixer mixer(OUTPUT_RATE);
+    mixer.SetDMAInputSampleRate(INPUT_RATE);
+
+    std::vector<s16> output(OUTPUT_FRAMES * 2);
+    std::chrono::nanoseconds total{};
+    for (u32 i = 0; i < ITERATIONS; ++i)
+    {
+      mixer.PushSamples(input.data(), INPUT_FRAMES);
+
+      const auto start = std::chrono::high_resolution_clock::now();
+      mixer.Mix(output.data(), OUTPUT_FRAMES);
+      total += std::chrono::high_resolution_clock::now() - start;
+    }
+
+    printf("%s resampling: %.2f ns per output frame\n", sinc ? "sinc" : "linear",
+           static_cast<double>(total.count()) / (ITERATIONS * OUTPUT_FRAMES));
+  }
+}
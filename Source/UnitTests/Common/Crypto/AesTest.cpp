@@ -0,0 +1,88 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/Crypto/AES.h"
+
+// Test vectors from NIST SP 800-38A, F.2.1/F.2.2 (CBC-AES128)
+constexpr std::array<u8, 16> KEY{{0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7,
+                                  0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c}};
+constexpr std::array<u8, 16> IV{{0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09,
+                                 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f}};
+constexpr std::array<u8, 64> PLAINTEXT{
+    {0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73,
+     0x93, 0x17, 0x2a, 0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7,
+     0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51, 0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4,
+     0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef, 0xf6, 0x9f, 0x24, 0x45,
+     0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10}};
+constexpr std::array<u8, 64> CIPHERTEXT{
+    {0x76, 0x49, 0xab, 0xac, 0x81, 0x19, 0xb2, 0x46, 0xce, 0xe9, 0x8e, 0x9b, 0x12,
+     0xe9, 0x19, 0x7d, 0x50, 0x86, 0xcb, 0x9b, 0x50, 0x72, 0x19, 0xee, 0x95, 0xdb,
+     0x11, 0x3a, 0x91, 0x76, 0x78, 0xb2, 0x73, 0xbe, 0xd6, 0xb8, 0xe3, 0xc1, 0x74,
+     0x3b, 0x71, 0x16, 0xe6, 0x9e, 0x22, 0x22, 0x95, 0x16, 0x3f, 0xf1, 0xca, 0xa1,
+     0x68, 0x1f, 0xac, 0x09, 0x12, 0x0e, 0xca, 0x30, 0x75, 0x86, 0xe1, 0xa7}};
+
+TEST(aes, EncryptCBC)
+{
+  std::array<u8, 16> iv = IV;
+  const std::vector<u8> result =
+      Common::AES::Encrypt(KEY.data(), iv.data(), PLAINTEXT.data(), PLAINTEXT.size());
+  EXPECT_EQ(std::vector<u8>(CIPHERTEXT.begin(), CIPHERTEXT.end()), result);
+  // The IV is updated to the last ciphertext block.
+  EXPECT_TRUE(std::equal(iv.begin(), iv.end(), CIPHERTEXT.end() - 16));
+}
+
+TEST(aes, DecryptCBC)
+{
+  std::array<u8, 16> iv = IV;
+  const std::vector<u8> result =
+      Common::AES::Decrypt(KEY.data(), iv.data(), CIPHERTEXT.data(), CIPHERTEXT.size());
+  EXPECT_EQ(std::vector<u8>(PLAINTEXT.begin(), PLAINTEXT.end()), result);
+  EXPECT_TRUE(std::equal(iv.begin(), iv.end(), CIPHERTEXT.end() - 16));
+}
+
+TEST(aes, ContextLargeBufferInPlace)
+{
+  // Large enough to go through the batched decryption path, plus a few leftover blocks.
+  std::vector<u8> data(0x4000 + 0x30);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<u8>(i * 7);
+  const std::vector<u8> original = data;
+
+  const auto encrypt = Common::AES::CreateContext(KEY.data(), Common::AES::Mode::Encrypt);
+  const auto decrypt = Common::AES::CreateContext(KEY.data(), Common::AES::Mode::Decrypt);
+
+  std::array<u8, 16> iv = IV;
+  encrypt->CryptCBC(iv.data(), data.data(), data.data(), data.size());
+  EXPECT_NE(original, data);
+
+  // Decrypting in two calls must give the same result as decrypting in one.
+  iv = IV;
+  decrypt->CryptCBC(iv.data(), data.data(), data.data(), 0x90);
+  decrypt->CryptCBC(iv.data(), data.data() + 0x90, data.data() + 0x90, data.size() - 0x90);
+  EXPECT_EQ(original, data);
+}
+
+TEST(aes, ContextRejectsPartialBlocks)
+{
+  for (const Common::AES::Mode mode : {Common::AES::Mode::Encrypt, Common::AES::Mode::Decrypt})
+  {
+    const auto context = Common::AES::CreateContext(KEY.data(), mode);
+
+    // Nothing may be read or written past the end of the buffers, so nothing is written at all.
+    std::array<u8, 16> iv = IV;
+    std::array<u8, 32> data{};
+    data.fill(0xa5);
+    EXPECT_FALSE(context->CryptCBC(iv.data(), PLAINTEXT.data(), data.data(), 17));
+    EXPECT_TRUE(std::all_of(data.begin(), data.end(), [](u8 value) { return value == 0xa5; }));
+    EXPECT_EQ(IV, iv);
+
+    EXPECT_TRUE(context->CryptCBC(iv.data(), PLAINTEXT.data(), data.data(), data.size()));
+  }
+}
@@ -0,0 +1,205 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <cstring>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Core/ConfigManager.h"
+#include "Core/HW/DSP.h"
+#include "Core/HW/Memmap.h"
+
+#define AX_GC
+#include "Core/HW/DSPHLE/UCodes/AXVoice.h"
+
+#include "../../UserDirectoryTest.h"
+
+// Processes generated PB lists serially and with a worker pool, and checks that both mix exactly
+// the same samples and write back exactly the same PBs. The PBs read their samples through the
+// simulated accelerator in every format, and hit the end of their sample data in the middle of a
+// frame, so the state each worker keeps for its current voice matters.
+
+using namespace DSP::HLE;
+
+namespace
+{
+constexpr u32 NUM_PBS = 48;
+constexpr u32 PB_BASE = 0x00010000;
+constexpr u32 PB_STRIDE = 0x200;
+constexpr u32 ARAM_DATA_SIZE = 0x10000;
+// A CRC for which the PBs have a low pass filter.
+constexpr u32 CRC = 0;
+constexpr u32 SAMPLES_PER_MS = 32;
+
+constexpr u32 BUFFER_SIZE = GetAXBufferSize(0);
+constexpr size_t NUM_BUFFERS = std::size(AXBuffers{}.ptrs);
+
+using Buffers = std::array<std::array<int, BUFFER_SIZE>, NUM_BUFFERS>;
+
+class AXVoiceTest : public UserDirectoryTest
+{
+protected:
+  void SetUp() override
+  {
+    ASSERT_NO_FATAL_FAILURE(UserDirectoryTest::SetUp());
+    SConfig::GetInstance().bWii = false;
+    Memory::Init();
+    DSP::Reinit(true);
+
+    for (s16& coef : m_polyphase_coefs)
+      coef = static_cast<s16>(m_rng() % 0x4000);
+    for (u32 i = 0; i < ARAM_DATA_SIZE; ++i)
+      DSP::GetARAMPtr()[i] = static_cast<u8>(m_rng());
+  }
+
+  void TearDown() override
+  {
+    DSP::Shutdown();
+    Memory::Shutdown();
+    UserDirectoryTest::TearDown();
+  }
+
+  void WritePBList()
+  {
+    for (u32 i = 0; i < NUM_PBS; ++i)
+    {
+      AXPB pb{};
+      const u32 addr = PB_BASE + i * PB_STRIDE;
+      const u32 next = i + 1 < NUM_PBS ? addr + PB_STRIDE : 0;
+      pb.next_pb_hi = static_cast<u16>(next >> 16);
+      pb.next_pb_lo = static_cast<u16>(next);
+      pb.this_pb_hi = static_cast<u16>(addr >> 16);
+      pb.this_pb_lo = static_cast<u16>(addr);
+
+      pb.src_type = static_cast<u16>(m_rng() % 3);
+      pb.mixer_control = static_cast<u16>(m_rng());
+      pb.running = m_rng() % 8 != 0;
+      pb.is_stream = m_rng() % 2;
+
+      u16* mixer = reinterpret_cast<u16*>(&pb.mixer);
+      for (size_t j = 0; j < sizeof(pb.mixer) / sizeof(u16); ++j)
+        mixer[j] = j % 2 ? static_cast<u16>(m_rng() % 64) : static_cast<u16>(m_rng() % 0x8000);
+      pb.vol_env.cur_volume = static_cast<u16>(m_rng() % 0x8000);
+      pb.vol_env.cur_volume_delta = static_cast<s16>(m_rng() % 64) - 32;
+
+      // Short sample data, so that voices loop or stop within a frame.
+      static constexpr std::array<u16, 3> formats = {AUDIOFORMAT_ADPCM, AUDIOFORMAT_PCM8,
+                                                     AUDIOFORMAT_PCM16};
+      pb.audio_addr.looping = m_rng() % 2;
+      pb.audio_addr.sample_format = formats[m_rng() % formats.size()];
+      const u32 loop_addr = 0x100 + m_rng() % 0x4000;
+      const u32 end_addr = loop_addr + 0x20 + m_rng() % 0x200;
+      const u32 cur_addr = loop_addr + m_rng() % (end_addr - loop_addr);
+      pb.audio_addr.loop_addr_hi = static_cast<u16>(loop_addr >> 16);
+      pb.audio_addr.loop_addr_lo = static_cast<u16>(loop_addr);
+      pb.audio_addr.end_addr_hi = static_cast<u16>(end_addr >> 16);
+      pb.audio_addr.end_addr_lo = static_cast<u16>(end_addr);
+      pb.audio_addr.cur_addr_hi = static_cast<u16>(cur_addr >> 16);
+      pb.audio_addr.cur_addr_lo = static_cast<u16>(cur_addr);
+
+      for (s16& coef : pb.adpcm.coefs)
+        coef = static_cast<s16>(m_rng() % 0x2000) - 0x1000;
+      pb.adpcm.pred_scale = static_cast<u16>(m_rng() % 0x80);
+      pb.adpcm.yn1 = static_cast<s16>(m_rng());
+      pb.adpcm.yn2 = static_cast<s16>(m_rng());
+      pb.adpcm_loop_info.pred_scale = static_cast<u16>(m_rng() % 0x80);
+      pb.adpcm_loop_info.yn1 = static_cast<u16>(m_rng());
+      pb.adpcm_loop_info.yn2 = static_cast<u16>(m_rng());
+
+      const u32 ratio = 0x4000 + m_rng() % 0x1C000;
+      pb.src.ratio_hi = static_cast<u16>(ratio >> 16);
+      pb.src.ratio_lo = static_cast<u16>(ratio);
+      pb.src.cur_addr_frac = static_cast<u16>(m_rng());
+
+      pb.lpf.enabled = m_rng() % 2;
+      pb.lpf.a0 = static_cast<u16>(m_rng() % 0x8000);
+      pb.lpf.b0 = static_cast<u16>(0x7FFF - pb.lpf.a0);
+
+      WritePB(addr, pb, CRC);
+    }
+  }
+
+  void InitBuffers(Buffers* buffers)
+  {
+    for (auto& buffer : *buffers)
+    {
+      for (int& sample : buffer)
+        sample = static_cast<int>(m_rng() % 0x10000) - 0x8000;
+    }
+  }
+
+  // Mirrors AXUCode::ProcessPBList.
+  void ProcessPBList(AXWorkerPool* pool, Buffers* buffers)
+  {
+    const auto get_next_pb = [](u32 addr) -> std::optional<u32> {
+      AXPB pb{};
+      ReadPB(addr, pb, CRC);
+      return HILO_TO_32(pb.next_pb);
+    };
+
+    const auto process_pb = [this](u32 addr, AXBuffers ax_buffers) -> u32 {
+      AXPB pb{};
+      ReadPB(addr, pb, CRC);
+      for (int ms = 0; ms < 5; ++ms)
+      {
+        ProcessVoice(pb, ax_buffers, SAMPLES_PER_MS, static_cast<AXMixControl>(pb.mixer_control),
+                     m_polyphase_coefs.data());
+        for (auto& ptr : ax_buffers.ptrs)
+          ptr += SAMPLES_PER_MS;
+      }
+      WritePB(addr, pb, CRC);
+      return HILO_TO_32(pb.next_pb);
+    };
+
+    AXBuffers ax_buffers;
+    for (size_t i = 0; i < NUM_BUFFERS; ++i)
+      ax_buffers.ptrs[i] = (*buffers)[i].data();
+    ProcessPBs(pool, PB_BASE, ax_buffers, get_next_pb, process_pb);
+  }
+
+  static std::vector<u8> ReadPBMemory()
+  {
+    std::vector<u8> data(NUM_PBS * PB_STRIDE);
+    std::memcpy(data.data(), Memory::GetPointer(PB_BASE), data.size());
+    return data;
+  }
+
+  static void WritePBMemory(const std::vector<u8>& data)
+  {
+    std::memcpy(Memory::GetPointer(PB_BASE), data.data(), data.size());
+  }
+
+  std::mt19937 m_rng{0};
+  std::array<s16, 0x200> m_polyphase_coefs{};
+};
+}  // namespace
+
+TEST_F(AXVoiceTest, WorkerPoolMatchesSerialProcessing)
+{
+  AXWorkerPool pool(3);
+  WritePBList();
+
+  for (int frame = 0; frame < 20; ++frame)
+  {
+    Buffers serial_buffers;
+    InitBuffers(&serial_buffers);
+    const Buffers initial_buffers = serial_buffers;
+    Buffers parallel_buffers = serial_buffers;
+
+    const std::vector<u8> pbs = ReadPBMemory();
+    ProcessPBList(nullptr, &serial_buffers);
+    const std::vector<u8> serial_pbs = ReadPBMemory();
+    EXPECT_NE(initial_buffers, serial_buffers);
+
+    WritePBMemory(pbs);
+    ProcessPBList(&pool, &parallel_buffers);
+
+    EXPECT_EQ(serial_buffers, parallel_buffers) << "frame " << frame;
+    EXPECT_EQ(serial_pbs, ReadPBMemory()) << "frame " << frame;
+  }
+}
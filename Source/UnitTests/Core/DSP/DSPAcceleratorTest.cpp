@@ -1,7 +1,10 @@
 // Copyright 2017 Dolphin Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
 #include <array>
+#include <random>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -185,3 +188,97 @@ TEST(DSPAccelerator, CurrentAddressSkips)
   accelerator.TestRead();
   EXPECT_EQ(accelerator.GetCurrentAddress(), 0x00000013u);
 }
+
+// Accelerator backed by memory, used to check ADPCM decoding.
+class MemoryTestAccelerator : public DSP::Accelerator
+{
+public:
+  explicit MemoryTestAccelerator(std::vector<u8> memory) : m_memory(std::move(memory)) {}
+
+  std::vector<u8>& Memory() { return m_memory; }
+
+protected:
+  void OnEndException() override { SetYn2(GetYn2()); }
+  u8 ReadMemory(u32 address) override { return m_memory[address % m_memory.size()]; }
+  void WriteMemory(u32 address, u8 value) override { m_memory[address % m_memory.size()] = value; }
+
+  std::vector<u8> m_memory;
+};
+
+// Straightforward ADPCM decoder, one nibble at a time.
+static s16 ReferenceDecode(const std::vector<u8>& memory, u32 address, u16 pred_scale,
+                           const s16* coefs, s16 yn1, s16 yn2)
+{
+  const u8 byte = memory[(address >> 1) % memory.size()];
+  int nibble = (address & 1) ? (byte & 0xF) : (byte >> 4);
+  if (nibble >= 8)
+    nibble -= 16;
+  const int scale = 1 << (pred_scale & 0xF);
+  const int coef_idx = (pred_scale >> 4) & 0x7;
+  const s32 val = scale * nibble + ((0x400 + coefs[coef_idx * 2] * yn1 +
+                                     coefs[coef_idx * 2 + 1] * yn2) >> 11);
+  return static_cast<s16>(std::clamp<s32>(val, -0x7FFF, 0x7FFF));
+}
+
+TEST(DSPAccelerator, DecodeADPCMNibbles)
+{
+  const std::array<u8, 8> frame{0x4b, 0x08, 0xf7, 0x19, 0x80, 0x7f, 0xc3, 0x2e};
+  for (u32 shift = 0; shift < 16; ++shift)
+  {
+    std::array<s32, 16> nibbles;
+    DSP::DecodeADPCMNibbles(frame.data(), shift, nibbles.data());
+    for (u32 i = 0; i < 16; ++i)
+    {
+      int expected = (i & 1) ? (frame[i >> 1] & 0xF) : (frame[i >> 1] >> 4);
+      if (expected >= 8)
+        expected -= 16;
+      EXPECT_EQ(nibbles[i], expected * (1 << shift)) << "shift " << shift << " nibble " << i;
+    }
+  }
+}
+
+TEST(DSPAccelerator, ADPCMMatchesReference)
+{
+  std::mt19937 rng(1234);
+  std::vector<u8> memory(0x400);
+  for (u8& byte : memory)
+    byte = static_cast<u8>(rng());
+  // Frame headers: keep the coefficient index in range and use a mix of scales.
+  for (size_t i = 0; i < memory.size(); i += 8)
+    memory[i] &= 0x7f;
+
+  std::array<s16, 16> coefs;
+  for (s16& coef : coefs)
+    coef = static_cast<s16>(rng());
+
+  MemoryTestAccelerator accelerator(memory);
+  accelerator.SetSampleFormat(0);
+  accelerator.SetStartAddress(0x12);
+  accelerator.SetEndAddress(0x7f3);
+  accelerator.SetCurrentAddress(0x12);
+  accelerator.SetPredScale(memory[8]);
+  accelerator.SetYn1(0);
+  accelerator.SetYn2(0);
+
+  for (int i = 0; i < 10000; ++i)
+  {
+    // Occasionally poke registers from the outside, like a ucode switching voices does.
+    if (i % 997 == 0)
+    {
+      accelerator.SetCurrentAddress(0x12 + rng() % 0x700);
+      accelerator.SetPredScale(static_cast<u16>(rng()));
+    }
+    if (i % 1499 == 0)
+    {
+      // Memory may change between voice updates, and the ucode then reloads the address.
+      accelerator.Memory()[rng() % memory.size()] ^= 0xff;
+      accelerator.SetCurrentAddress(accelerator.GetCurrentAddress());
+    }
+
+    const u32 address = accelerator.GetCurrentAddress();
+    const s16 expected = ReferenceDecode(accelerator.Memory(), address, accelerator.GetPredScale(),
+                                         coefs.data(), accelerator.GetYn1(), accelerator.GetYn2());
+    ASSERT_EQ(static_cast<s16>(accelerator.Read(coefs.data())), expected)
+        << "read " << i << " at " << address;
+  }
+}
@@ -0,0 +1,200 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/MemoryUtil.h"
+#include "Common/MsgHandler.h"
+#include "Core/DSP/DSPAnalyzer.h"
+#include "Core/DSP/DSPCodeUtil.h"
+#include "Core/DSP/DSPCore.h"
+#include "Core/DSP/DSPTables.h"
+#include "Core/DSP/Jit/DSPEmitterBase.h"
+
+#include "../../UserDirectoryTest.h"
+
+// Runs small programs on both the interpreter and the JIT and compares the resulting state.
+// The programs are made of the control flow the JIT links blocks for: block loops, calls,
+// conditional returns and indirect jumps.
+
+namespace
+{
+constexpr u16 OUTPUT_ADDRESS = 0x100;
+constexpr u16 OUTPUT_SIZE = 0x100;
+
+// Sums a sequence into both accumulators through nested loops and subroutine calls.
+const char* const s_loop_program = R"(
+	lri	$ar0, #0x0100
+	clr	$acc0
+	clr	$acc1
+	lri	$ax0.l, #0x1234
+	lri	$ax0.h, #0x0001
+	lri	$ax1.l, #0x0007
+	lri	$ax1.h, #0xfff0
+	bloopi	#100, loop_end
+	call	accumulate
+	addax	$acc1, $ax1
+	tst	$acc1
+	jge	skip
+	neg	$acc1
+skip:
+	lri	$ar3, #indirect
+	jmpr	$ar3
+	halt
+indirect:
+	inc	$acc1
+loop_end:
+	srri	@$ar0, $ac0.m
+	lri	$ix1, #37
+	bloop	$ix1, loop2_end
+	inc	$acc1
+	call	accumulate
+	srri	@$ar0, $ac1.l
+loop2_end:
+	srri	@$ar0, $ac1.m
+	halt
+
+accumulate:
+	addax	$acc0, $ax0
+	tst	$acc0
+	retge
+	neg	$acc0
+	ret
+)";
+
+struct RunResult
+{
+  DSP::DSP_Regs registers;
+  std::vector<u16> output;
+  std::vector<DSP::JIT::BlockProfile> profile;
+};
+
+RunResult RunProgram(const std::vector<u16>& code, DSP::DSPInitOptions::CoreType core_type,
+                     bool profile = false)
+{
+  DSP::DSPInitOptions options;
+  options.irom_contents.fill(0x0021);  // HALT
+  options.coef_contents.fill(0);
+  options.core_type = core_type;
+
+  DSP::DSPCore core;
+  EXPECT_TRUE(core.Initialize(options));
+
+  auto& state = core.DSPState();
+  Common::UnWriteProtectMemory(state.iram, DSP::DSP_IRAM_BYTE_SIZE, false);
+  std::copy(code.begin(), code.end(), state.iram);
+  Common::WriteProtectMemory(state.iram, DSP::DSP_IRAM_BYTE_SIZE, false);
+  core.ClearIRAM();
+  state.GetAnalyzer().Analyze(state);
+
+  state.pc = 0;
+  state.cr &= ~DSP::CR_HALT;
+  core.SetJITProfilingEnabled(profile);
+
+  for (int i = 0; i < 1000 && !(state.cr & DSP::CR_HALT); ++i)
+    core.RunCycles(500);
+  EXPECT_TRUE(state.cr & DSP::CR_HALT);
+
+  RunResult result{state.r,
+                   std::vector<u16>(state.dram + OUTPUT_ADDRESS,
+                                    state.dram + OUTPUT_ADDRESS + OUTPUT_SIZE),
+                   core.GetJITProfileResults()};
+  core.Shutdown();
+  return result;
+}
+
+// pc isn't compared: the JIT and the interpreter don't agree on where halt leaves it.
+void ExpectSameState(const RunResult& interpreter, const RunResult& jit)
+{
+  for (int i = 0; i < 4; ++i)
+  {
+    EXPECT_EQ(jit.registers.ar[i], interpreter.registers.ar[i]) << "ar" << i;
+    EXPECT_EQ(jit.registers.ix[i], interpreter.registers.ix[i]) << "ix" << i;
+    EXPECT_EQ(jit.registers.wr[i], interpreter.registers.wr[i]) << "wr" << i;
+  }
+  for (int i = 0; i < 2; ++i)
+  {
+    EXPECT_EQ(jit.registers.ac[i].val, interpreter.registers.ac[i].val) << "ac" << i;
+    EXPECT_EQ(jit.registers.ax[i].val, interpreter.registers.ax[i].val) << "ax" << i;
+  }
+  EXPECT_EQ(jit.registers.prod.val, interpreter.registers.prod.val);
+  EXPECT_EQ(jit.registers.sr, interpreter.registers.sr);
+  EXPECT_EQ(jit.output, interpreter.output);
+}
+
+class DSPJitTest : public UserDirectoryTest
+{
+protected:
+  void SetUp() override
+  {
+    ASSERT_NO_FATAL_FAILURE(UserDirectoryTest::SetUp());
+    DSP::InitInstructionTable();
+    // The ROMs are not needed. Don't stop because their hashes are unknown.
+    Common::RegisterMsgAlertHandler([](const char*, const char*, bool, Common::MsgType) {
+      return false;
+    });
+  }
+
+  void TearDown() override
+  {
+    Common::RegisterMsgAlertHandler(nullptr);
+    UserDirectoryTest::TearDown();
+  }
+};
+}  // namespace
+
+TEST_F(DSPJitTest, LoopsAndCallsMatchInterpreter)
+{
+  std::vector<u16> code;
+  ASSERT_TRUE(DSP::Assemble(s_loop_program, code));
+
+  const RunResult interpreter = RunProgram(code, DSP::DSPInitOptions::CoreType::Interpreter);
+  const RunResult jit = RunProgram(code, DSP::DSPInitOptions::CoreType::JIT64);
+  ExpectSameState(interpreter, jit);
+
+  // Make sure the program actually did something.
+  EXPECT_NE(interpreter.output[0], 0);
+  EXPECT_NE(interpreter.output[99], 0);
+}
+
+TEST_F(DSPJitTest, ProfileCountsBlockRuns)
+{
+  std::vector<u16> code;
+  ASSERT_TRUE(DSP::Assemble(s_loop_program, code));
+
+  const RunResult interpreter = RunProgram(code, DSP::DSPInitOptions::CoreType::Interpreter, true);
+  EXPECT_TRUE(interpreter.profile.empty());
+
+  const RunResult jit = RunProgram(code, DSP::DSPInitOptions::CoreType::JIT64, true);
+  ExpectSameState(interpreter, jit);
+  ASSERT_FALSE(jit.profile.empty());
+
+  // The block at the entry point runs once, and the subroutine is called 137 times.
+  const auto by_run_count = [](const auto& a, const auto& b) { return a.run_count > b.run_count; };
+  EXPECT_TRUE(std::is_sorted(jit.profile.begin(), jit.profile.end(), by_run_count));
+  const auto entry = std::find_if(jit.profile.begin(), jit.profile.end(),
+                                  [](const auto& block) { return block.address == 0; });
+  ASSERT_NE(entry, jit.profile.end());
+  EXPECT_EQ(entry->run_count, 1u);
+  EXPECT_GT(entry->size, 0);
+  EXPECT_GE(jit.profile.front().run_count, 137u);
+
+  // The loop ends, returns and register jumps link to the next block rather than returning to the
+  // dispatcher, except when the cycles run out.
+  u64 runs = 0;
+  u64 dispatches = 0;
+  for (const auto& block : jit.profile)
+  {
+    EXPECT_LE(block.dispatch_count, block.run_count) << "block " << block.address;
+    runs += block.run_count;
+    dispatches += block.dispatch_count;
+  }
+  EXPECT_LT(dispatches * 4, runs);
+
+  // Without profiling, nothing is counted.
+  EXPECT_TRUE(RunProgram(code, DSP::DSPInitOptions::CoreType::JIT64).profile.empty());
+}
@@ -0,0 +1,117 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <optional>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonPaths.h"
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/MsgHandler.h"
+#include "Core/Config/MainSettings.h"
+#include "Core/ConfigManager.h"
+#include "Core/DSP/DSPCore.h"
+#include "Core/HW/DSPLLE/DSPLLE.h"
+
+#include "../../UserDirectoryTest.h"
+
+// Runs the DSP JIT on its own thread, and checks how far the DSP thread is allowed to fall behind
+// the CPU.
+
+namespace
+{
+constexpr u32 MAX_SKEW_CYCLES = 1000;
+// DSP_Update takes CPU cycles, and the DSP runs one cycle for every six of them.
+constexpr int UPDATE_CPU_CYCLES = 6 * 700;
+
+class DSPLLEThreadTest : public UserDirectoryTest
+{
+protected:
+  void SetUp() override
+  {
+    ASSERT_NO_FATAL_FAILURE(UserDirectoryTest::SetUp());
+    SConfig::GetInstance().m_DSPEnableJIT = true;
+    Config::SetCurrent(Config::MAIN_DSP_THREAD_MAX_SKEW, static_cast<int>(MAX_SKEW_CYCLES));
+
+    // A ROM which loops at the reset vector forever, so that the DSP always has something to run.
+    // The jmp isn't the first instruction: the JIT only charges a block for the instructions before
+    // a branch, so a block which starts with a branch to itself never runs out of cycles.
+    const std::string gc_user_directory = File::GetUserPath(D_GCUSER_IDX);
+    ASSERT_TRUE(File::CreateFullPath(gc_user_directory));
+    std::string rom(DSP::DSP_IROM_BYTE_SIZE, '\0');
+    // 0x8000: nop
+    // 0x8001: jmp 0x8000
+    rom[2] = '\x02';
+    rom[3] = '\x9f';
+    rom[4] = '\x80';
+    ASSERT_TRUE(File::WriteStringToFile(gc_user_directory + DSP_IROM, rom));
+    ASSERT_TRUE(File::WriteStringToFile(gc_user_directory + DSP_COEF,
+                                        std::string(DSP::DSP_COEF_BYTE_SIZE, '\0')));
+
+    // Don't stop because the hashes of the ROMs are unknown.
+    Common::RegisterMsgAlertHandler([](const char*, const char*, bool, Common::MsgType) {
+      return false;
+    });
+    m_dsp.emplace();
+    ASSERT_TRUE(m_dsp->Initialize(false, true));
+    // Leave the halt state which the DSP starts in.
+    m_dsp->DSP_WriteControlRegister(0);
+  }
+
+  void TearDown() override
+  {
+    if (m_dsp)
+      m_dsp->Shutdown();
+    m_dsp.reset();
+    Common::RegisterMsgAlertHandler(nullptr);
+    UserDirectoryTest::TearDown();
+  }
+
+  std::optional<DSP::LLE::DSPLLE> m_dsp;
+};
+}  // namespace
+
+TEST_F(DSPLLEThreadTest, UpdateBoundsPendingCycles)
+{
+  for (int i = 0; i < 1000; ++i)
+  {
+    m_dsp->DSP_Update(UPDATE_CPU_CYCLES);
+    ASSERT_LE(m_dsp->GetPendingCycles(), MAX_SKEW_CYCLES) << "update " << i;
+  }
+}
+
+TEST_F(DSPLLEThreadTest, MailboxReadWaitsForDSPThread)
+{
+  const u64 initial_stalls = m_dsp->GetThreadStats().stall_count;
+  for (int i = 0; i < 100; ++i)
+  {
+    // Let the DSP thread catch up completely, then queue cycles while it can't run them. This is
+    // within the skew limit, so the update itself doesn't wait.
+    m_dsp->DSP_WriteControlRegister(0);
+    m_dsp->PauseAndLock(true);
+    m_dsp->DSP_Update(UPDATE_CPU_CYCLES);
+    m_dsp->PauseAndLock(false);
+    ASSERT_LE(m_dsp->GetPendingCycles(), MAX_SKEW_CYCLES) << "update " << i;
+
+    m_dsp->DSP_ReadMailBoxHigh(true);
+    ASSERT_LE(m_dsp->GetPendingCycles(), MAX_SKEW_CYCLES / 2) << "update " << i;
+    m_dsp->DSP_ReadMailBoxLow(false);
+    ASSERT_LE(m_dsp->GetPendingCycles(), MAX_SKEW_CYCLES / 2) << "update " << i;
+  }
+
+  // The DSP thread only starts running the queued cycles once it is unlocked, so at least some of
+  // the reads must have found it too far behind.
+  EXPECT_GT(m_dsp->GetThreadStats().stall_count, initial_stalls);
+}
+
+TEST_F(DSPLLEThreadTest, ControlRegisterWriteWaitsForDSPThread)
+{
+  for (int i = 0; i < 100; ++i)
+  {
+    m_dsp->DSP_Update(UPDATE_CPU_CYCLES);
+    m_dsp->DSP_WriteControlRegister(0);
+    ASSERT_EQ(m_dsp->GetPendingCycles(), 0u) << "update " << i;
+  }
+}
@@ -0,0 +1,255 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Core/HW/DSPHLE/UCodes/Zelda.h"
+
+using DSP::HLE::ZeldaAudioRenderer;
+
+// Compares the mixing functions of the Zelda renderer against straightforward per sample versions
+// of them, over generated voice streams. The streams mix typical audio with the extreme values
+// which are most likely to expose overflow or rounding differences.
+
+namespace
+{
+constexpr size_t FRAME_SIZE = 0x50;
+constexpr int FRAME_COUNT = 200;
+
+class SampleStream
+{
+public:
+  explicit SampleStream(u32 seed) : m_rng(seed) {}
+
+  s16 Sample()
+  {
+    switch (m_rng() % 8)
+    {
+    case 0:
+      return -0x8000;
+    case 1:
+      return 0x7FFF;
+    default:
+      m_phase += 0.07 + (m_rng() % 100) * 0.001;
+      return static_cast<s16>(std::clamp(20000.0 * std::sin(m_phase) + Noise(2000), -32768.0,
+                                         32767.0));
+    }
+  }
+
+  std::vector<s16> Samples(size_t count)
+  {
+    std::vector<s16> samples(count);
+    for (s16& sample : samples)
+      sample = Sample();
+    return samples;
+  }
+
+  u16 Volume()
+  {
+    constexpr std::array<u16, 6> special = {0x0000, 0x7FFF, 0x8000, 0xB820, 0xFFFF, 0x6784};
+    if (m_rng() % 4 == 0)
+      return special[m_rng() % special.size()];
+    return static_cast<u16>(m_rng());
+  }
+
+  u32 Next() { return m_rng(); }
+
+private:
+  double Noise(int amplitude) { return static_cast<int>(m_rng() % (2 * amplitude)) - amplitude; }
+
+  std::mt19937 m_rng;
+  double m_phase = 0.0;
+};
+
+void ReferenceApplyVolume(s16* buf, size_t count, u16 vol, u32 int_bits)
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    s32 tmp = (u32)buf[i] * (u32)vol;
+    tmp >>= 16 - int_bits;
+    buf[i] = (s16)std::clamp(tmp, -0x8000, 0x7FFF);
+  }
+}
+
+void ReferenceAddWithVolume(s16* dst, const s16* src, size_t count, u16 vol)
+{
+  while (count--)
+  {
+    s32 vol_src = ((s32)*src++ * (s32)vol) >> 15;
+    *dst++ += std::clamp(vol_src, -0x8000, 0x7FFF);
+  }
+}
+
+s32 ReferenceAddWithVolumeRamp(s16* dst, const s16* src, size_t count, s32 vol, s32 step)
+{
+  if (!vol && !step)
+    return vol;
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    dst[i] += ((vol >> 16) * src[i]) >> 16;
+    vol = static_cast<s32>(static_cast<u32>(vol) + static_cast<u32>(step));
+  }
+  return vol;
+}
+
+void ReferenceReverbFilter(s16* buffer, size_t count, const s16* coeffs)
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    u32 sample = 0;
+    for (size_t j = 0; j < 8; ++j)
+      sample += static_cast<u32>(buffer[i + j] * coeffs[j]);
+    buffer[i] = std::clamp(static_cast<s32>(sample) >> 15, -0x8000, 0x7FFF);
+  }
+}
+
+u32 ReferenceResample(s16* dst, size_t count, const s16* src, u32 pos, u32 ratio,
+                      const s16* coeffs_table)
+{
+  for (size_t n = 0; n < count; ++n)
+  {
+    const s16* coeffs = &coeffs_table[((pos & 0xFFF) >> 6) * 4];
+    const s16* input = &src[pos >> 12];
+
+    s64 sample = 0;
+    for (size_t i = 0; i < 4; ++i)
+      sample += (s64)2 * coeffs[i] * input[i];
+    sample >>= 16;
+    dst[n] = (s16)std::clamp<s64>(sample, -0x8000, 0x7FFF);
+
+    pos += ratio;
+  }
+  return pos;
+}
+}  // namespace
+
+TEST(ZeldaRenderer, ApplyVolume)
+{
+  SampleStream stream(1);
+  for (int frame = 0; frame < FRAME_COUNT; ++frame)
+  {
+    for (u32 int_bits : {1u, 4u})
+    {
+      // Odd sizes also check the scalar tail.
+      const size_t count = frame % 2 ? FRAME_SIZE : FRAME_SIZE - 3;
+      const u16 volume = stream.Volume();
+      std::vector<s16> expected = stream.Samples(count);
+      std::vector<s16> actual = expected;
+      ReferenceApplyVolume(expected.data(), count, volume, int_bits);
+      ZeldaAudioRenderer::ApplyVolumeInPlace(actual.data(), count, volume, int_bits);
+      ASSERT_EQ(actual, expected) << "frame " << frame << " volume " << volume;
+    }
+  }
+}
+
+TEST(ZeldaRenderer, AddBuffersWithVolume)
+{
+  SampleStream stream(2);
+  std::vector<s16> expected(FRAME_SIZE);
+  std::vector<s16> actual(FRAME_SIZE);
+  for (int frame = 0; frame < FRAME_COUNT; ++frame)
+  {
+    // The renderer also mixes half buffers.
+    const size_t count = frame % 3 ? FRAME_SIZE : FRAME_SIZE / 2;
+    const u16 volume = stream.Volume();
+    const std::vector<s16> src = stream.Samples(count);
+    ReferenceAddWithVolume(expected.data(), src.data(), count, volume);
+    ZeldaAudioRenderer::AddBuffersWithVolume(actual.data(), src.data(), count, volume);
+    ASSERT_EQ(actual, expected) << "frame " << frame << " volume " << volume;
+  }
+}
+
+TEST(ZeldaRenderer, AddBuffersWithVolumeRamp)
+{
+  SampleStream stream(3);
+  std::vector<s16> expected(FRAME_SIZE);
+  std::vector<s16> actual(FRAME_SIZE);
+  s32 volume = 0;
+  for (int frame = 0; frame < FRAME_COUNT; ++frame)
+  {
+    // Ramp from the current volume to a new target, like voices do.
+    const s16 target = static_cast<s16>(stream.Volume());
+    const s32 step = ((target - (volume >> 16)) << 16) / static_cast<s32>(FRAME_SIZE);
+    const std::vector<s16> src = stream.Samples(FRAME_SIZE);
+    const s32 expected_volume =
+        ReferenceAddWithVolumeRamp(expected.data(), src.data(), FRAME_SIZE, volume, step);
+    const s32 actual_volume =
+        ZeldaAudioRenderer::AddBuffersWithVolumeRamp(actual.data(), src.data(), FRAME_SIZE, volume,
+                                                     step);
+    ASSERT_EQ(actual, expected) << "frame " << frame;
+    ASSERT_EQ(actual_volume, expected_volume) << "frame " << frame;
+    volume = expected_volume;
+  }
+}
+
+TEST(ZeldaRenderer, ReverbFilter)
+{
+  SampleStream stream(4);
+  std::array<s16, 8> last8{};
+  for (int frame = 0; frame < FRAME_COUNT; ++frame)
+  {
+    std::array<s16, 8> coeffs;
+    for (s16& coeff : coeffs)
+      coeff = static_cast<s16>(stream.Volume());
+
+    // Like the renderer, prepend the last 8 samples of the previous frame.
+    std::vector<s16> expected(last8.begin(), last8.end());
+    const std::vector<s16> samples = stream.Samples(FRAME_SIZE);
+    expected.insert(expected.end(), samples.begin(), samples.end());
+    std::copy(samples.end() - 8, samples.end(), last8.begin());
+
+    std::vector<s16> actual = expected;
+    ReferenceReverbFilter(expected.data(), FRAME_SIZE, coeffs.data());
+    ZeldaAudioRenderer::ApplyReverbFilter(actual.data(), FRAME_SIZE, coeffs.data());
+    ASSERT_EQ(actual, expected) << "frame " << frame;
+  }
+}
+
+TEST(ZeldaRenderer, Resample)
+{
+  SampleStream stream(5);
+  std::array<s16, 0x100> coeffs;
+  for (s16& coeff : coeffs)
+    coeff = static_cast<s16>(stream.Volume());
+
+  for (int frame = 0; frame < FRAME_COUNT; ++frame)
+  {
+    // Interpolation is only used for ratios below 4.0 (4.12 fixed point).
+    const u32 ratio = stream.Next() % 0x4000;
+    const u32 pos = stream.Next() & 0xFFF;
+    const std::vector<s16> src = stream.Samples(((pos + FRAME_SIZE * ratio) >> 12) + 4);
+
+    std::vector<s16> expected(FRAME_SIZE);
+    std::vector<s16> actual(FRAME_SIZE);
+    const u32 expected_pos =
+        ReferenceResample(expected.data(), FRAME_SIZE, src.data(), pos, ratio, coeffs.data());
+    const u32 actual_pos = ZeldaAudioRenderer::ResampleInterpolated(
+        actual.data(), FRAME_SIZE, src.data(), pos, ratio, coeffs.data());
+    ASSERT_EQ(actual, expected) << "frame " << frame << " ratio " << ratio;
+    ASSERT_EQ(actual_pos, expected_pos);
+  }
+}
+
+TEST(ZeldaRenderer, ResampleExtremes)
+{
+  // Every product at its maximum, which overflows 32-bit intermediate sums.
+  std::array<s16, 0x100> coeffs;
+  coeffs.fill(-0x8000);
+  std::vector<s16> src(0x200, -0x8000);
+
+  std::vector<s16> expected(FRAME_SIZE);
+  std::vector<s16> actual(FRAME_SIZE);
+  ReferenceResample(expected.data(), FRAME_SIZE, src.data(), 0, 0x1000, coeffs.data());
+  ZeldaAudioRenderer::ResampleInterpolated(actual.data(), FRAME_SIZE, src.data(), 0, 0x1000,
+                                           coeffs.data());
+  EXPECT_EQ(actual, expected);
+  EXPECT_EQ(actual[0], 0x7FFF);
+}
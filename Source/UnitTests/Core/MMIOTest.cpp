@@ -41,6 +41,8 @@ TEST(IsMMIOAddress, SpecialAddresses)
 
   // WG Pipe address, should not be handled by MMIO.
   EXPECT_FALSE(MMIO::IsMMIOAddress(0x0C008000));
+  EXPECT_FALSE(MMIO::IsMMIOAddress(0x0C008004));
+  EXPECT_FALSE(MMIO::IsMMIOAddress(0x0C008FFC));
 
   // Locked L1 cache allocation.
   EXPECT_FALSE(MMIO::IsMMIOAddress(0xE0000000));
@@ -138,3 +140,33 @@ TEST_F(MappingTest, ReadWriteComplex)
   EXPECT_TRUE(read_called);
   EXPECT_TRUE(write_called);
 }
+
+TEST_F(MappingTest, AccessCounting)
+{
+  u32 target = 0;
+  m_mapping->Register(0x0C001234, MMIO::DirectRead<u32>(&target), MMIO::DirectWrite<u32>(&target));
+  m_mapping->Register(0x0D006000, MMIO::DirectRead<u32>(&target), MMIO::DirectWrite<u32>(&target));
+
+  EXPECT_EQ(nullptr, m_mapping->GetReadCounter(0x0C001234));
+  m_mapping->Read<u32>(0x0C001234);
+  EXPECT_TRUE(m_mapping->GetAccessCounts().empty());
+
+  m_mapping->SetAccessCountingEnabled(true);
+  for (u32 i = 0; i < 3; ++i)
+    m_mapping->Read<u32>(0x0C001234);
+  m_mapping->Write<u32>(0x0C001234, 1);
+  m_mapping->Write<u32>(0x0D806000, 2);
+  ++*m_mapping->GetWriteCounter(0x0D006000);
+
+  const auto counts = m_mapping->GetAccessCounts();
+  ASSERT_EQ(2u, counts.size());
+  EXPECT_EQ(0x0C001234u, counts[0].address);
+  EXPECT_EQ(3u, counts[0].reads);
+  EXPECT_EQ(1u, counts[0].writes);
+  EXPECT_EQ(0x0D006000u, counts[1].address);
+  EXPECT_EQ(0u, counts[1].reads);
+  EXPECT_EQ(2u, counts[1].writes);
+
+  m_mapping->SetAccessCountingEnabled(false);
+  EXPECT_EQ(nullptr, m_mapping->GetWriteCounter(0x0C001234));
+}
@@ -0,0 +1,145 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <cstring>
+
+#include "Common/CommonTypes.h"
+#include "Core/ConfigManager.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/CachedInterpreter/CachedInterpreter.h"
+#include "Core/PowerPC/Interpreter/Interpreter.h"
+#include "Core/PowerPC/PowerPC.h"
+
+#include <gtest/gtest.h>
+
+#include "../../UserDirectoryTest.h"
+
+// Runs the same code through the Interpreter and the CachedInterpreter, whose handlers for common
+// instructions get their operands decoded when the block is compiled, and compares the results.
+
+namespace
+{
+constexpr u32 CODE_ADDRESS = 0x00003000;
+constexpr u32 DATA_ADDRESS = 0x00100000;
+constexpr u32 DATA_SIZE = 0x40;
+
+// Instructions the CachedInterpreter pre-decodes, some it leaves to the Interpreter, and branches.
+constexpr std::array<u32, 23> CODE = {
+    0x3c600010,  // lis r3, 0x0010
+    0x38830020,  // addi r4, r3, 0x20
+    0x38a01234,  // li r5, 0x1234
+    0x3a05fff0,  // addi r16, r5, -0x10
+    0x60a6ff00,  // ori r6, r5, 0xff00
+    0x64c7abcd,  // oris r7, r6, 0xabcd
+    0x68e85555,  // xori r8, r7, 0x5555
+    0x6d098000,  // xoris r9, r8, 0x8000
+    0x552a4136,  // rlwinm r10, r9, 8, 4, 27
+    0x7d4b5378,  // mr r11, r10
+    0x91240000,  // stw r9, 0(r4)
+    0xb1440006,  // sth r10, 6(r4)
+    0x99640009,  // stb r11, 9(r4)
+    0x81840000,  // lwz r12, 0(r4)
+    0xa1a40006,  // lhz r13, 6(r4)
+    0x89c40009,  // lbz r14, 9(r4)
+    0x81e4fff8,  // lwz r15, -8(r4)
+    0x7e2c6a14,  // add r17, r12, r13
+    0x552a4137,  // rlwinm. r10, r9, 8, 4, 27
+    0x48000008,  // b +8
+    0x3a400001,  // li r18, 1
+    0x3a600002,  // li r19, 2
+    0x48000000,  // b .
+};
+constexpr u32 END_ADDRESS = CODE_ADDRESS + (CODE.size() - 1) * 4;
+
+struct State
+{
+  std::array<u32, 32> gprs;
+  u32 cr;
+  std::array<u8, DATA_SIZE> data;
+};
+
+class CachedInterpreterTest : public UserDirectoryTest
+{
+protected:
+  void SetUp() override
+  {
+    ASSERT_NO_FATAL_FAILURE(UserDirectoryTest::SetUp());
+    SConfig::GetInstance().bWii = false;
+    SConfig::GetInstance().bMMU = false;
+    CoreTiming::Init();
+    Memory::Init();
+    Interpreter::getInstance()->Init();
+
+    // Run with address translation off, so that effective addresses are physical addresses.
+    PowerPC::ppcState.msr.Hex = 0;
+    PowerPC::IBATUpdated();
+    PowerPC::DBATUpdated();
+
+    u32 address = CODE_ADDRESS;
+    for (const u32 instruction : CODE)
+    {
+      Memory::Write_U32(instruction, address);
+      address += 4;
+    }
+  }
+
+  void TearDown() override
+  {
+    Memory::Shutdown();
+    CoreTiming::Shutdown();
+    UserDirectoryTest::TearDown();
+  }
+
+  static void ResetState()
+  {
+    for (u32 i = 0; i < 32; ++i)
+      rGPR[i] = 0x01010101 * i;
+    PowerPC::ppcState.cr.Set(0);
+    for (u32 i = 0; i < DATA_SIZE; ++i)
+      Memory::Write_U8(static_cast<u8>(i * 7), DATA_ADDRESS + i);
+    PC = CODE_ADDRESS;
+    NPC = CODE_ADDRESS + 4;
+  }
+
+  static State GetState()
+  {
+    State state;
+    std::memcpy(state.gprs.data(), rGPR, sizeof(state.gprs));
+    state.cr = PowerPC::ppcState.cr.Get();
+    Memory::CopyFromEmu(state.data.data(), DATA_ADDRESS, DATA_SIZE);
+    return state;
+  }
+};
+}  // namespace
+
+TEST_F(CachedInterpreterTest, MatchesInterpreter)
+{
+  ResetState();
+  for (u32 i = 0; i < CODE.size() && PC != END_ADDRESS; ++i)
+    Interpreter::getInstance()->SingleStep();
+  ASSERT_EQ(END_ADDRESS, PC);
+  const State expected = GetState();
+
+  ResetState();
+  CachedInterpreter cached_interpreter;
+  cached_interpreter.Init();
+  // The first step only compiles the block.
+  for (u32 i = 0; i < CODE.size() && PC != END_ADDRESS; ++i)
+    cached_interpreter.SingleStep();
+  ASSERT_EQ(END_ADDRESS, PC);
+  const State actual = GetState();
+  cached_interpreter.Shutdown();
+
+  for (u32 i = 0; i < 32; ++i)
+    EXPECT_EQ(expected.gprs[i], actual.gprs[i]) << "r" << i;
+  EXPECT_EQ(expected.cr, actual.cr);
+  EXPECT_EQ(expected.data, actual.data);
+
+  // Make sure the code did what it is meant to exercise.
+  EXPECT_EQ(0x00100020u, actual.gprs[4]);
+  EXPECT_EQ(actual.gprs[9], actual.gprs[12]);
+  EXPECT_EQ(0x01010101u * 18, actual.gprs[18]);
+  EXPECT_EQ(2u, actual.gprs[19]);
+}
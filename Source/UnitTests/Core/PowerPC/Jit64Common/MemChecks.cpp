@@ -0,0 +1,111 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Common/CommonTypes.h"
+#include "Core/ConfigManager.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/BreakPoints.h"
+#include "Core/PowerPC/Interpreter/Interpreter.h"
+#include "Core/PowerPC/Jit64/Jit.h"
+#include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/MMU.h"
+#include "Core/PowerPC/PowerPC.h"
+
+#include <gtest/gtest.h>
+
+#include "../../../UserDirectoryTest.h"
+
+// Checks that adding a memcheck drops blocks which were compiled before it, since their accesses to
+// constant addresses in the newly watched memory can't be backpatched when they fault.
+
+namespace
+{
+constexpr u32 BLOCK_ADDRESS = 0x80003000;
+constexpr u32 WATCHED_ADDRESS = 0x80400000;
+constexpr u32 OTHER_WATCHED_ADDRESS = 0x81000000;
+
+class Jit64MemChecksTest : public UserDirectoryTest
+{
+protected:
+  void SetUp() override
+  {
+    ASSERT_NO_FATAL_FAILURE(UserDirectoryTest::SetUp());
+    SConfig::GetInstance().bWii = false;
+    SConfig::GetInstance().bMMU = false;
+    SConfig::GetInstance().bFastmem = true;
+    Memory::Init();
+    Interpreter::getInstance()->Init();
+
+    // The BATs the IPL sets up: the first 256 MiB of effective memory at 0x80000000 map to RAM.
+    for (const int bat : {SPR_IBAT0U, SPR_DBAT0U})
+    {
+      PowerPC::ppcState.spr[bat] = 0x80001fff;
+      PowerPC::ppcState.spr[bat + 1] = 0x00000002;
+    }
+    PowerPC::ppcState.msr.IR = 1;
+    PowerPC::ppcState.msr.DR = 1;
+    PowerPC::IBATUpdated();
+    PowerPC::DBATUpdated();
+
+    // lis r3, 0x8040
+    // lwz r4, 0(r3)
+    // b .
+    Memory::Write_U32(0x3c608040, BLOCK_ADDRESS);
+    Memory::Write_U32(0x80830000, BLOCK_ADDRESS + 4);
+    Memory::Write_U32(0x48000000, BLOCK_ADDRESS + 8);
+
+    m_jit.Init();
+    JitInterface::SetJit(&m_jit);
+  }
+
+  void TearDown() override
+  {
+    PowerPC::memchecks.Clear();
+    JitInterface::SetJit(nullptr);
+    m_jit.Shutdown();
+    Memory::Shutdown();
+    PowerPC::ppcState.msr.IR = 0;
+    PowerPC::ppcState.msr.DR = 0;
+    UserDirectoryTest::TearDown();
+  }
+
+  static void AddMemCheck(u32 address)
+  {
+    TMemCheck memory_check;
+    memory_check.start_address = address;
+    memory_check.end_address = address + 3;
+    memory_check.is_break_on_read = true;
+    memory_check.is_break_on_write = true;
+    PowerPC::memchecks.Add(memory_check);
+  }
+
+  JitBlock* GetBlock()
+  {
+    return m_jit.GetBlockCache()->GetBlockFromStartAddress(BLOCK_ADDRESS, MSR.Hex);
+  }
+
+  Jit64 m_jit;
+};
+}  // namespace
+
+TEST_F(Jit64MemChecksTest, SecondMemCheckDropsCompiledBlocks)
+{
+  // The first memcheck switches the JIT to watchpoint-compatible code, but doesn't cover the
+  // address the block loads from, so the load is compiled as a direct access.
+  AddMemCheck(OTHER_WATCHED_ADDRESS);
+  ASSERT_TRUE(PowerPC::IsOptimizableRAMAddress(WATCHED_ADDRESS));
+  m_jit.Jit(BLOCK_ADDRESS);
+  ASSERT_NE(nullptr, GetBlock());
+
+  AddMemCheck(WATCHED_ADDRESS);
+  EXPECT_FALSE(PowerPC::IsOptimizableRAMAddress(WATCHED_ADDRESS));
+  EXPECT_EQ(nullptr, GetBlock());
+
+  // Recompiling the block against the new memcheck works.
+  m_jit.Jit(BLOCK_ADDRESS);
+  EXPECT_NE(nullptr, GetBlock());
+
+  PowerPC::memchecks.Remove(WATCHED_ADDRESS);
+  EXPECT_TRUE(PowerPC::IsOptimizableRAMAddress(WATCHED_ADDRESS));
+  EXPECT_EQ(nullptr, GetBlock());
+}
@@ -0,0 +1,84 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+
+#include "Common/CommonTypes.h"
+#include "Common/x64ABI.h"
+#include "Core/PowerPC/Jit64/Jit.h"
+#include "Core/PowerPC/Jit64Common/Jit64AsmCommon.h"
+#include "Core/PowerPC/Jit64Common/Jit64Constants.h"
+#include "Core/PowerPC/MMU.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+using LookupFunction = u8* (*)(u32);
+
+class TestCommonAsmRoutines : public CommonAsmRoutines
+{
+public:
+  TestCommonAsmRoutines() : CommonAsmRoutines(jit)
+  {
+    AllocCodeSpace(4096);
+
+    read8 = GenerateLookup(8, false);
+    read32 = GenerateLookup(32, false);
+    write32 = GenerateLookup(32, true);
+  }
+
+  LookupFunction read8;
+  LookupFunction read32;
+  LookupFunction write32;
+  Jit64 jit;
+
+private:
+  // Returns the host address on a hit and nullptr on a miss.
+  LookupFunction GenerateLookup(int access_size, bool write)
+  {
+    using namespace Gen;
+
+    const auto function = reinterpret_cast<LookupFunction>(AlignCode4());
+    MOV(32, R(RSCRATCH2), R(ABI_PARAM1));
+    FixupBranch miss = SoftTLBLookup(RSCRATCH2, RSCRATCH, RSCRATCH_EXTRA, access_size, write);
+    LEA(64, RSCRATCH, MRegSum(RSCRATCH, RSCRATCH2));
+    RET();
+    SetJumpTarget(miss);
+    XOR(32, R(RSCRATCH), R(RSCRATCH));
+    RET();
+    return function;
+  }
+};
+}  // namespace
+
+TEST(Jit64, SoftTLBLookup)
+{
+  TestCommonAsmRoutines routines;
+
+  std::array<u8, PowerPC::HW_PAGE_SIZE> page{};
+  const u32 em_page = 0x80123000;
+  PowerPC::SoftTLBEntry& entry =
+      PowerPC::soft_tlb[(em_page >> PowerPC::SOFT_TLB_INDEX_SHIFT) & (PowerPC::SOFT_TLB_SIZE - 1)];
+  entry.read_tag = em_page;
+  entry.write_tag = PowerPC::SOFT_TLB_INVALID_TAG;
+  entry.host_base = reinterpret_cast<u8*>(reinterpret_cast<uintptr_t>(page.data()) - em_page);
+
+  EXPECT_EQ(page.data(), routines.read32(em_page));
+  EXPECT_EQ(page.data() + 0xffc, routines.read32(em_page + 0xffc));
+  EXPECT_EQ(page.data() + 0xfff, routines.read8(em_page + 0xfff));
+
+  // Misaligned accesses and accesses to other pages with the same index miss.
+  EXPECT_EQ(nullptr, routines.read32(em_page + 0xffe));
+  EXPECT_EQ(nullptr, routines.read32(em_page + 2));
+  EXPECT_EQ(nullptr, routines.read32(em_page ^ 0x10000000));
+  EXPECT_EQ(nullptr, routines.read32(em_page + PowerPC::HW_PAGE_SIZE));
+
+  // Reads and writes are tracked separately.
+  EXPECT_EQ(nullptr, routines.write32(em_page));
+  entry.write_tag = em_page;
+  EXPECT_EQ(page.data() + 0x10, routines.write32(em_page + 0x10));
+
+  entry.read_tag = PowerPC::SOFT_TLB_INVALID_TAG;
+  entry.write_tag = PowerPC::SOFT_TLB_INVALID_TAG;
+}
@@ -0,0 +1,93 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Core/ConfigManager.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/Interpreter/Interpreter.h"
+#include "Core/PowerPC/PPCAnalyst.h"
+#include "Core/PowerPC/PowerPC.h"
+
+#include "../../UserDirectoryTest.h"
+
+// Checks which CR fields the analyzer considers live between the instructions of a block.
+
+namespace
+{
+constexpr u32 BLOCK_ADDRESS = 0x00003000;
+
+// cmpwi cr0, r3, 0
+constexpr u32 CMPWI_R3 = 0x2c030000;
+// cmpwi cr0, r6, 0
+constexpr u32 CMPWI_R6 = 0x2c060000;
+// addi r4, r5, 0
+constexpr u32 ADDI = 0x38850000;
+// lwz r4, 0(r5)
+constexpr u32 LWZ = 0x80850000;
+// blr
+constexpr u32 BLR = 0x4e800020;
+
+class PPCAnalystTest : public UserDirectoryTest
+{
+protected:
+  void SetUp() override
+  {
+    ASSERT_NO_FATAL_FAILURE(UserDirectoryTest::SetUp());
+    SConfig::GetInstance().bWii = false;
+    Memory::Init();
+    Interpreter::getInstance()->Init();
+    // Read the block from physical memory.
+    PowerPC::ppcState.msr.IR = 0;
+
+    m_block.m_stats = &m_stats;
+    m_block.m_gpa = &m_gpa;
+    m_block.m_fpa = &m_fpa;
+    m_buffer.resize(16);
+  }
+
+  void TearDown() override
+  {
+    Memory::Shutdown();
+    UserDirectoryTest::TearDown();
+  }
+
+  void Analyze(std::initializer_list<u32> instructions)
+  {
+    u32 address = BLOCK_ADDRESS;
+    for (const u32 instruction : instructions)
+    {
+      Memory::Write_U32(instruction, address);
+      address += 4;
+    }
+    m_analyzer.Analyze(BLOCK_ADDRESS, &m_block, &m_buffer, m_buffer.size());
+    ASSERT_EQ(instructions.size(), m_block.m_num_instructions);
+  }
+
+  PPCAnalyst::PPCAnalyzer m_analyzer;
+  PPCAnalyst::CodeBlock m_block;
+  PPCAnalyst::BlockStats m_stats;
+  PPCAnalyst::BlockRegStats m_gpa;
+  PPCAnalyst::BlockRegStats m_fpa;
+  PPCAnalyst::CodeBuffer m_buffer;
+};
+}  // namespace
+
+TEST_F(PPCAnalystTest, OverwrittenCRFieldIsDead)
+{
+  ASSERT_NO_FATAL_FAILURE(Analyze({CMPWI_R3, ADDI, CMPWI_R6, BLR}));
+
+  EXPECT_FALSE(m_buffer[0].crInUse[0]);
+  EXPECT_TRUE(m_buffer[2].crInUse[0]);
+}
+
+TEST_F(PPCAnalystTest, CRFieldIsLiveAcrossFaultingLoad)
+{
+  // The DSI handler sees CR0 as set by the first compare, so the compare must not be skipped.
+  ASSERT_NO_FATAL_FAILURE(Analyze({CMPWI_R3, LWZ, CMPWI_R6, BLR}));
+
+  EXPECT_TRUE(m_buffer[0].crInUse[0]);
+  EXPECT_TRUE(m_buffer[0].crInUse[7]);
+  EXPECT_TRUE(m_buffer[2].crInUse[0]);
+}
@@ -0,0 +1,228 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <optional>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Core/ConfigManager.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/MMU.h"
+#include "Core/PowerPC/PowerPC.h"
+
+#include "../../UserDirectoryTest.h"
+
+// Checks which pages translated through the page table get mapped into the logical fastmem region,
+// and that changing the segment registers or invalidating TLB entries unmaps them again.
+
+namespace
+{
+constexpr u32 PAGE_TABLE_BASE = 0x00100000;
+constexpr u32 PAGE_SIZE = PowerPC::HW_PAGE_SIZE;
+
+class PageTableMappingTest : public UserDirectoryTest
+{
+protected:
+  void SetUp() override
+  {
+    ASSERT_NO_FATAL_FAILURE(UserDirectoryTest::SetUp());
+    SConfig::GetInstance().bWii = false;
+    SConfig::GetInstance().bMMU = true;
+    Memory::Init();
+    ASSERT_TRUE(Memory::InitFastmemArena());
+
+    for (auto& tlb : PowerPC::ppcState.tlb)
+      tlb.fill({});
+    PowerPC::ppcState.msr.DR = 1;
+    PowerPC::DBATUpdated();
+
+    // The smallest page table, 64 KiB.
+    PowerPC::ppcState.spr[SPR_SDR] = PAGE_TABLE_BASE;
+    PowerPC::SDRUpdated();
+  }
+
+  void TearDown() override
+  {
+    Memory::Shutdown();
+    PowerPC::ppcState.msr.DR = 0;
+    UserDirectoryTest::TearDown();
+  }
+
+  // Adds a PTE to the primary PTEG, or replaces the one that is there already for the page.
+  static void SetPTE(u32 effective_address, u32 vsid, u32 physical_address, bool referenced = true,
+                     bool changed = true)
+  {
+    const u32 page_index = (effective_address >> 12) & 0xffff;
+    const u32 pteg_address = (((vsid ^ page_index) & 0x3ff) << 6) | PAGE_TABLE_BASE;
+    const u32 pte1 = 0x80000000 | (vsid << 7) | ((effective_address >> 22) & 0x3f);
+    for (u32 pte_address = pteg_address; pte_address < pteg_address + 64; pte_address += 8)
+    {
+      const u32 existing_pte1 = Memory::Read_U32(pte_address);
+      if ((existing_pte1 & 0x80000000) && existing_pte1 != pte1)
+        continue;
+
+      Memory::Write_U32(pte1, pte_address);
+      // PP = 2, read/write access.
+      Memory::Write_U32(physical_address | (referenced << 8) | (changed << 7) | 2,
+                        pte_address + 4);
+      return;
+    }
+    ADD_FAILURE() << "PTEG is full";
+  }
+
+  static std::optional<u32> GetMapping(u32 effective_address)
+  {
+    return Memory::GetPageTableMapping(effective_address);
+  }
+};
+}  // namespace
+
+TEST_F(PageTableMappingTest, MapsPagesOnAccess)
+{
+  if (!Memory::CanMapPageTableEntries())
+    return;
+
+  PowerPC::ppcState.SetSR(4, 0x123);
+  SetPTE(0x40001000, 0x123, 0x00200000);
+  SetPTE(0x40002000, 0x123, 0x00300000, true, false);
+
+  EXPECT_EQ(GetMapping(0x40001000), std::nullopt);
+  PowerPC::Read_U32(0x40001000);
+  EXPECT_EQ(GetMapping(0x40001000), 0x00200000u);
+  EXPECT_EQ(GetMapping(0x40001ffc), 0x00200ffcu);
+
+  // The view maps the same memory as the physical address.
+  Memory::logical_base[0x40001010] = 0x5a;
+  EXPECT_EQ(Memory::m_pRAM[0x00200010], 0x5a);
+
+  // Fastmem can't set the changed bit, so the page is only mapped after the slow path did it.
+  PowerPC::Read_U32(0x40002000);
+  EXPECT_EQ(GetMapping(0x40002000), std::nullopt);
+  PowerPC::Write_U32(0, 0x40002000);
+  EXPECT_EQ(GetMapping(0x40002000), 0x00300000u);
+}
+
+TEST_F(PageTableMappingTest, MapsPagesOnFault)
+{
+  if (!Memory::CanMapPageTableEntries())
+    return;
+
+  PowerPC::ppcState.SetSR(4, 0x123);
+  SetPTE(0x40001000, 0x123, 0x00200000);
+  SetPTE(0x40002000, 0x123, 0x00300000, false, false);
+
+  EXPECT_TRUE(PowerPC::MapPageTableEntryOnFault(0x40001234));
+  EXPECT_EQ(GetMapping(0x40001000), 0x00200000u);
+
+  // Another fault on a page that is mapped already must not be retried forever.
+  EXPECT_FALSE(PowerPC::MapPageTableEntryOnFault(0x40001234));
+
+  EXPECT_FALSE(PowerPC::MapPageTableEntryOnFault(0x40002000));
+  EXPECT_FALSE(PowerPC::MapPageTableEntryOnFault(0x40003000));
+  EXPECT_EQ(GetMapping(0x40002000), std::nullopt);
+  EXPECT_EQ(GetMapping(0x40003000), std::nullopt);
+}
+
+TEST_F(PageTableMappingTest, MergesAdjacentPages)
+{
+  if (!Memory::CanMapPageTableEntries())
+    return;
+
+  PowerPC::ppcState.SetSR(4, 0x123);
+  for (u32 i = 0; i < 3; ++i)
+    SetPTE(0x40010000 + i * PAGE_SIZE, 0x123, 0x00210000 + i * PAGE_SIZE);
+  SetPTE(0x40010000 + 3 * PAGE_SIZE, 0x123, 0x00400000);
+
+  // Mapping the middle page last joins the views of the pages around it.
+  EXPECT_TRUE(PowerPC::MapPageTableEntryOnFault(0x40010000));
+  EXPECT_TRUE(PowerPC::MapPageTableEntryOnFault(0x40010000 + 2 * PAGE_SIZE));
+  EXPECT_EQ(Memory::GetPageTableViewCount(), 2u);
+  EXPECT_TRUE(PowerPC::MapPageTableEntryOnFault(0x40010000 + PAGE_SIZE));
+  EXPECT_EQ(Memory::GetPageTableViewCount(), 1u);
+
+  // Physically discontiguous pages get views of their own.
+  EXPECT_TRUE(PowerPC::MapPageTableEntryOnFault(0x40010000 + 3 * PAGE_SIZE));
+  EXPECT_EQ(Memory::GetPageTableViewCount(), 2u);
+
+  for (u32 i = 0; i < 3; ++i)
+  {
+    Memory::logical_base[0x40010000 + i * PAGE_SIZE] = static_cast<u8>(i + 1);
+    EXPECT_EQ(Memory::m_pRAM[0x00210000 + i * PAGE_SIZE], i + 1);
+  }
+
+  // Unmapping the middle page splits the view again.
+  PowerPC::InvalidateTLBEntry(0x40010000 + PAGE_SIZE);
+  EXPECT_EQ(Memory::GetPageTableViewCount(), 3u);
+  EXPECT_EQ(GetMapping(0x40010000), 0x00210000u);
+  EXPECT_EQ(GetMapping(0x40010000 + PAGE_SIZE), std::nullopt);
+  EXPECT_EQ(GetMapping(0x40010000 + 2 * PAGE_SIZE), 0x00210000u + 2 * PAGE_SIZE);
+}
+
+TEST_F(PageTableMappingTest, SegmentRegisterChangeRemapsSegment)
+{
+  if (!Memory::CanMapPageTableEntries())
+    return;
+
+  PowerPC::ppcState.SetSR(4, 0x123);
+  PowerPC::ppcState.SetSR(5, 0x123);
+  SetPTE(0x40001000, 0x123, 0x00200000);
+  SetPTE(0x50001000, 0x123, 0x00200000);
+  SetPTE(0x40001000, 0x456, 0x00300000);
+
+  EXPECT_TRUE(PowerPC::MapPageTableEntryOnFault(0x40001000));
+  EXPECT_TRUE(PowerPC::MapPageTableEntryOnFault(0x50001000));
+
+  // Only the segment that changed is unmapped, and its pages map to the new VSID's afterwards.
+  PowerPC::ppcState.SetSR(4, 0x456);
+  EXPECT_EQ(GetMapping(0x40001000), std::nullopt);
+  EXPECT_EQ(GetMapping(0x50001000), 0x00200000u);
+  EXPECT_TRUE(PowerPC::MapPageTableEntryOnFault(0x40001000));
+  EXPECT_EQ(GetMapping(0x40001000), 0x00300000u);
+
+  // Direct-store segments are never mapped.
+  PowerPC::ppcState.SetSR(4, 0x80000000);
+  EXPECT_EQ(GetMapping(0x40001000), std::nullopt);
+  EXPECT_FALSE(PowerPC::MapPageTableEntryOnFault(0x40001000));
+}
+
+TEST_F(PageTableMappingTest, TLBInvalidationUnmapsEverySegment)
+{
+  if (!Memory::CanMapPageTableEntries())
+    return;
+
+  PowerPC::ppcState.SetSR(4, 0x123);
+  PowerPC::ppcState.SetSR(5, 0x124);
+  SetPTE(0x40001000, 0x123, 0x00200000);
+  SetPTE(0x50001000, 0x124, 0x00300000);
+  SetPTE(0x50002000, 0x124, 0x00400000);
+
+  EXPECT_TRUE(PowerPC::MapPageTableEntryOnFault(0x40001000));
+  EXPECT_TRUE(PowerPC::MapPageTableEntryOnFault(0x50001000));
+  EXPECT_TRUE(PowerPC::MapPageTableEntryOnFault(0x50002000));
+
+  // tlbie only specifies the page index.
+  PowerPC::InvalidateTLBEntry(0x00001000);
+  EXPECT_EQ(GetMapping(0x40001000), std::nullopt);
+  EXPECT_EQ(GetMapping(0x50001000), std::nullopt);
+  EXPECT_EQ(GetMapping(0x50002000), 0x00400000u);
+
+  // A changed PTE is picked up on the next fault.
+  SetPTE(0x50001000, 0x124, 0x00500000);
+  EXPECT_TRUE(PowerPC::MapPageTableEntryOnFault(0x50001000));
+  EXPECT_EQ(GetMapping(0x50001000), 0x00500000u);
+}
+
+TEST_F(PageTableMappingTest, PageTableChangeUnmapsEverything)
+{
+  if (!Memory::CanMapPageTableEntries())
+    return;
+
+  PowerPC::ppcState.SetSR(4, 0x123);
+  SetPTE(0x40001000, 0x123, 0x00200000);
+  EXPECT_TRUE(PowerPC::MapPageTableEntryOnFault(0x40001000));
+
+  PowerPC::SDRUpdated();
+  EXPECT_EQ(GetMapping(0x40001000), std::nullopt);
+  EXPECT_EQ(Memory::GetPageTableViewCount(), 0u);
+}
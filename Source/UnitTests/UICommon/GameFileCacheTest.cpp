@@ -0,0 +1,112 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <memory>
+#include <set>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "Common/FileUtil.h"
+#include "UICommon/GameFile.h"
+#include "UICommon/GameFileCache.h"
+
+#include "../UserDirectoryTest.h"
+
+namespace
+{
+class GameFileCacheTest : public UserDirectoryTest
+{
+protected:
+  void SetUp() override
+  {
+    ASSERT_NO_FATAL_FAILURE(UserDirectoryTest::SetUp());
+    m_cache_path = File::GetUserPath(D_CACHE_IDX) + "gamelist.cache";
+    ASSERT_TRUE(File::CreateFullPath(m_cache_path));
+  }
+
+  // DOLs are accepted based on their extension alone, so they make for cheap games.
+  std::string CreateGame(const std::string& name)
+  {
+    const std::string path = m_user_directory + "/" + name + ".dol";
+    EXPECT_TRUE(File::WriteStringToFile(path, name));
+    return path;
+  }
+
+  static void Add(UICommon::GameFileCache* cache, const std::string& path)
+  {
+    bool cache_changed = false;
+    EXPECT_NE(cache->AddOrGet(path, &cache_changed), nullptr);
+    EXPECT_TRUE(cache_changed);
+  }
+
+  static std::set<std::string> GetPaths(const UICommon::GameFileCache& cache)
+  {
+    std::set<std::string> paths;
+    cache.ForEach([&paths](const std::shared_ptr<const UICommon::GameFile>& game) {
+      paths.insert(game->GetFilePath());
+    });
+    return paths;
+  }
+
+  std::string m_cache_path;
+};
+}  // namespace
+
+TEST_F(GameFileCacheTest, AppendsRecords)
+{
+  const std::string first = CreateGame("first");
+  const std::string second = CreateGame("second");
+
+  {
+    UICommon::GameFileCache cache;
+    EXPECT_FALSE(cache.Load());
+    Add(&cache, first);
+    ASSERT_TRUE(cache.Save());
+  }
+  {
+    UICommon::GameFileCache cache;
+    ASSERT_TRUE(cache.Load());
+    EXPECT_EQ(GetPaths(cache), std::set<std::string>({first}));
+    Add(&cache, second);
+    ASSERT_TRUE(cache.Save());
+  }
+
+  UICommon::GameFileCache cache;
+  ASSERT_TRUE(cache.Load());
+  EXPECT_EQ(GetPaths(cache), std::set<std::string>({first, second}));
+}
+
+TEST_F(GameFileCacheTest, RecoversFromCutOffRecord)
+{
+  const std::string first = CreateGame("first");
+  const std::string second = CreateGame("second");
+  const std::string third = CreateGame("third");
+
+  {
+    UICommon::GameFileCache cache;
+    cache.Load();
+    Add(&cache, first);
+    ASSERT_TRUE(cache.Save());
+    Add(&cache, second);
+    ASSERT_TRUE(cache.Save());
+  }
+
+  // Cut off the record of the second game, like a crash while appending it would.
+  std::string contents;
+  ASSERT_TRUE(File::ReadFileToString(m_cache_path, contents));
+  ASSERT_TRUE(File::WriteStringToFile(m_cache_path, contents.substr(0, contents.size() - 4)));
+
+  {
+    UICommon::GameFileCache cache;
+    ASSERT_TRUE(cache.Load());
+    EXPECT_EQ(GetPaths(cache), std::set<std::string>({first}));
+    Add(&cache, third);
+    ASSERT_TRUE(cache.Save());
+  }
+
+  // The game added after the broken record must not get lost.
+  UICommon::GameFileCache cache;
+  ASSERT_TRUE(cache.Load());
+  EXPECT_EQ(GetPaths(cache), std::set<std::string>({first, third}));
+}
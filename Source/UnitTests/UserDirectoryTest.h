@@ -0,0 +1,38 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Core/ConfigManager.h"
+#include "UICommon/UICommon.h"
+
+// Base fixture for tests that need the configuration to be loaded. It points the user directory at
+// a new temporary directory, so that the tests neither see nor modify the real user's settings.
+// Fixtures deriving from this should call ASSERT_NO_FATAL_FAILURE(UserDirectoryTest::SetUp()).
+class UserDirectoryTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_user_directory = File::CreateTempDir();
+    ASSERT_FALSE(m_user_directory.empty());
+    UICommon::SetUserDirectory(m_user_directory);
+    Config::Init();
+    SConfig::Init();
+  }
+
+  void TearDown() override
+  {
+    SConfig::Shutdown();
+    Config::Shutdown();
+    File::DeleteDirRecursively(m_user_directory);
+  }
+
+  std::string m_user_directory;
+};
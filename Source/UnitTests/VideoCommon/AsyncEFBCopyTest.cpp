@@ -0,0 +1,177 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/MathUtil.h"
+#include "Core/Config/GraphicsSettings.h"
+#include "Core/ConfigManager.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/Memmap.h"
+#include "VideoBackends/Null/VideoBackend.h"
+#include "VideoCommon/AsyncRequests.h"
+#include "VideoCommon/BPMemory.h"
+#include "VideoCommon/TextureCacheBase.h"
+#include "VideoCommon/VideoBackendBase.h"
+#include "VideoCommon/VideoConfig.h"
+
+#include "../UserDirectoryTest.h"
+
+// Drives the texture cache of the null backend through deferred EFB copies, and checks when each
+// of them gets written to RAM. The null backend's staging textures are all zeroes, so a copy has
+// been written once its memory is cleared.
+
+namespace
+{
+// A 64x64 RGBA8 copy is 16 rows of 16 blocks of 64 bytes.
+constexpr u32 COPY_SIZE = 64;
+constexpr u32 COPY_STRIDE = 16 * 64;
+constexpr u32 COPY_RANGE = 16 * COPY_STRIDE;
+
+constexpr u32 FIRST_COPY = 0x00100000;
+constexpr u32 SECOND_COPY = 0x00200000;
+constexpr u32 THIRD_COPY = 0x00300000;
+
+class AsyncEFBCopyTest : public UserDirectoryTest
+{
+protected:
+  void SetUp() override
+  {
+    ASSERT_NO_FATAL_FAILURE(UserDirectoryTest::SetUp());
+    SConfig::GetInstance().bWii = false;
+    SConfig::GetInstance().bMMU = false;
+    SConfig::GetInstance().bCPUThread = true;
+    CoreTiming::Init();
+    Memory::Init();
+    ASSERT_TRUE(Memory::InitFastmemArena());
+
+    Config::SetCurrent(Config::GFX_HACK_SKIP_EFB_COPY_TO_RAM, false);
+    Config::SetCurrent(Config::GFX_HACK_DISABLE_COPY_TO_VRAM, false);
+    Config::SetCurrent(Config::GFX_HACK_DEFER_EFB_COPIES, true);
+    Config::SetCurrent(Config::GFX_HACK_ASYNC_EFB_COPIES, true);
+    m_backend.InitBackendInfo();
+    g_Config.Refresh();
+    ASSERT_TRUE(m_backend.Initialize({}));
+    m_initialized = true;
+  }
+
+  void TearDown() override
+  {
+    if (m_initialized)
+      m_backend.Shutdown();
+    Memory::Shutdown();
+    CoreTiming::Shutdown();
+    UserDirectoryTest::TearDown();
+  }
+
+  static void Copy(u32 address)
+  {
+    std::memset(Memory::GetPointer(address), 0xff, COPY_RANGE);
+    const MathUtil::Rectangle<int> rect(0, 0, COPY_SIZE, COPY_SIZE);
+    g_texture_cache->CopyRenderTargetToTexture(address, EFBCopyFormat::RGBA8, COPY_SIZE, COPY_SIZE,
+                                               COPY_STRIDE, false, rect, false, false, 1.0f, 1.0f,
+                                               false, false, CopyFilterCoefficients::Values{});
+  }
+
+  static bool IsWritten(u32 address)
+  {
+    const u8* data = Memory::GetPointer(address);
+    return std::all_of(data, data + COPY_RANGE, [](u8 value) { return value == 0; });
+  }
+
+  Null::VideoBackend m_backend;
+  bool m_initialized = false;
+};
+}  // namespace
+
+TEST_F(AsyncEFBCopyTest, FlushesCopiesInOrder)
+{
+  Copy(FIRST_COPY);
+  Copy(SECOND_COPY);
+  Copy(THIRD_COPY);
+  EXPECT_FALSE(IsWritten(FIRST_COPY));
+
+  // None of the copies are complete, so they are only registered as pending.
+  g_texture_cache->PublishEFBCopies();
+  EXPECT_FALSE(IsWritten(FIRST_COPY));
+  EXPECT_FALSE(IsWritten(SECOND_COPY));
+  EXPECT_FALSE(IsWritten(THIRD_COPY));
+
+  // Accessing a copy writes the ones issued before it as well, but not the ones after it.
+  g_texture_cache->FlushEFBCopiesInRange(SECOND_COPY + COPY_STRIDE, 4);
+  EXPECT_TRUE(IsWritten(FIRST_COPY));
+  EXPECT_TRUE(IsWritten(SECOND_COPY));
+  EXPECT_FALSE(IsWritten(THIRD_COPY));
+
+  // Memory no copy overlaps doesn't wait for anything.
+  g_texture_cache->FlushEFBCopiesInRange(SECOND_COPY + COPY_RANGE, 0x1000);
+  EXPECT_FALSE(IsWritten(THIRD_COPY));
+
+  g_texture_cache->FlushEFBCopiesInRange(THIRD_COPY, COPY_RANGE);
+  EXPECT_TRUE(IsWritten(THIRD_COPY));
+}
+
+TEST_F(AsyncEFBCopyTest, OnlyFlushesPublishedCopiesInRange)
+{
+  Copy(FIRST_COPY);
+
+  // The CPU can't have seen copies that were never published.
+  g_texture_cache->FlushEFBCopiesInRange(FIRST_COPY, COPY_RANGE);
+  EXPECT_FALSE(IsWritten(FIRST_COPY));
+
+  g_texture_cache->PublishEFBCopies();
+  g_texture_cache->FlushEFBCopiesInRange(FIRST_COPY, COPY_RANGE);
+  EXPECT_TRUE(IsWritten(FIRST_COPY));
+}
+
+TEST_F(AsyncEFBCopyTest, RetiresCopiesAfterAFrame)
+{
+  Copy(FIRST_COPY);
+  g_texture_cache->RetireEFBCopies();
+  EXPECT_FALSE(IsWritten(FIRST_COPY));
+
+  // Copies pending since before the previous frame ended are written at the end of this one.
+  Copy(SECOND_COPY);
+  g_texture_cache->RetireEFBCopies();
+  EXPECT_TRUE(IsWritten(FIRST_COPY));
+  EXPECT_FALSE(IsWritten(SECOND_COPY));
+
+  g_texture_cache->RetireEFBCopies();
+  EXPECT_TRUE(IsWritten(SECOND_COPY));
+}
+
+TEST_F(AsyncEFBCopyTest, FlushesEverythingInSingleCore)
+{
+  SConfig::GetInstance().bCPUThread = false;
+  EXPECT_FALSE(Memory::CanDeferGPUWrites());
+
+  Copy(FIRST_COPY);
+  Copy(SECOND_COPY);
+  g_texture_cache->PublishEFBCopies();
+  EXPECT_TRUE(IsWritten(FIRST_COPY));
+  EXPECT_TRUE(IsWritten(SECOND_COPY));
+}
+
+TEST_F(AsyncEFBCopyTest, FaultOnlyRetriesOnceThePageIsUnprotected)
+{
+  Copy(FIRST_COPY);
+  g_texture_cache->PublishEFBCopies();
+  const auto fault_address = reinterpret_cast<uintptr_t>(Memory::physical_base + FIRST_COPY);
+
+  // The GPU loop has exited and takes no more requests, so waiting leaves the page protected.
+  g_video_backend = &m_backend;
+  AsyncRequests::GetInstance()->SetPassthrough(false);
+  AsyncRequests::GetInstance()->SetEnable(false);
+  EXPECT_FALSE(Memory::HandleFault(fault_address));
+  AsyncRequests::GetInstance()->SetPassthrough(true);
+  g_video_backend = nullptr;
+
+  // What the GPU thread does when its loop exits.
+  g_texture_cache->FlushEFBCopies();
+  EXPECT_FALSE(Memory::HandleFault(fault_address));
+  EXPECT_EQ(0, Memory::physical_base[FIRST_COPY]);
+}
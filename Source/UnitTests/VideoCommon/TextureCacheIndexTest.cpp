@@ -0,0 +1,180 @@
+// Copyright 2022 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/TextureCacheIndex.h"
+
+// Replays generated texture cache traffic against the indices, and compares them with searching
+// every entry. The traffic mimics what games do: lots of small textures packed next to each other,
+// a few large ones like XFB copies, and textures being replaced all the time.
+
+namespace
+{
+struct Entry
+{
+  u32 addr;
+  u32 size_in_bytes;
+  u64 hash;
+};
+
+class TextureTrace
+{
+public:
+  explicit TextureTrace(u32 seed) : m_rng(seed) {}
+
+  u32 Next(u32 range) { return static_cast<u32>(m_rng() % range); }
+
+  std::unique_ptr<Entry> NewEntry()
+  {
+    constexpr u32 sizes[] = {0, 0x20, 0x200, 0x800, 0x2000, 0x8000, 0x20000, 0x96000, 0x400000};
+    auto entry = std::make_unique<Entry>();
+    entry->size_in_bytes = sizes[Next(std::size(sizes))];
+    entry->addr = Address();
+    // Few distinct hashes, some of which only differ in their upper bits.
+    entry->hash = (u64(Next(4)) << 40) | Next(64);
+    return entry;
+  }
+
+  // Mostly MEM1, and some MEM2, which shares buckets with MEM1.
+  u32 Address()
+  {
+    const u32 base = Next(4) == 0 ? 0x10000000 : 0;
+    return base + Next(0x1800000) / 32 * 32;
+  }
+
+private:
+  std::mt19937 m_rng;
+};
+
+u64 FirstPage(u32 address)
+{
+  return address >> TextureAddressIndex<Entry>::PAGE_SHIFT;
+}
+
+u64 LastPage(u32 address, u32 size)
+{
+  return (u64(address) + std::max<u32>(size, 1) - 1) >> TextureAddressIndex<Entry>::PAGE_SHIFT;
+}
+}  // namespace
+
+TEST(TextureCacheIndex, AddressIndexMatchesLinearSearch)
+{
+  TextureTrace trace(1);
+  TextureAddressIndex<Entry> index;
+  std::vector<std::unique_ptr<Entry>> entries;
+  std::vector<Entry*> found;
+
+  for (int i = 0; i < 20000; i++)
+  {
+    const u32 op = trace.Next(10);
+    if (op < 3 || entries.empty())
+    {
+      entries.push_back(trace.NewEntry());
+      index.Add(entries.back().get());
+    }
+    else if (op < 5)
+    {
+      const size_t victim = trace.Next(static_cast<u32>(entries.size()));
+      index.Remove(entries[victim].get());
+      entries.erase(entries.begin() + victim);
+    }
+    else
+    {
+      const u32 address = trace.Address();
+      const u32 size = trace.Next(0x40000);
+
+      found.clear();
+      index.FindOverlapping(address, size, &found);
+      std::sort(found.begin(), found.end());
+
+      std::vector<Entry*> expected;
+      for (const auto& entry : entries)
+      {
+        if (FirstPage(entry->addr) <= LastPage(address, size) &&
+            LastPage(entry->addr, entry->size_in_bytes) >= FirstPage(address))
+        {
+          expected.push_back(entry.get());
+        }
+      }
+      std::sort(expected.begin(), expected.end());
+
+      ASSERT_EQ(found, expected) << "operation " << i;
+    }
+  }
+
+  index.Clear();
+  found.clear();
+  index.FindOverlapping(0, 0x2000000, &found);
+  EXPECT_TRUE(found.empty());
+}
+
+TEST(TextureCacheIndex, HashIndexMatchesMultimap)
+{
+  TextureTrace trace(2);
+  TextureHashIndex<Entry> index;
+  std::multimap<u64, Entry*> reference;
+  std::vector<std::unique_ptr<Entry>> entries;
+
+  for (int i = 0; i < 50000; i++)
+  {
+    const u32 op = trace.Next(10);
+    if (op < 4 || entries.empty())
+    {
+      entries.push_back(trace.NewEntry());
+      index.Add(entries.back()->hash, entries.back().get());
+      reference.emplace(entries.back()->hash, entries.back().get());
+    }
+    else if (op < 7)
+    {
+      const size_t victim = trace.Next(static_cast<u32>(entries.size()));
+      Entry* entry = entries[victim].get();
+      index.Remove(entry->hash, entry);
+      const auto range = reference.equal_range(entry->hash);
+      reference.erase(std::find_if(range.first, range.second,
+                                   [&](const auto& pair) { return pair.second == entry; }));
+      entries.erase(entries.begin() + victim);
+    }
+    else
+    {
+      // Like texture lookups, take the first entry with the hash that also matches other criteria.
+      const u64 hash = trace.NewEntry()->hash;
+      const u32 min_size = trace.Next(0x1000);
+      const auto predicate = [&](const Entry* entry) { return entry->size_in_bytes >= min_size; };
+
+      Entry* expected = nullptr;
+      const auto range = reference.equal_range(hash);
+      const auto it = std::find_if(range.first, range.second,
+                                   [&](const auto& pair) { return predicate(pair.second); });
+      if (it != range.second)
+        expected = it->second;
+
+      ASSERT_EQ(index.Find(hash, predicate), expected) << "operation " << i;
+    }
+    ASSERT_EQ(index.Size(), reference.size());
+  }
+
+  std::multimap<u64, Entry*> contents;
+  index.ForEach([&](u64 key, Entry* entry) { contents.emplace(key, entry); });
+  EXPECT_EQ(contents.size(), reference.size());
+  for (const auto& [key, entry] : reference)
+  {
+    const auto range = contents.equal_range(key);
+    EXPECT_NE(std::find_if(range.first, range.second,
+                           [&](const auto& pair) { return pair.second == entry; }),
+              range.second);
+  }
+
+  index.Clear();
+  EXPECT_EQ(index.Size(), 0u);
+  const auto any = [](const Entry*) { return true; };
+  EXPECT_EQ(index.Find(entries.front()->hash, any), nullptr);
+}